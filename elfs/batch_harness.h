@@ -0,0 +1,102 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+// Batch execution harness of the //elfs templates (see Program::ExecuteBatch).
+//
+// A template defines its dummy, results and inputs arrays (and optional
+// scratchspace) and then includes this file with BATCH_STATE(X) listing the
+// arrays to restore before each call of main, e.g.:
+//
+//   #define BATCH_STATE(X) X(dummy) X(results) X(scratchspace)
+//   #include "batch_harness.h"
+//
+// ABI between the harness and Program (the symbols are looked up by name):
+//
+//   batch_size    - number of slots to execute, 0 (as in the ELF) for a regular
+//                   single execution of main;
+//   batch_slot    - slot executed next (the first slot to execute is set by
+//                   Program), the slot running when the process stops;
+//   batch_inputs  - inputs of each slot (the size of inputs per slot);
+//   batch_results - results of each completed slot (the size of results per
+//                   slot).
+//
+// The batch variables are in .bss (neither in the ELF file nor in the data
+// read via Program::ReadElfData) and written by Program into the ELF process
+// at the last ptrace stop before main.
+//
+// With batch_size > 0, the harness (run as a constructor, i.e. before libc
+// calls main) restores the BATCH_STATE arrays to their initial values, copies
+// the inputs of the slot to inputs, calls main, copies results to the results
+// of the slot and continues with the next slot. Any syscall or signal of the
+// evolved code stops the process as in a single execution and batch_slot
+// tells Program which slot stopped it (the remaining slots are resumed in a
+// new process). The time limit (SIGALRM) covers the whole process, Program
+// executes a slot that runs out of time after other slots again on its own.
+// After the last slot, the process exits (without returning to libc).
+//
+// The harness only keeps its state in (volatile) globals as the evolved code
+// may clobber any register or the stack frame of the harness.
+
+#ifndef VIAEVO_ELFS_BATCH_HARNESS_H_
+#define VIAEVO_ELFS_BATCH_HARNESS_H_
+
+#include <unistd.h>
+
+#define BATCH_MAX_SLOTS 256
+#define BATCH_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
+
+volatile int batch_size;
+volatile int batch_slot;
+int batch_inputs[BATCH_MAX_SLOTS * BATCH_LENGTH(inputs)];
+int batch_results[BATCH_MAX_SLOTS * BATCH_LENGTH(results)];
+
+// Initial values of the BATCH_STATE arrays.
+#define BATCH_DEFINE_INITIAL(array)                                            \
+  static int batch_initial_##array[BATCH_LENGTH(array)];
+BATCH_STATE(BATCH_DEFINE_INITIAL)
+#undef BATCH_DEFINE_INITIAL
+
+static volatile int batch_argc;
+static char **volatile batch_argv;
+static char **volatile batch_envp;
+
+int main();
+
+static void batch_copy(int *to, const int *from, int size) {
+  for (int i = 0; i < size; ++i)
+    to[i] = from[i];
+}
+
+// glibc passes argc, argv and envp to constructors (and main is called with
+// the same arguments as by libc).
+__attribute__((constructor)) static void batch_harness(int argc, char **argv,
+                                                       char **envp) {
+  if (batch_size <= 0)
+    return;
+  batch_argc = argc;
+  batch_argv = argv;
+  batch_envp = envp;
+
+#define BATCH_SAVE_INITIAL(array)                                              \
+  batch_copy(batch_initial_##array, array, BATCH_LENGTH(array));
+  BATCH_STATE(BATCH_SAVE_INITIAL)
+#undef BATCH_SAVE_INITIAL
+
+  while (batch_slot < batch_size) {
+#define BATCH_RESTORE_INITIAL(array)                                           \
+  batch_copy(array, batch_initial_##array, BATCH_LENGTH(array));
+    BATCH_STATE(BATCH_RESTORE_INITIAL)
+#undef BATCH_RESTORE_INITIAL
+    batch_copy(inputs, &batch_inputs[batch_slot * BATCH_LENGTH(inputs)],
+               BATCH_LENGTH(inputs));
+    ((int (*)(int, char **, char **))main)(batch_argc, batch_argv, batch_envp);
+    batch_copy(&batch_results[batch_slot * BATCH_LENGTH(results)], results,
+               BATCH_LENGTH(results));
+    ++batch_slot;
+  }
+  _exit(0);
+}
+
+#endif // VIAEVO_ELFS_BATCH_HARNESS_H_
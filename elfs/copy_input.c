@@ -0,0 +1,36 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+// The ELF of this program is only intended for unit testing of the batch
+// execution of the Program class (see batch_harness.h). main copies inputs[0]
+// to results[1] and dummy[0] and results[2] (which should be restored between
+// the slots of a batch) to results[2] and results[3]. main executes an illegal
+// instruction (SIGILL) for a negative inputs[0], after overwriting batch_slot
+// (as the evolved code may) for -2 and after looping forever (until SIGALRM)
+// for -3.
+
+// The arrays are initialized with non-zero values to be placed in .data.
+int dummy[] = {10, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+int results[] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+int inputs[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+
+#define BATCH_STATE(X) X(dummy) X(results)
+#include "batch_harness.h"
+
+int main() {
+  results[0] = 20;
+  if (inputs[0] == -2)
+    batch_slot = -1000;
+  if (inputs[0] == -3)
+    for (;;)
+      ;
+  if (inputs[0] < 0)
+    __builtin_trap();
+  results[1] = inputs[0];
+  results[2] = dummy[0];
+  results[3] += 1;
+  dummy[0] += 100;
+  return 0;
+}
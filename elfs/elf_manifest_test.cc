@@ -0,0 +1,59 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+// TODO: Remove relative path.
+#include "../program/program.h"
+
+namespace {
+
+// The generated manifest should match parsing and executing the ELFs at
+// runtime (i.e. it is not stale and the build and runtime environments agree
+// on the ptrace stops before main).
+TEST(ElfManifestTest, MatchesRuntime) {
+  for (std::string filename :
+       {"elfs/simple_small", "elfs/simple_medium", "elfs/intermediate_small",
+        "elfs/intermediate_medium", "elfs/inf_loop", "elfs/copy_input"}) {
+    viaevo::Program::ManifestEntry entry;
+    ASSERT_TRUE(viaevo::Program::FindManifestEntry(filename, &entry))
+        << filename;
+    viaevo::Program::ManifestEntry runtime_entry =
+        viaevo::Program::CreateManifestEntry(filename);
+
+    EXPECT_EQ(std::string(entry.filename), filename);
+    EXPECT_EQ(entry.main_offset_in_elf, runtime_entry.main_offset_in_elf);
+    EXPECT_EQ(entry.main_offset_in_text, runtime_entry.main_offset_in_text);
+    EXPECT_EQ(entry.main_size, runtime_entry.main_size);
+    EXPECT_EQ(entry.inputs_offset_in_elf, runtime_entry.inputs_offset_in_elf);
+    EXPECT_EQ(entry.inputs_size, runtime_entry.inputs_size);
+    EXPECT_EQ(entry.results_offset_in_data,
+              runtime_entry.results_offset_in_data);
+    EXPECT_EQ(entry.results_size, runtime_entry.results_size);
+    EXPECT_EQ(entry.data_offset_in_elf, runtime_entry.data_offset_in_elf);
+    EXPECT_EQ(entry.data_size, runtime_entry.data_size);
+    EXPECT_EQ(entry.expected_ptrace_stops,
+              runtime_entry.expected_ptrace_stops);
+    EXPECT_EQ(entry.batch_size_offset_in_data,
+              runtime_entry.batch_size_offset_in_data);
+    EXPECT_EQ(entry.batch_slot_offset_in_data,
+              runtime_entry.batch_slot_offset_in_data);
+    EXPECT_EQ(entry.batch_inputs_offset_in_data,
+              runtime_entry.batch_inputs_offset_in_data);
+    EXPECT_EQ(entry.batch_inputs_size, runtime_entry.batch_inputs_size);
+    EXPECT_EQ(entry.batch_results_offset_in_data,
+              runtime_entry.batch_results_offset_in_data);
+    EXPECT_EQ(entry.batch_results_size, runtime_entry.batch_results_size);
+
+    std::shared_ptr<viaevo::Program> program =
+        viaevo::Program::Create(filename);
+    EXPECT_TRUE(program->IsInitialized());
+    EXPECT_EQ(program->elf_code_size(), entry.main_size);
+  }
+}
+
+} // namespace
@@ -54,6 +54,10 @@ int scratchspace[] = {-1,
   };
 // clang-format on
 
+// Batch execution of main on multiple inputs (see batch_harness.h).
+#define BATCH_STATE(X) X(dummy) X(results) X(scratchspace)
+#include "batch_harness.h"
+
 // TODO: The code below is super ad hoc. Review, expand, consolidate,
 // systematize, polish, etc.
 int main() {
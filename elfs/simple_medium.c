@@ -55,6 +55,10 @@ int scratchspace[] = {-1,
   };
 // clang-format on
 
+// Batch execution of main on multiple inputs (see batch_harness.h).
+#define BATCH_STATE(X) X(dummy) X(results) X(scratchspace)
+#include "batch_harness.h"
+
 int main() {
   // Change result[0] as a control to confirm (before code evolution) that this
   // code runs.
@@ -6,14 +6,22 @@
 #include "evolver_adhoc.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace viaevo {
 
 namespace {
+typedef std::chrono::steady_clock Clock;
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
 class ProgramCompare {
 public:
   bool operator()(const std::shared_ptr<Program> &lhs,
@@ -31,12 +39,15 @@ EvolverAdHoc::EvolverAdHoc(std::string elf_filename, int mu, int phi,
                            bool initialize_programs_to_all_nops)
     : mu_(mu), phi_(phi), lambda_(lambda), scorer_(scorer), mutator_(mutator),
       gen_(gen), evaluations_per_program_(evaluations_per_program),
+      current_evaluations_per_program_(evaluations_per_program),
       max_generations_(max_generations),
       score_results_history_(score_results_history),
       output_filename_prefix_(output_filename_prefix) {
   for (int i = 0; i < mu_ + lambda_; ++i) {
     auto program = Program::Create(elf_filename);
     program->set_track_results_history(score_results_history);
+    if (score_results_history)
+      program->ReserveResultsHistory(evaluations_per_program_);
     if (initialize_programs_to_all_nops) {
       program->SetElfCodeToAllNops();
     }
@@ -57,53 +68,481 @@ void EvolverAdHoc::SelectParents() {
   std::shuffle(programs_.begin() + (mu_ - phi_), programs_.end(), gen_.gen());
 }
 
-// TODO: Put the three stages in individual member functions and add unit
-// tests for those.
+void EvolverAdHoc::CreateOffspring() {
+  generation_remutations_ = 0;
+  generation_prescreen_checks_ = 0;
+  generation_prescreen_rejections_ = 0;
+  bool remutate = deduplicate_ && max_remutations_ > 0;
+  GenomeIndex genome_index;
+  if (remutate) {
+    for (int i = 0; i < mu_; ++i)
+      genome_index.FindOrAdd(programs_[i]->GetElfCode(), i);
+  }
+
+  if (batch_mutation_)
+    MutateBatch();
+
+  mutation_outcomes_.assign(lambda_, MutationOutcome());
+  for (int i = 0; i < lambda_; ++i) {
+    mutation_outcomes_[i].target = programs_[mu_ + i];
+    int remutations = 0;
+    int rejections = 0;
+    bool batched = batch_mutation_;
+    while (true) {
+      std::shared_ptr<Program> parent1;
+      if (batched) {
+        // The first attempt was created by MutateBatch.
+        batched = false;
+        parent1 = programs_[mutation_slots_[i].parent1];
+        offspring_arena_.Store(i, *programs_[mu_ + i]);
+      } else {
+        // Note: The same program may be selected as both parent1 and parent2
+        // and this is ok for e.g. random recombinations.
+        parent1 = programs_[gen_() % mu_];
+        std::shared_ptr<Program> parent2 = programs_[gen_() % mu_];
+        mutator_.Mutate(programs_[mu_ + i], parent1, parent2);
+      }
+      mutation_outcomes_[i].parent1 = parent1;
+      if (prescreen_) {
+        ++generation_prescreen_checks_;
+        CodePrescreen::Verdict verdict = CodePrescreen::Check(
+            programs_[mu_ + i]->GetElfCode(), parent1->GetElfCode());
+        ++prescreen_verdict_counts_[verdict];
+        if (verdict != CodePrescreen::kAccept) {
+          ++generation_prescreen_rejections_;
+          if (rejections < max_prescreen_rejections_) {
+            ++rejections;
+            continue;
+          }
+        }
+      }
+      if (!remutate || genome_index.FindOrAdd(programs_[mu_ + i]->GetElfCode(),
+                                              mu_ + i) == -1)
+        break;
+      if (remutations == max_remutations_)
+        break;
+      ++remutations;
+      ++generation_remutations_;
+    }
+    OnOffspringCreated(mu_ + i);
+  }
+}
+
+void EvolverAdHoc::MutateBatch() {
+  size_t genome_size = programs_[0]->elf_code_size();
+  parents_arena_.Reset(mu_, genome_size);
+  for (int i = 0; i < mu_; ++i)
+    parents_arena_.Load(i, *programs_[i]);
+  offspring_arena_.Reset(lambda_, genome_size);
+
+  // Note: The same program may be selected as both parent1 and parent2 and
+  // this is ok for e.g. random recombinations.
+  std::vector<mt_type::result_type> random_numbers(2 * lambda_);
+  gen_.Fill(random_numbers.data(), random_numbers.size());
+  mutation_slots_.resize(lambda_);
+  for (int i = 0; i < lambda_; ++i) {
+    mutation_slots_[i].target = i;
+    mutation_slots_[i].parent1 = random_numbers[2 * i] % mu_;
+    mutation_slots_[i].parent2 = random_numbers[2 * i + 1] % mu_;
+    mutation_slots_[i].target_program = programs_[mu_ + i].get();
+  }
+  mutator_.MutateBatch(parents_arena_, mutation_slots_, offspring_arena_,
+                       mutation_streams_, current_generation_,
+                       mutation_pool_.get());
+}
+
+void EvolverAdHoc::set_batch_mutation(bool batch_mutation,
+                                      uint64_t stream_seed, int num_threads) {
+  batch_mutation_ = batch_mutation;
+  mutation_streams_ = RandomStream(stream_seed);
+  if (batch_mutation && num_threads > 1)
+    mutation_pool_ = std::make_shared<WorkerPool>(num_threads);
+  else
+    mutation_pool_.reset();
+}
+
+void EvolverAdHoc::set_determinism(bool deterministic_execution,
+                                   int check_programs, int check_executions) {
+  deterministic_execution_ = deterministic_execution;
+  determinism_check_programs_ = check_programs;
+  determinism_check_executions_ = check_executions;
+  for (auto &program : programs_)
+    program->set_deterministic_execution(deterministic_execution);
+}
+
+void EvolverAdHoc::set_pipelined(int num_threads) {
+  if (num_threads > 0)
+    worker_pool_ = std::make_shared<WorkerPool>(num_threads);
+  else
+    worker_pool_.reset();
+}
+
+void EvolverAdHoc::BeginEvaluation() {
+  evaluation_genome_index_.Clear();
+  duplicate_of_.assign(mu_ + lambda_, -1);
+  executions_.resize(mu_ + lambda_);
+  if (evaluation_order_ != kInputsMajor)
+    evaluation_results_.resize(mu_ + lambda_);
+  generation_duplicates_ = 0;
+}
+
+void EvolverAdHoc::RegisterForEvaluation(int index) {
+  programs_[index]->ResetCurrentScore();
+  programs_[index]->ClearResultsHistory();
+  duplicate_of_[index] = index;
+  if (deduplicate_ && !programs_[index]->nondeterministic()) {
+    int other =
+        evaluation_genome_index_.FindOrAdd(programs_[index]->GetElfCode(), index);
+    if (other != -1) {
+      duplicate_of_[index] = other;
+      ++generation_duplicates_;
+    }
+  }
+  if (coverage_ && duplicate_of_[index] == index &&
+      !programs_[index]->has_coverage() && !(worker_pool_ && index < mu_))
+    programs_[index]->set_coverage_executions(1);
+}
+
+void EvolverAdHoc::SubmitExecution(int index) {
+  if (evaluation_order_ != kInputsMajor) {
+    executions_[index] =
+        worker_pool_->Submit([this, index] { ExecuteAllEvaluations(index); });
+    return;
+  }
+  programs_[index]->SetElfInputs(input_batch_->inputs(current_evaluation_),
+                                 input_batch_->inputs_size());
+  std::shared_ptr<Program> program = programs_[index];
+  executions_[index] = worker_pool_->Submit([this, program] {
+    Clock::time_point start = Clock::now();
+    program->Execute();
+    std::chrono::nanoseconds duration = Clock::now() - start;
+    execution_nanoseconds_ += duration.count();
+  });
+}
+
+void EvolverAdHoc::ExecuteAndScoreRound(bool submitted) {
+  input_set_ = input_batch_->input_set(current_evaluation_);
+  if (!worker_pool_) {
+    for (int i = 0; i < mu_ + lambda_; ++i) {
+      if (duplicate_of_[i] != i)
+        continue;
+      programs_[i]->SetElfInputs(input_batch_->inputs(current_evaluation_),
+                                 input_batch_->inputs_size());
+      Clock::time_point start = Clock::now();
+      programs_[i]->Execute();
+      execution_nanoseconds_ +=
+          std::chrono::nanoseconds(Clock::now() - start).count();
+      start = Clock::now();
+      AppendToScoreBatch(i, programs_[i]->last_results());
+      timings_.scoring_seconds += SecondsSince(start);
+    }
+    ScorePendingBatch();
+    return;
+  }
+
+  if (!submitted) {
+    for (int i = 0; i < mu_ + lambda_; ++i) {
+      if (duplicate_of_[i] == i)
+        SubmitExecution(i);
+    }
+  }
+  // Score in the order of programs_ (as without pipelining) while the
+  // remaining programs are executing.
+  for (int i = 0; i < mu_ + lambda_; ++i) {
+    if (duplicate_of_[i] != i)
+      continue;
+    executions_[i].get();
+    Clock::time_point start = Clock::now();
+    AppendToScoreBatch(i, programs_[i]->last_results());
+    timings_.scoring_seconds += SecondsSince(start);
+  }
+  ScorePendingBatch();
+}
+
+void EvolverAdHoc::ExecuteAllEvaluations(int index) {
+  Program &program = *programs_[index];
+  std::vector<std::vector<int>> &results = evaluation_results_[index];
+  if (evaluation_order_ == kProgramsMajorBatched) {
+    Clock::time_point start = Clock::now();
+    program.ExecuteBatch(input_batch_->inputs(0), input_batch_->inputs_size(),
+                         input_batch_->size(), &results);
+    std::chrono::nanoseconds duration = Clock::now() - start;
+    execution_nanoseconds_ += duration.count();
+    return;
+  }
+  results.resize(input_batch_->size());
+  for (size_t j = 0; j < input_batch_->size(); ++j) {
+    program.SetElfInputs(input_batch_->inputs(j), input_batch_->inputs_size());
+    Clock::time_point start = Clock::now();
+    program.Execute();
+    std::chrono::nanoseconds duration = Clock::now() - start;
+    execution_nanoseconds_ += duration.count();
+    results[j] = program.last_results();
+  }
+}
+
+void EvolverAdHoc::ExecuteAndScoreProgramsMajor(bool submitted) {
+  for (int i = 0; i < mu_ + lambda_; ++i) {
+    if (duplicate_of_[i] != i)
+      continue;
+    if (!worker_pool_)
+      ExecuteAllEvaluations(i);
+    else if (!submitted)
+      SubmitExecution(i);
+  }
+  if (worker_pool_) {
+    for (int i = 0; i < mu_ + lambda_; ++i) {
+      if (duplicate_of_[i] == i)
+        executions_[i].get();
+    }
+  }
+  // Score in the same order as with kInputsMajor.
+  for (size_t j = 0; j < input_batch_->size(); ++j) {
+    input_set_ = input_batch_->input_set(j);
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < mu_ + lambda_; ++i) {
+      if (duplicate_of_[i] == i)
+        AppendToScoreBatch(i, evaluation_results_[i][j]);
+    }
+    timings_.scoring_seconds += SecondsSince(start);
+    ScorePendingBatch();
+  }
+}
+
+void EvolverAdHoc::AppendToScoreBatch(int index,
+                                      const std::vector<int> &results) {
+  // Programs without results (e.g. killed before the results were read) score
+  // 0 (the scorers may assume the results of the ELF).
+  if (results.empty())
+    return;
+  if (batch_indices_.empty())
+    batch_results_size_ = results.size();
+  // The rows of the matrix have the same size (all programs are created from
+  // the same ELF), other programs are scored individually.
+  if (results.size() != batch_results_size_) {
+    programs_[index]->IncrementCurrentScoreBy(
+        scorer_.ScoreResults(results.data(), results.size(), *input_set_));
+    return;
+  }
+  batch_indices_.push_back(index);
+  batch_results_.insert(batch_results_.end(), results.begin(), results.end());
+}
+
+void EvolverAdHoc::ScorePendingBatch() {
+  Clock::time_point start = Clock::now();
+  batch_scores_.resize(batch_indices_.size());
+  if (!batch_indices_.empty())
+    scorer_.ScoreBatch(batch_results_.data(), batch_indices_.size(),
+                       batch_results_size_, *input_set_, batch_scores_.data());
+  for (size_t k = 0; k < batch_indices_.size(); ++k)
+    programs_[batch_indices_[k]]->IncrementCurrentScoreBy(batch_scores_[k]);
+  batch_indices_.clear();
+  batch_results_.clear();
+  timings_.scoring_seconds += SecondsSince(start);
+}
+
+void EvolverAdHoc::OnOffspringCreated(int index) {
+  if (!worker_pool_)
+    return;
+  RegisterForEvaluation(index);
+  if (duplicate_of_[index] == index)
+    SubmitExecution(index);
+}
+
+void EvolverAdHoc::EvaluatePrograms() {
+  BeginEvaluation();
+  for (int i = 0; i < mu_ + lambda_; ++i)
+    RegisterForEvaluation(i);
+  input_batch_ = scorer_.NextInputBatch(current_evaluations_per_program_);
+  if (evaluation_order_ != kInputsMajor) {
+    ExecuteAndScoreProgramsMajor(false);
+  } else {
+    for (int j = 0; j < current_evaluations_per_program_; ++j) {
+      current_evaluation_ = j;
+      ExecuteAndScoreRound(false);
+    }
+  }
+  FinishEvaluation();
+}
+
+void EvolverAdHoc::CreateAndEvaluateProgramsPipelined() {
+  BeginEvaluation();
+  // Inputs are generated prior to the offspring so the parents can be executed
+  // while the offspring are created.
+  input_batch_ = scorer_.NextInputBatch(current_evaluations_per_program_);
+  current_evaluation_ = 0;
+  for (int i = 0; i < mu_; ++i) {
+    RegisterForEvaluation(i);
+    if (duplicate_of_[i] == i)
+      SubmitExecution(i);
+  }
+  Clock::time_point start = Clock::now();
+  CreateOffspring();
+  timings_.mutation_seconds += SecondsSince(start);
+  if (evaluation_order_ != kInputsMajor) {
+    ExecuteAndScoreProgramsMajor(true);
+  } else {
+    ExecuteAndScoreRound(true);
+    for (int j = 1; j < current_evaluations_per_program_; ++j) {
+      current_evaluation_ = j;
+      ExecuteAndScoreRound(false);
+    }
+  }
+  FinishEvaluation();
+}
+
+void EvolverAdHoc::FinishEvaluation() {
+  for (int i = 0; i < mu_ + lambda_; ++i) {
+    if (duplicate_of_[i] != i)
+      continue;
+    long long score = programs_[i]->current_score();
+    if (scorer_.MaxScore() > 0) {
+      best_score_fraction_ =
+          std::max(best_score_fraction_,
+                   (double)score / current_evaluations_per_program_ /
+                       scorer_.MaxScore());
+    }
+    // Normalize the score to evaluations_per_program_ evaluations.
+    if (current_evaluations_per_program_ != evaluations_per_program_) {
+      programs_[i]->ResetCurrentScore();
+      programs_[i]->IncrementCurrentScoreBy(score * evaluations_per_program_ /
+                                            current_evaluations_per_program_);
+    }
+  }
+
+  if (score_results_history_) {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < mu_ + lambda_; ++i) {
+      if (duplicate_of_[i] != i)
+        continue;
+      programs_[i]->IncrementCurrentScoreBy(
+          scorer_.ScoreResultsHistory(programs_[i]->results_history()));
+    }
+    timings_.scoring_seconds += SecondsSince(start);
+  }
+
+  for (int i = 0; i < mu_ + lambda_; ++i) {
+    if (duplicate_of_[i] != i)
+      programs_[i]->CopyEvaluationStateFrom(*programs_[duplicate_of_[i]]);
+  }
+
+  CheckDeterminismOfPrograms();
+}
+
+void EvolverAdHoc::CheckDeterminismOfPrograms() {
+  generation_determinism_checks_ = 0;
+  generation_nondeterministic_ = 0;
+  if (determinism_check_programs_ <= 0 || input_batch_->empty())
+    return;
+
+  std::vector<int> candidates;
+  for (int i = 0; i < mu_ + lambda_; ++i) {
+    if (duplicate_of_[i] == i && !programs_[i]->nondeterministic())
+      candidates.push_back(i);
+  }
+  Clock::time_point start = Clock::now();
+  while (generation_determinism_checks_ < determinism_check_programs_ &&
+         !candidates.empty()) {
+    int k = gen_() % candidates.size();
+    Program &program = *programs_[candidates[k]];
+    candidates[k] = candidates.back();
+    candidates.pop_back();
+
+    program.SetElfInputs(input_batch_->inputs(0), input_batch_->inputs_size());
+    ++generation_determinism_checks_;
+    if (!program.CheckDeterminism(determinism_check_executions_))
+      ++generation_nondeterministic_;
+  }
+  std::chrono::nanoseconds duration = Clock::now() - start;
+  execution_nanoseconds_ += duration.count();
+}
+
+void EvolverAdHoc::ScoreMutationOutcomes() {
+  for (size_t i = 0; i < mutation_outcomes_.size(); ++i) {
+    mutation_outcomes_[i].improved =
+        mutation_outcomes_[i].target->current_score() >
+        mutation_outcomes_[i].parent1->current_score();
+  }
+}
+
+void EvolverAdHoc::ReportMutationOutcomes() {
+  if (mutation_outcomes_.empty())
+    return;
+  std::unordered_set<const Program *> parents;
+  for (int i = 0; i < mu_; ++i)
+    parents.insert(programs_[i].get());
+  for (auto &outcome : mutation_outcomes_)
+    outcome.survived = parents.count(outcome.target.get()) > 0;
+  mutator_.Update(mutation_outcomes_);
+}
+
+bool EvolverAdHoc::UpdateCurrentEvaluationsPerProgram() {
+  int evaluations = evaluations_per_program_;
+  if (fidelity_schedule_) {
+    evaluations = fidelity_schedule_->EvaluationsPerProgram(
+        current_generation_, best_score_fraction_);
+    evaluations = std::min(evaluations_per_program_, std::max(1, evaluations));
+    // Do not decrease the fidelity once it was increased (e.g. to prevent
+    // oscillations for schedules based on scores).
+    if (current_generation_ > 1)
+      evaluations = std::max(evaluations, current_evaluations_per_program_);
+  }
+  bool changed = (evaluations != current_evaluations_per_program_);
+  current_evaluations_per_program_ = evaluations;
+  return changed;
+}
+
 void EvolverAdHoc::Run() {
-  std::cout.imbue(std::locale(""));
-  long long best_overall_score = 0;
+  std::ostream &out = *out_;
+  out.imbue(std::locale(""));
+  best_overall_score_ = 0;
+  reached_max_score_ = false;
+  timings_ = StageTimings();
+  execution_nanoseconds_ = 0;
+  std::fill(prescreen_verdict_counts_.begin(), prescreen_verdict_counts_.end(),
+            0);
   long long max_score = evaluations_per_program_ * scorer_.MaxScore() +
                         scorer_.MaxScoreResultsHistory();
   while (current_generation_ < max_generations_) {
     ++current_generation_;
 
+    if (UpdateCurrentEvaluationsPerProgram() ||
+        (current_generation_ == 1 && fidelity_schedule_)) {
+      out << "\n            | fidelity: " << current_evaluations_per_program_
+          << "/" << evaluations_per_program_
+          << " evaluations per program from generation "
+          << current_generation_ << "\n"
+          << std::flush;
+    }
+
+    Clock::time_point generation_start = Clock::now();
     // Stage 1 (SelectParents): Bring the mu_ parents to the "front" of
     // programs_.
     // --------------------------------------------------------------
     SelectParents();
-    // Stage 2 (CreateOffspring): Create lambda_ offspring in the last lambda_
-    // elements of programs_ using the first mu_ elements of programs as
-    // parents.
-    // --------------------------------------------------------------------
-    for (int i = 0; i < lambda_; ++i) {
-      // Note: The same program may be selected as both parent1 and parent2
-      // and this is ok for e.g. random recombinations.
-      mutator_.Mutate(programs_[mu_ + i], programs_[gen_() % mu_],
-                      programs_[gen_() % mu_]);
-    }
-
-    // Stage 3 (EvaluatePrograms): Update programs_ inputs, execute and score
-    // programs_.
-    // -----------------------------------------
-    for (int i = 0; i < mu_ + lambda_; ++i) {
-      programs_[i]->ResetCurrentScore();
-      programs_[i]->ClearResultsHistory();
-    }
-    for (int j = 0; j < evaluations_per_program_; ++j) {
-      scorer_.ResetInputs();
-      for (int i = 0; i < mu_ + lambda_; ++i) {
-        programs_[i]->SetElfInputs(scorer_.current_inputs());
-        programs_[i]->Execute();
-        programs_[i]->IncrementCurrentScoreBy(scorer_.Score(*programs_[i]));
-      }
-    }
-
-    if (score_results_history_) {
-      for (int i = 0; i < mu_ + lambda_; ++i) {
-        programs_[i]->IncrementCurrentScoreBy(
-            scorer_.ScoreResultsHistory(programs_[i]->results_history()));
-      }
+    ReportMutationOutcomes();
+    timings_.mutation_seconds += SecondsSince(generation_start);
+    if (!worker_pool_) {
+      // Stage 2 (CreateOffspring): Create lambda_ offspring in the last
+      // lambda_ elements of programs_ using the first mu_ elements of programs
+      // as parents.
+      // --------------------------------------------------------------------
+      Clock::time_point start = Clock::now();
+      CreateOffspring();
+      timings_.mutation_seconds += SecondsSince(start);
+      // Stage 3 (EvaluatePrograms): Update programs_ inputs, execute and score
+      // programs_.
+      // -----------------------------------------
+      EvaluatePrograms();
+    } else {
+      // Stages 2 and 3 overlap: the parents are executed while the offspring
+      // are created, each offspring is executed as soon as it is created and
+      // programs are scored while the remaining programs are executing.
+      CreateAndEvaluateProgramsPipelined();
     }
+    timings_.wall_seconds += SecondsSince(generation_start);
+    timings_.execution_seconds = execution_nanoseconds_ * 1e-9;
+    ScoreMutationOutcomes();
 
     long long best_generation_score = 0;
     std::unordered_map<unsigned long long, int> rip_offset_counts;
@@ -124,33 +563,79 @@ void EvolverAdHoc::Run() {
         top_rip_offset = rip_offset;
       }
     }
-    std::cout << "\33[2K\rG: " << std::setw(8) << current_generation_
-              << " | best score: " << best_generation_score << " (overall: "
-              << std::max(best_overall_score, best_generation_score) << "/"
-              << max_score << ") "
-              << " | rip distinct: " << rip_offset_counts.size()
-              << " top: " << top_rip_offset
-              << " count: " << top_rip_offset_count << std::flush;
-    if (best_overall_score < best_generation_score) {
-      best_overall_score = best_generation_score;
-      std::cout << "\n            | best last results: ";
+    bool improved = best_overall_score_ < best_generation_score;
+    // Scores from fewer evaluations than evaluations_per_program_ are scaled
+    // up and are not sufficient to conclude the evolution.
+    bool done = best_generation_score == max_score &&
+                current_evaluations_per_program_ == evaluations_per_program_;
+    if (overwrite_progress_line_ || improved || done ||
+        current_generation_ == max_generations_) {
+      if (overwrite_progress_line_)
+        out << "\33[2K\r";
+      out << "G: " << std::setw(8) << current_generation_
+          << " | best score: " << best_generation_score << " (overall: "
+          << std::max(best_overall_score_, best_generation_score) << "/"
+          << max_score << ") "
+          << " | rip distinct: " << rip_offset_counts.size()
+          << " top: " << top_rip_offset << " count: " << top_rip_offset_count
+          << " | evals: " << current_evaluations_per_program_ << "/"
+          << evaluations_per_program_;
+      if (deduplicate_) {
+        out << " | dup: " << generation_duplicates_
+            << " remut: " << generation_remutations_;
+      }
+      if (prescreen_) {
+        out << " | prescreen: " << generation_prescreen_rejections_ << "/"
+            << generation_prescreen_checks_;
+      }
+      if (determinism_check_programs_ > 0) {
+        out << " | nondet: " << generation_nondeterministic_ << "/"
+            << generation_determinism_checks_;
+      }
+      out << std::flush;
+    }
+    if (improved) {
+      best_overall_score_ = best_generation_score;
+      out << "\n            | best last results: ";
       for (auto itm : best_generation_results)
-        std::cout << itm << " ";
-      std::cout << "\n" << std::flush;
+        out << itm << " ";
+      out << "\n" << std::flush;
 
       std::string filename = output_filename_prefix_ + "gen_" +
                              std::to_string(current_generation_) +
                              "_best_program.elf";
       programs_[best_generation_program_index]->SaveElf(filename.c_str());
     }
-    if (best_overall_score == max_score) {
-      std::cout << "DONE! :)\n";
+    if (done) {
+      reached_max_score_ = true;
+      out << "DONE! :)\n";
       std::string best_filename = output_filename_prefix_ + "best_program.elf";
       programs_[best_generation_program_index]->SaveElf(best_filename.c_str());
       break;
     }
   }
-  std::cout << "\n";
+  out << "\n            | stage timings (s): select+mutate: "
+      << timings_.mutation_seconds
+      << " | execute (busy): " << timings_.execution_seconds
+      << " | score: " << timings_.scoring_seconds
+      << " | wall: " << timings_.wall_seconds
+      << " | overlap: " << timings_.Overlap() << "\n"
+      << std::flush;
+  if (prescreen_) {
+    long long checks = 0;
+    for (long long count : prescreen_verdict_counts_)
+      checks += count;
+    out << "            | prescreen rejections: "
+        << checks - prescreen_verdict_counts_[CodePrescreen::kAccept] << "/"
+        << checks;
+    for (int verdict = CodePrescreen::kAccept + 1;
+         verdict < CodePrescreen::kNumVerdicts; ++verdict) {
+      out << " | "
+          << CodePrescreen::VerdictName((CodePrescreen::Verdict)verdict)
+          << ": " << prescreen_verdict_counts_[verdict];
+    }
+    out << "\n" << std::flush;
+  }
 }
 
 } // namespace viaevo
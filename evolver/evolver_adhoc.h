@@ -6,14 +6,24 @@
 #ifndef VIAEVO_EVOLVER_EVOLVER_ADHOC_H_
 #define VIAEVO_EVOLVER_EVOLVER_ADHOC_H_
 
+#include <atomic>
+#include <future>
+#include <iostream>
 #include <memory>
 #include <vector>
 
+#include "fidelity_schedule.h"
+#include "genome_index.h"
+
 // TODO: Remove relative paths.
+#include "../mutator/genome_arena.h"
 #include "../mutator/mutator.h"
 #include "../program/program.h"
 #include "../scorer/scorer.h"
 #include "../util/random.h"
+#include "../util/random_stream.h"
+#include "../util/worker_pool.h"
+#include "../x86/code_prescreen.h"
 
 namespace viaevo {
 
@@ -26,6 +36,28 @@ namespace viaevo {
 // reflecting common approaches in Evolutionary Computation.
 class EvolverAdHoc {
 public:
+  // Cumulative wall-clock durations of the stages of Run (in seconds).
+  struct StageTimings {
+    // SelectParents and CreateOffspring.
+    double mutation_seconds = 0.0;
+    // Sum of the durations of all Program executions (with pipelining, the
+    // executions run concurrently on multiple threads).
+    double execution_seconds = 0.0;
+    // Scorer's ScoreBatch and ScoreResultsHistory.
+    double scoring_seconds = 0.0;
+    // All stages from the selection of parents to the last score.
+    double wall_seconds = 0.0;
+
+    // Returns the sum of the stage durations divided by the wall-clock
+    // duration (about 1.0 without any overlap of the stages).
+    double Overlap() const {
+      return wall_seconds > 0.0 ? (mutation_seconds + execution_seconds +
+                                   scoring_seconds) /
+                                      wall_seconds
+                                : 0.0;
+    }
+  };
+
   EvolverAdHoc(std::string elf_filename, int mu, int phi, int lambda,
                Scorer &scorer, Mutator &mutator, Random &gen,
                int evaluations_per_program, int max_generations,
@@ -37,10 +69,198 @@ public:
   // Runs the evolution.
   virtual void Run();
 
+  // Sets the schedule for the number of evaluations per program in each
+  // generation. The schedule's values are clamped between 1 and
+  // evaluations_per_program_. Without a schedule, evaluations_per_program_
+  // evaluations are performed in each generation.
+  void set_fidelity_schedule(std::shared_ptr<FidelitySchedule> schedule) {
+    fidelity_schedule_ = schedule;
+  }
+
+  // When deduplicate is true, programs with identical code (evolvable code)
+  // within a generation are executed only once and the results are copied to
+  // the duplicates. Offspring identical to a program created earlier in the
+  // same generation are re-mutated up to max_remutations times (with new
+  // parents) to maintain diversity. NOTE: Programs computing results
+  // non-deterministically will not be "penalized" for it via their duplicates
+  // (unless found nondeterministic, see set_determinism).
+  void set_deduplicate(bool deduplicate, int max_remutations = 0) {
+    deduplicate_ = deduplicate;
+    max_remutations_ = max_remutations;
+  }
+
+  // When prescreen is true, offspring are checked with CodePrescreen against
+  // the code of their parent1 before they are evaluated. Offspring certain to
+  // fault in the mutated bytes are re-mutated (with new parents) up to
+  // max_rejections times. An offspring rejected max_rejections times is kept
+  // (and executed) as it is.
+  void set_prescreen(bool prescreen, int max_rejections = 8) {
+    prescreen_ = prescreen;
+    max_prescreen_rejections_ = max_rejections;
+  }
+
+  // When deterministic_execution is true, programs are executed with
+  // Program::set_deterministic_execution. With check_programs > 0,
+  // check_programs programs chosen at random among the programs executed in a
+  // generation (and not found nondeterministic before) are executed
+  // check_executions times on the inputs of the first evaluation after the
+  // generation is scored (see Program::CheckDeterminism). Programs found
+  // nondeterministic are not deduplicated (see set_deduplicate), i.e. results
+  // are only reused for programs not found nondeterministic.
+  void set_determinism(bool deterministic_execution, int check_programs = 0,
+                       int check_executions = 2);
+
+  // When coverage is true, the first execution of each program after its code
+  // changes records the instructions executed in main (see
+  // Program::set_coverage_executions) for mutators concentrating on the
+  // executed code (e.g. MutatorPointCovered). With pipelining, parents are not
+  // traced (they are executed while the offspring are created), i.e. only the
+  // offspring get coverage.
+  void set_coverage(bool coverage) { coverage_ = coverage; }
+
+  // When batch_mutation is true, the offspring of each generation are created
+  // by a single Mutator::MutateBatch call: the parents' code is loaded to a
+  // GenomeArena once per generation and each offspring draws its random
+  // numbers from its own RandomStream (seeded with stream_seed and derived for
+  // the generation and the offspring). With num_threads > 1, the offspring are
+  // created on num_threads threads (with the same results). Re-mutations (see
+  // set_deduplicate and set_prescreen) use Mutate. The mutator must implement
+  // MutateGenome.
+  void set_batch_mutation(bool batch_mutation, uint64_t stream_seed = 0,
+                          int num_threads = 1);
+
+  // Pipelines the generations when num_threads > 0: programs are executed on
+  // num_threads threads, parents are executed while the offspring are created,
+  // each offspring is executed as soon as it is created and programs are
+  // scored (in the same order as without pipelining) while the remaining
+  // programs are executing. The evolution is deterministic for a fixed random
+  // seed, but the inputs for the evaluations of each generation are generated
+  // before (rather than after) the offspring are created, i.e. the evolution
+  // differs from the evolution without pipelining for Scorers drawing their
+  // inputs from the random number generator.
+  void set_pipelined(int num_threads);
+
+  // Order of the executions in the evaluation of a generation. The inputs for
+  // all evaluations are generated up front (see InputBatch) and the programs
+  // are scored in the same order (an evaluation at a time), i.e. the evolution
+  // does not depend on the order.
+  enum EvaluationOrder {
+    // All programs are executed on the inputs of an evaluation before the
+    // next evaluation (scoring overlaps the executions of the next round).
+    kInputsMajor,
+    // Each program is executed on the inputs of all evaluations at once (a
+    // single task per program with pipelining, fewer and larger tasks).
+    kProgramsMajor,
+    // As kProgramsMajor, but the executions of a program on the inputs of all
+    // evaluations are batched into as few processes as possible (see
+    // Program::ExecuteBatch). The evolved code runs in a slightly different
+    // environment (e.g. the state of libc persists between the evaluations of
+    // a process), i.e. the evolution may differ from kProgramsMajor. Each
+    // evaluation still gets (at least) the time limit of a single execution.
+    kProgramsMajorBatched,
+  };
+  void set_evaluation_order(EvaluationOrder evaluation_order) {
+    evaluation_order_ = evaluation_order;
+  }
+
+  // Sets the stream for the progress output of Run (std::cout by default). If
+  // overwrite_progress_line is false (e.g. for log files), the progress line is
+  // not overwritten in every generation and is only written when the best
+  // score improves and in the last generation.
+  void set_output_stream(std::ostream &out, bool overwrite_progress_line) {
+    out_ = &out;
+    overwrite_progress_line_ = overwrite_progress_line;
+  }
+
   const std::vector<std::shared_ptr<Program>> &programs() { return programs_; }
   bool score_results_history() const { return score_results_history_; }
+  int current_evaluations_per_program() const {
+    return current_evaluations_per_program_;
+  }
+  int generation_duplicates() const { return generation_duplicates_; }
+  int generation_remutations() const { return generation_remutations_; }
+  int generation_determinism_checks() const {
+    return generation_determinism_checks_;
+  }
+  int generation_nondeterministic() const {
+    return generation_nondeterministic_;
+  }
+  int generation_prescreen_checks() const {
+    return generation_prescreen_checks_;
+  }
+  int generation_prescreen_rejections() const {
+    return generation_prescreen_rejections_;
+  }
+  // Number of CodePrescreen verdicts (indexed by CodePrescreen::Verdict) in
+  // Run.
+  const std::vector<long long> &prescreen_verdict_counts() const {
+    return prescreen_verdict_counts_;
+  }
+  int current_generation() const { return current_generation_; }
+  long long best_overall_score() const { return best_overall_score_; }
+  // True if Run concluded with a program reaching the maximum score.
+  bool reached_max_score() const { return reached_max_score_; }
+  const StageTimings &stage_timings() const { return timings_; }
 
 protected:
+  // Creates lambda_ offspring in the last lambda_ elements of programs_ using
+  // the first mu_ elements of programs_ as parents.
+  virtual void CreateOffspring();
+  // Creates the offspring in offspring_arena_ via MutateBatch (see
+  // set_batch_mutation).
+  void MutateBatch();
+  // Called by CreateOffspring for each created offspring. With pipelining,
+  // submits the offspring for execution.
+  void OnOffspringCreated(int index);
+  // Updates programs_ inputs, executes and scores programs_. Scores are
+  // normalized to evaluations_per_program_ evaluations (see
+  // current_evaluations_per_program_).
+  virtual void EvaluatePrograms();
+  // Pipelined CreateOffspring and EvaluatePrograms (see set_pipelined).
+  void CreateAndEvaluateProgramsPipelined();
+
+  // Helpers of EvaluatePrograms and CreateAndEvaluateProgramsPipelined.
+  // Resets the state of the evaluation of a generation.
+  void BeginEvaluation();
+  // Resets the score of programs_[index] and determines whether it is a
+  // duplicate of a previously registered program (see set_deduplicate).
+  void RegisterForEvaluation(int index);
+  // Submits programs_[index] for execution on worker_pool_: on the inputs of
+  // current_evaluation_ (kInputsMajor) or of all evaluations (kProgramsMajor
+  // and kProgramsMajorBatched).
+  void SubmitExecution(int index);
+  // Executes (unless already submitted) and scores all registered programs
+  // (except for duplicates) on the inputs of current_evaluation_. The programs
+  // are scored by a single ScoreBatch call.
+  void ExecuteAndScoreRound(bool submitted);
+  // Executes programs_[index] on the inputs of all evaluations and stores the
+  // results in evaluation_results_[index].
+  void ExecuteAllEvaluations(int index);
+  // Executes (unless already submitted) all registered programs (except for
+  // duplicates) on the inputs of all evaluations and scores them by a
+  // ScoreBatch call per evaluation.
+  void ExecuteAndScoreProgramsMajor(bool submitted);
+  // Appends results of programs_[index] to the pending score batch (empty
+  // results are not scored, i.e. score 0).
+  void AppendToScoreBatch(int index, const std::vector<int> &results);
+  // Scores the pending score batch and adds the scores to the programs.
+  void ScorePendingBatch();
+  // Normalizes scores, scores results histories and copies evaluation states
+  // to duplicates.
+  void FinishEvaluation();
+  // Re-executes a sample of the programs executed in the generation to find
+  // nondeterministic programs (see set_determinism).
+  void CheckDeterminismOfPrograms();
+  // Sets improved of mutation_outcomes_ (called after the offspring are
+  // evaluated).
+  void ScoreMutationOutcomes();
+  // Sets survived of mutation_outcomes_ and passes them to mutator_'s Update
+  // (called after the parents of the next generation are selected).
+  void ReportMutationOutcomes();
+  // Updates current_evaluations_per_program_ based on fidelity_schedule_.
+  // Returns true if the value changed.
+  bool UpdateCurrentEvaluationsPerProgram();
+
   // Size of population in each generation (iteration) is (mu_ + lambda_).
   // Number of parents selected in each iteration.
   int mu_ = 30;
@@ -55,6 +275,14 @@ protected:
 
   // Scorer used to provide input data and score results in each iteration.
   Scorer &scorer_;
+  // Inputs of all evaluations of the current generation (from scorer_'s
+  // NextInputBatch), the index of the current evaluation round and its
+  // InputSet.
+  std::shared_ptr<const InputBatch> input_batch_;
+  int current_evaluation_ = 0;
+  std::shared_ptr<const InputSet> input_set_;
+  // See set_evaluation_order.
+  EvaluationOrder evaluation_order_ = kInputsMajor;
   // Mutator used to create offspring from parents in each iteration.
   Mutator &mutator_;
   // Random number generator.
@@ -63,6 +291,16 @@ protected:
   // Number of evaluations (with different inputs) a Scorer performs on each
   // program in each generation. Scores are accumulated.
   int evaluations_per_program_ = 1;
+  // Number of evaluations performed in the current generation (at most
+  // evaluations_per_program_). Scores accumulated over fewer evaluations are
+  // scaled by evaluations_per_program_ / current_evaluations_per_program_ so
+  // they remain comparable across generations.
+  int current_evaluations_per_program_ = 1;
+  // Optional schedule for current_evaluations_per_program_.
+  std::shared_ptr<FidelitySchedule> fidelity_schedule_;
+  // Best score per evaluation (excluding results history scores) observed so
+  // far divided by Scorer's MaxScore. Passed to fidelity_schedule_.
+  double best_score_fraction_ = 0.0;
 
   // Current and the maximum number of generations (iterations) for the
   // evolution.
@@ -73,8 +311,86 @@ protected:
   // evaluations in a generation are completed.
   bool score_results_history_ = false;
 
+  // Deduplication of programs with identical code within a generation (see
+  // set_deduplicate).
+  bool deduplicate_ = false;
+  int max_remutations_ = 0;
+  // Number of programs in the current generation that were not executed as
+  // they were identical to another program and the number of re-mutations
+  // performed in the current generation to avoid duplicate offspring.
+  int generation_duplicates_ = 0;
+  int generation_remutations_ = 0;
+
+  // Prescreening of offspring (see set_prescreen). Number of offspring checked
+  // and rejected in the current generation and the number of verdicts in Run.
+  bool prescreen_ = false;
+  int max_prescreen_rejections_ = 8;
+  int generation_prescreen_checks_ = 0;
+  int generation_prescreen_rejections_ = 0;
+  std::vector<long long> prescreen_verdict_counts_ =
+      std::vector<long long>(CodePrescreen::kNumVerdicts, 0);
+
+  // See set_determinism. Number of programs re-executed and found
+  // nondeterministic in the current generation.
+  bool deterministic_execution_ = false;
+  int determinism_check_programs_ = 0;
+  int determinism_check_executions_ = 2;
+  int generation_determinism_checks_ = 0;
+  int generation_nondeterministic_ = 0;
+
+  // See set_coverage.
+  bool coverage_ = false;
+
+  // Batch mutation (see set_batch_mutation). The arenas with the parents and
+  // the offspring of the current generation, the offspring's slots, the
+  // streams the slots are derived from and the threads creating the offspring.
+  bool batch_mutation_ = false;
+  GenomeArena parents_arena_;
+  GenomeArena offspring_arena_;
+  std::vector<MutationSlot> mutation_slots_;
+  RandomStream mutation_streams_;
+  std::shared_ptr<WorkerPool> mutation_pool_;
+
+  // Outcomes of the offspring of the last generation (mutation_outcomes_[i]
+  // for programs_[mu_ + i]).
+  std::vector<MutationOutcome> mutation_outcomes_;
+
+  // State of the evaluation of the current generation. duplicate_of_[i] is the
+  // index of the program executed in place of programs_[i] (i unless
+  // programs_[i] is a duplicate, -1 until programs_[i] is registered).
+  GenomeIndex evaluation_genome_index_;
+  std::vector<int> duplicate_of_;
+
+  // Worker threads executing programs when pipelined (see set_pipelined) and
+  // the pending executions of programs_.
+  std::shared_ptr<WorkerPool> worker_pool_;
+  std::vector<std::future<void>> executions_;
+  // Results of programs_[i] for each evaluation with kProgramsMajor(Batched)
+  // (evaluation_results_[i][j] for the j-th evaluation).
+  std::vector<std::vector<std::vector<int>>> evaluation_results_;
+
+  // Pending score batch of the current round (see ExecuteAndScoreRound): the
+  // indices of the programs, their results (a row of batch_results_size_
+  // elements per program) and the scores computed by the Scorer.
+  std::vector<int> batch_indices_;
+  std::vector<int> batch_results_;
+  size_t batch_results_size_ = 0;
+  std::vector<long long> batch_scores_;
+
+  // Stage timings of Run. execution_nanoseconds_ is updated by the worker
+  // threads.
+  StageTimings timings_;
+  std::atomic<long long> execution_nanoseconds_{0};
+
+  // Best score observed in Run and whether it was the maximum score.
+  long long best_overall_score_ = 0;
+  bool reached_max_score_ = false;
+
   // Prefix to prepend to output file names (e.g. for saved evolved elfs).
   std::string output_filename_prefix_;
+  // Stream for the progress output (see set_output_stream).
+  std::ostream *out_ = &std::cout;
+  bool overwrite_progress_line_ = true;
 };
 
 } // namespace viaevo
@@ -6,17 +6,93 @@
 #include "evolver_adhoc.h"
 
 #include <algorithm>
+#include <string>
 
 #include <gtest/gtest.h>
 
+#include "fidelity_schedule_generations.h"
+
 // TODO: Remove relative path.
 #include "../mutator/mutator_point_random.h"
 #include "../program/program.h"
 #include "../scorer/scorer_mock.h"
+#include "../util/random.h"
 #include "../util/random_mock.h"
 
 namespace {
 
+// Records the outcomes passed to Update.
+class MutatorRecordingOutcomes : public viaevo::MutatorPointRandom {
+public:
+  MutatorRecordingOutcomes(viaevo::Random &gen)
+      : viaevo::MutatorPointRandom(gen) {}
+  void Update(const std::vector<viaevo::MutationOutcome> &outcomes) override {
+    updates.push_back(outcomes);
+  }
+  std::vector<std::vector<viaevo::MutationOutcome>> updates;
+};
+
+// Copies parent1's code to target and overwrites its first byte with the next
+// element of first_bytes (cyclically).
+class MutatorFirstByte : public viaevo::Mutator {
+public:
+  MutatorFirstByte(std::vector<char> first_bytes) : first_bytes(first_bytes) {}
+  void Mutate(std::shared_ptr<viaevo::Program> target,
+              std::shared_ptr<viaevo::Program> parent1,
+              std::shared_ptr<viaevo::Program> parent2) override {
+    std::vector<char> code = parent1->GetElfCode();
+    code[0] = first_bytes[calls++ % first_bytes.size()];
+    target->SetElfCode(code);
+  }
+  std::vector<char> first_bytes;
+  int calls = 0;
+};
+
+// Copies parent1's code to target. The code is read repeatedly (e.g. while
+// parent1 is executed on a worker thread) and the reads that differ from the
+// first read are counted.
+class MutatorCopyRereading : public viaevo::Mutator {
+public:
+  void Mutate(std::shared_ptr<viaevo::Program> target,
+              std::shared_ptr<viaevo::Program> parent1,
+              std::shared_ptr<viaevo::Program> parent2) override {
+    std::vector<char> code = parent1->GetElfCode();
+    for (int i = 0; i < 100; ++i) {
+      if (parent1->GetElfCode() != code)
+        ++inconsistent_reads;
+    }
+    target->SetElfCode(code);
+  }
+  int inconsistent_reads = 0;
+};
+
+// Sets target's code to all nops with code at position 16.
+class MutatorCode : public viaevo::Mutator {
+public:
+  MutatorCode(std::string code) : code(code) {}
+  void Mutate(std::shared_ptr<viaevo::Program> target,
+              std::shared_ptr<viaevo::Program> parent1,
+              std::shared_ptr<viaevo::Program> parent2) override {
+    std::vector<char> elf_code(target->elf_code_size(), '\x90');
+    std::copy(code.begin(), code.end(), elf_code.begin() + 16);
+    target->SetElfCode(elf_code);
+  }
+  std::string code;
+};
+
+// Exposes the scoring helpers of EvolverAdHoc.
+class EvolverAdHocScoring : public viaevo::EvolverAdHoc {
+public:
+  using viaevo::EvolverAdHoc::EvolverAdHoc;
+  // Adds the scores of rows[i] to programs_[i] (scored as a single batch).
+  void Score(const std::vector<std::vector<int>> &rows) {
+    input_set_ = std::make_shared<viaevo::InputSet>();
+    for (size_t i = 0; i < rows.size(); ++i)
+      AppendToScoreBatch(i, rows[i]);
+    ScorePendingBatch();
+  }
+};
+
 TEST(EvolverAdHocTest, RunSelectParents) {
   viaevo::RandomMock gen({7, 17});
 
@@ -147,4 +223,382 @@ TEST(EvolverAdHocTest, InitializeProgramsToAllNops) {
   }
 }
 
+TEST(EvolverAdHocTest, FidelitySchedule) {
+  viaevo::RandomMock gen({7, 17});
+
+  viaevo::MutatorPointRandom mutator(gen);
+
+  viaevo::ScorerMock scorer({0, 0, 5}, 10, {});
+
+  viaevo::EvolverAdHoc evolver("elfs/simple_small", 2, 1, 1, scorer, mutator,
+                               gen, 4, 1);
+
+  EXPECT_EQ(evolver.current_evaluations_per_program(), 4)
+      << "All evaluations should be performed without a fidelity schedule.";
+
+  evolver.set_fidelity_schedule(
+      std::make_shared<viaevo::FidelityScheduleGenerations>(2, 4, 10));
+
+  evolver.Run();
+
+  EXPECT_EQ(evolver.current_evaluations_per_program(), 2);
+
+  // Two evaluations with a score of 5 each are scaled to four evaluations.
+  auto &programs = evolver.programs();
+  EXPECT_EQ(programs[0]->current_score(), 0);
+  EXPECT_EQ(programs[1]->current_score(), 0);
+  EXPECT_EQ(programs[2]->current_score(), 20);
+}
+
+TEST(EvolverAdHocTest, Deduplicate) {
+  viaevo::RandomMock gen({7, 17});
+
+  viaevo::MutatorPointRandom mutator(gen);
+
+  viaevo::ScorerMock scorer({0, 0, 5}, 10, {});
+
+  viaevo::EvolverAdHoc evolver("elfs/simple_small", 2, 1, 1, scorer, mutator,
+                               gen, 1, 1);
+  evolver.set_deduplicate(true);
+
+  evolver.Run();
+
+  // The two parents are identical (unmutated template) and only the first one
+  // and the offspring are executed and scored.
+  EXPECT_EQ(evolver.generation_duplicates(), 1);
+  EXPECT_EQ(evolver.generation_remutations(), 0);
+
+  auto &programs = evolver.programs();
+  EXPECT_EQ(programs[0]->current_score(), 0);
+  EXPECT_EQ(programs[1]->current_score(), 0);
+  EXPECT_EQ(programs[2]->current_score(), 0);
+  EXPECT_EQ(programs[1]->last_exit_status(), programs[0]->last_exit_status());
+}
+
+TEST(EvolverAdHocTest, DeduplicateRemutate) {
+  // All parents and mutations are the same, i.e. both offspring are identical.
+  viaevo::RandomMock gen({0});
+
+  viaevo::MutatorPointRandom mutator(gen);
+
+  viaevo::ScorerMock scorer({0, 0, 5}, 10, {});
+
+  viaevo::EvolverAdHoc evolver("elfs/simple_small", 2, 0, 2, scorer, mutator,
+                               gen, 1, 1);
+  evolver.set_deduplicate(true, 3);
+
+  evolver.Run();
+
+  // The second offspring is re-mutated 3 times without success.
+  EXPECT_EQ(evolver.generation_remutations(), 3);
+  // The second parent and the second offspring are duplicates.
+  EXPECT_EQ(evolver.generation_duplicates(), 2);
+
+  auto &programs = evolver.programs();
+  EXPECT_EQ(programs[2]->GetElfCode(), programs[3]->GetElfCode());
+  EXPECT_NE(programs[0]->GetElfCode(), programs[2]->GetElfCode());
+  EXPECT_EQ(programs[3]->current_score(), programs[2]->current_score());
+}
+
+TEST(EvolverAdHocTest, Pipelined) {
+  viaevo::RandomMock gen({7, 17});
+
+  viaevo::MutatorPointRandom mutator(gen);
+
+  viaevo::ScorerMock scorer({0, 0, 5}, 10, {});
+
+  viaevo::EvolverAdHoc evolver("elfs/simple_small", 2, 1, 1, scorer, mutator,
+                               gen, 1, 1);
+  evolver.set_pipelined(2);
+
+  evolver.Run();
+
+  // Programs are scored in the same order as in RunSelectParents (ScorerMock
+  // does not draw its inputs from gen).
+  auto &programs = evolver.programs();
+  EXPECT_EQ(programs[0]->current_score(), 0);
+  EXPECT_EQ(programs[1]->current_score(), 0);
+  EXPECT_EQ(programs[2]->current_score(), 5);
+
+  const viaevo::EvolverAdHoc::StageTimings &timings = evolver.stage_timings();
+  EXPECT_GT(timings.execution_seconds, 0.0);
+  EXPECT_GT(timings.wall_seconds, 0.0);
+  EXPECT_GT(timings.Overlap(), 0.0);
+}
+
+TEST(EvolverAdHocTest, ScoreBatch) {
+  for (int num_threads : {0, 2}) {
+    viaevo::RandomMock gen({7, 17});
+
+    viaevo::MutatorPointRandom mutator(gen);
+
+    viaevo::ScorerMock scorer({0, 0, 5}, 10, {});
+
+    viaevo::EvolverAdHoc evolver("elfs/simple_small", 2, 1, 1, scorer,
+                                 mutator, gen, 1, 1);
+    if (num_threads > 0)
+      evolver.set_pipelined(num_threads);
+
+    evolver.Run();
+
+    // The rows of the batch are in the order of programs_, i.e. the scores are
+    // the same as in RunSelectParents.
+    auto &programs = evolver.programs();
+    EXPECT_EQ(programs[0]->current_score(), 0);
+    EXPECT_EQ(programs[1]->current_score(), 0);
+    EXPECT_EQ(programs[2]->current_score(), 5);
+  }
+}
+
+TEST(EvolverAdHocTest, PipelinedDeterministic) {
+  std::vector<std::vector<char>> codes[2];
+  std::vector<long long> scores[2];
+  for (int k = 0; k < 2; ++k) {
+    viaevo::Random gen;
+    gen.Seed(42);
+
+    viaevo::MutatorPointRandom mutator(gen);
+
+    viaevo::ScorerMock scorer({0, 1, 2, 3, 4}, 10, {});
+
+    viaevo::EvolverAdHoc evolver("elfs/simple_small", 4, 1, 6, scorer,
+                                 mutator, gen, 2, 3);
+    evolver.set_pipelined(3);
+    evolver.set_deduplicate(true);
+
+    evolver.Run();
+
+    for (auto &program : evolver.programs()) {
+      codes[k].push_back(program->GetElfCode());
+      scores[k].push_back(program->current_score());
+    }
+  }
+
+  EXPECT_EQ(codes[0], codes[1]);
+  EXPECT_EQ(scores[0], scores[1]);
+}
+
+TEST(EvolverAdHocTest, EvaluationOrder) {
+  for (int num_threads : {0, 3}) {
+    std::vector<std::vector<char>> codes[2];
+    std::vector<long long> scores[2];
+    for (int k = 0; k < 2; ++k) {
+      viaevo::Random gen;
+      gen.Seed(42);
+
+      viaevo::MutatorPointRandom mutator(gen);
+
+      viaevo::ScorerMock scorer({0, 1, 2, 3, 4}, 10, {3, 5});
+
+      viaevo::EvolverAdHoc evolver("elfs/simple_small", 4, 1, 6, scorer,
+                                   mutator, gen, 3, 3);
+      if (num_threads > 0)
+        evolver.set_pipelined(num_threads);
+      evolver.set_deduplicate(true);
+      evolver.set_evaluation_order(k == 0
+                                       ? viaevo::EvolverAdHoc::kInputsMajor
+                                       : viaevo::EvolverAdHoc::kProgramsMajor);
+
+      evolver.Run();
+
+      for (auto &program : evolver.programs()) {
+        codes[k].push_back(program->GetElfCode());
+        scores[k].push_back(program->current_score());
+      }
+    }
+
+    // The programs are scored in the same order.
+    EXPECT_EQ(codes[0], codes[1]);
+    EXPECT_EQ(scores[0], scores[1]);
+  }
+}
+
+TEST(EvolverAdHocTest, PipelinedBatchedKeepsParents) {
+  std::shared_ptr<viaevo::Program> elf =
+      viaevo::Program::Create("elfs/simple_small");
+  std::vector<char> elf_code = elf->GetElfCode();
+  std::vector<int> elf_inputs = elf->GetElfInputs();
+
+  viaevo::Random gen;
+  gen.Seed(42);
+  MutatorCopyRereading mutator;
+  viaevo::ScorerMock scorer({0, 1, 2, 3, 4}, 10, {3, 5});
+
+  // The parents are executed on the worker threads while the offspring are
+  // created from them.
+  viaevo::EvolverAdHoc evolver("elfs/simple_small", 8, 1, 8, scorer, mutator,
+                               gen, 4, 50);
+  evolver.set_pipelined(8);
+  evolver.set_evaluation_order(viaevo::EvolverAdHoc::kProgramsMajorBatched);
+
+  evolver.Run();
+
+  EXPECT_EQ(mutator.inconsistent_reads, 0);
+  for (auto &program : evolver.programs()) {
+    EXPECT_EQ(program->GetElfCode(), elf_code);
+    EXPECT_EQ(program->GetElfInputs(), elf_inputs)
+        << "ExecuteBatch should not change the inputs of the ELF";
+  }
+}
+
+TEST(EvolverAdHocTest, MutationOutcomes) {
+  viaevo::RandomMock gen({7, 17});
+
+  MutatorRecordingOutcomes mutator(gen);
+
+  viaevo::ScorerMock scorer({0, 0, 5}, 10, {});
+
+  viaevo::EvolverAdHoc evolver("elfs/simple_small", 2, 1, 1, scorer, mutator,
+                               gen, 1, 2);
+
+  evolver.Run();
+
+  // The offspring of the first generation scored 5 (its parent 0) and was
+  // selected as a parent for the second generation. The outcomes of the
+  // offspring of the last generation are not reported.
+  ASSERT_EQ(mutator.updates.size(), 1);
+  ASSERT_EQ(mutator.updates[0].size(), 1);
+  EXPECT_TRUE(mutator.updates[0][0].survived);
+  EXPECT_TRUE(mutator.updates[0][0].improved);
+  auto &programs = evolver.programs();
+  EXPECT_TRUE(mutator.updates[0][0].target == programs[0] ||
+              mutator.updates[0][0].target == programs[1]);
+  ASSERT_NE(mutator.updates[0][0].parent1, nullptr);
+  EXPECT_NE(mutator.updates[0][0].parent1, mutator.updates[0][0].target);
+}
+
+TEST(EvolverAdHocTest, Prescreen) {
+  viaevo::RandomMock gen({7, 17});
+
+  // hlt (privileged) and 0x06 (undecodable) are rejected, nop is accepted.
+  MutatorFirstByte mutator({(char)0xf4, 0x06, (char)0x90});
+
+  viaevo::ScorerMock scorer({0, 0, 5}, 10, {});
+
+  viaevo::EvolverAdHoc evolver("elfs/simple_small", 2, 1, 2, scorer, mutator,
+                               gen, 1, 1);
+  evolver.set_prescreen(true, 1);
+
+  evolver.Run();
+
+  // The first offspring is re-mutated once and kept after the second rejection,
+  // the second offspring is accepted.
+  EXPECT_EQ(mutator.calls, 3);
+  EXPECT_EQ(evolver.generation_prescreen_checks(), 3);
+  EXPECT_EQ(evolver.generation_prescreen_rejections(), 2);
+  const std::vector<long long> &counts = evolver.prescreen_verdict_counts();
+  EXPECT_EQ(counts[viaevo::CodePrescreen::kAccept], 1);
+  EXPECT_EQ(counts[viaevo::CodePrescreen::kPrivileged], 1);
+  EXPECT_EQ(counts[viaevo::CodePrescreen::kUndecodable], 1);
+}
+
+TEST(EvolverAdHocTest, BatchMutation) {
+  std::vector<std::vector<char>> codes[2];
+  for (int k = 0; k < 2; ++k) {
+    viaevo::Random gen;
+    gen.Seed(42);
+
+    viaevo::MutatorPointRandom mutator(gen);
+
+    viaevo::ScorerMock scorer({0, 1, 2, 3, 4}, 10, {});
+
+    viaevo::EvolverAdHoc evolver("elfs/simple_small", 4, 1, 6, scorer,
+                                 mutator, gen, 1, 3);
+    // The same evolution with and without threads.
+    evolver.set_batch_mutation(true, 7, k == 0 ? 1 : 3);
+
+    evolver.Run();
+
+    auto &programs = evolver.programs();
+    for (auto &program : programs)
+      codes[k].push_back(program->GetElfCode());
+    // The offspring of the last generation differ from a parent by a bit flip.
+    for (int i = 4; i < 10; ++i) {
+      int min_distance = 1 << 30;
+      for (int j = 0; j < 4; ++j) {
+        int distance = 0;
+        for (size_t b = 0; b < codes[k][i].size(); ++b)
+          distance += __builtin_popcount(
+              (unsigned char)(codes[k][i][b] ^ codes[k][j][b]));
+        min_distance = std::min(min_distance, distance);
+      }
+      EXPECT_EQ(min_distance, 1);
+    }
+  }
+
+  EXPECT_EQ(codes[0], codes[1]);
+}
+
+TEST(EvolverAdHocTest, Coverage) {
+  viaevo::Random gen;
+  gen.Seed(42);
+
+  viaevo::MutatorPointRandom mutator(gen);
+
+  viaevo::ScorerMock scorer({0, 1, 2, 3, 4}, 10, {});
+
+  viaevo::EvolverAdHoc evolver("elfs/simple_small", 2, 1, 3, scorer, mutator,
+                               gen, 2, 2);
+  evolver.set_coverage(true);
+
+  evolver.Run();
+
+  // All programs are traced in their first execution.
+  for (auto &program : evolver.programs()) {
+    EXPECT_TRUE(program->has_coverage());
+    EXPECT_EQ(program->coverage_executions(), 0);
+  }
+}
+
+TEST(EvolverAdHocTest, ScoreEmptyResults) {
+  viaevo::Random gen;
+  viaevo::MutatorPointRandom mutator(gen);
+  // The mock ignores the results, the scores tell which rows were scored.
+  viaevo::ScorerMock scorer({5, 7}, 10, {});
+  EvolverAdHocScoring evolver("elfs/simple_small", 2, 0, 1, scorer, mutator,
+                              gen, 1, 1);
+
+  std::vector<int> results(11, -1);
+  // Row 1 (e.g. a program that failed to execute) is not passed to the scorer
+  // and scores 0.
+  evolver.Score({results, {}, results});
+  auto &programs = evolver.programs();
+  EXPECT_EQ(programs[0]->current_score(), 5);
+  EXPECT_EQ(programs[1]->current_score(), 0);
+  EXPECT_EQ(programs[2]->current_score(), 7);
+}
+
+TEST(EvolverAdHocTest, Determinism) {
+  for (bool deterministic_execution : {false, true}) {
+    viaevo::Random gen;
+    gen.Seed(42);
+
+    // rdtsc; test eax, 0x100; jz . + 4; ud2; ud2 (see
+    // ProgramTest.DeterministicExecution).
+    MutatorCode mutator(std::string(
+        "\x0f\x31\xa9\x00\x01\x00\x00\x74\x02\x0f\x0b\x0f\x0b", 13));
+
+    viaevo::ScorerMock scorer({0, 1, 2, 3, 4}, 10, {});
+
+    viaevo::EvolverAdHoc evolver("elfs/simple_small", 2, 1, 2, scorer, mutator,
+                                 gen, 1, 1);
+    evolver.set_deduplicate(true);
+    evolver.set_determinism(deterministic_execution, 4, 20);
+
+    evolver.Run();
+
+    // A parent and an offspring are executed (the other parent and offspring
+    // are duplicates) and checked.
+    EXPECT_EQ(evolver.generation_duplicates(), 2);
+    EXPECT_EQ(evolver.generation_determinism_checks(), 2);
+    // The offspring reads the time stamp counter.
+    EXPECT_EQ(evolver.generation_nondeterministic(),
+              deterministic_execution ? 0 : 1);
+    int nondeterministic = 0;
+    for (auto &program : evolver.programs())
+      nondeterministic += program->nondeterministic();
+    EXPECT_EQ(nondeterministic, deterministic_execution ? 0 : 1);
+  }
+}
+
 } // namespace
@@ -0,0 +1,31 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_EVOLVER_FIDELITY_SCHEDULE_H_
+#define VIAEVO_EVOLVER_FIDELITY_SCHEDULE_H_
+
+namespace viaevo {
+
+// FidelitySchedule is an abstract base class defining the interface to
+// determine the number of evaluations (with different inputs) performed on each
+// program in a generation. Early generations may not need the full number of
+// evaluations (e.g. when almost no program computes a valid result yet) and
+// the number of evaluations can grow over generations or as the best score
+// approaches the maximum score.
+class FidelitySchedule {
+public:
+  virtual ~FidelitySchedule() = default;
+  // Returns the number of evaluations per program for generation (starting at
+  // 1). best_score_fraction is the best score per evaluation observed so far
+  // divided by Scorer's MaxScore (results history scores are not included) and
+  // should be between 0.0 and 1.0. The returned value is clamped by the
+  // Evolver between 1 and the Evolver's evaluations_per_program.
+  virtual int EvaluationsPerProgram(int generation,
+                                    double best_score_fraction) const = 0;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_EVOLVER_FIDELITY_SCHEDULE_H_
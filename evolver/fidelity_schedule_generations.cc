@@ -0,0 +1,35 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "fidelity_schedule_generations.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace viaevo {
+
+FidelityScheduleGenerations::FidelityScheduleGenerations(int min_evaluations,
+                                                         int max_evaluations,
+                                                         int ramp_generations,
+                                                         double exponent)
+    : min_evaluations_(min_evaluations), max_evaluations_(max_evaluations),
+      ramp_generations_(ramp_generations), exponent_(exponent) {
+  assert(min_evaluations_ >= 1 && min_evaluations_ <= max_evaluations_ &&
+         "min_evaluations should be between 1 and max_evaluations");
+  assert(ramp_generations_ >= 1 && "ramp_generations should be at least 1");
+}
+
+int FidelityScheduleGenerations::EvaluationsPerProgram(
+    int generation, double best_score_fraction) const {
+  double t = std::min(1.0, std::max(0.0, (generation - 1) /
+                                             (double)ramp_generations_));
+  return min_evaluations_ +
+         (int)std::lround((max_evaluations_ - min_evaluations_) *
+                          std::pow(t, exponent_));
+}
+
+} // namespace viaevo
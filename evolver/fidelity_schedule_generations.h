@@ -0,0 +1,39 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_EVOLVER_FIDELITY_SCHEDULE_GENERATIONS_H_
+#define VIAEVO_EVOLVER_FIDELITY_SCHEDULE_GENERATIONS_H_
+
+#include "fidelity_schedule.h"
+
+namespace viaevo {
+
+// FidelityScheduleGenerations grows the number of evaluations per program from
+// min_evaluations to max_evaluations over ramp_generations generations. The
+// growth follows the curve min + (max - min) * t^exponent where t is the
+// fraction of ramp_generations completed (t = 0.0 in the first generation).
+// best_score_fraction is ignored.
+class FidelityScheduleGenerations : public FidelitySchedule {
+public:
+  FidelityScheduleGenerations(int min_evaluations, int max_evaluations,
+                              int ramp_generations, double exponent = 1.0);
+  // Returns the number of evaluations per program based on the description
+  // above.
+  virtual int EvaluationsPerProgram(int generation,
+                                    double best_score_fraction) const override;
+
+protected:
+  int min_evaluations_ = 1;
+  int max_evaluations_ = 1;
+  // Number of generations to reach max_evaluations_.
+  int ramp_generations_ = 1;
+  // Exponent of the growth curve (1.0 is linear growth, values larger than 1.0
+  // keep the number of evaluations low for longer).
+  double exponent_ = 1.0;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_EVOLVER_FIDELITY_SCHEDULE_GENERATIONS_H_
@@ -0,0 +1,36 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "fidelity_schedule_generations.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(FidelityScheduleGenerationsTest, EvaluationsPerProgram) {
+  viaevo::FidelityScheduleGenerations schedule(20, 200, 10);
+
+  // The first generation starts at min_evaluations.
+  EXPECT_EQ(schedule.EvaluationsPerProgram(1, 0.0), 20);
+  EXPECT_EQ(schedule.EvaluationsPerProgram(2, 0.0), 38);
+  EXPECT_EQ(schedule.EvaluationsPerProgram(6, 0.0), 110);
+  EXPECT_EQ(schedule.EvaluationsPerProgram(11, 0.0), 200);
+  // max_evaluations is not exceeded after ramp_generations.
+  EXPECT_EQ(schedule.EvaluationsPerProgram(1000, 0.0), 200);
+  // best_score_fraction is ignored.
+  EXPECT_EQ(schedule.EvaluationsPerProgram(1, 1.0), 20);
+
+  viaevo::FidelityScheduleGenerations schedule_quadratic(20, 200, 10, 2.0);
+  EXPECT_EQ(schedule_quadratic.EvaluationsPerProgram(1, 0.0), 20);
+  EXPECT_EQ(schedule_quadratic.EvaluationsPerProgram(6, 0.0), 65);
+  EXPECT_EQ(schedule_quadratic.EvaluationsPerProgram(11, 0.0), 200);
+
+  EXPECT_DEATH(viaevo::FidelityScheduleGenerations(0, 200, 10),
+               "min_evaluations should be between");
+  EXPECT_DEATH(viaevo::FidelityScheduleGenerations(20, 200, 0),
+               "ramp_generations should be at least 1");
+}
+
+} // namespace
@@ -0,0 +1,32 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "fidelity_schedule_score.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace viaevo {
+
+FidelityScheduleScore::FidelityScheduleScore(int min_evaluations,
+                                             int max_evaluations,
+                                             double exponent)
+    : min_evaluations_(min_evaluations), max_evaluations_(max_evaluations),
+      exponent_(exponent) {
+  assert(min_evaluations_ >= 1 && min_evaluations_ <= max_evaluations_ &&
+         "min_evaluations should be between 1 and max_evaluations");
+}
+
+int FidelityScheduleScore::EvaluationsPerProgram(
+    int generation, double best_score_fraction) const {
+  double f = std::min(1.0, std::max(0.0, best_score_fraction));
+  return min_evaluations_ +
+         (int)std::lround((max_evaluations_ - min_evaluations_) *
+                          std::pow(f, exponent_));
+}
+
+} // namespace viaevo
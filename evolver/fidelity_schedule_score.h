@@ -0,0 +1,37 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_EVOLVER_FIDELITY_SCHEDULE_SCORE_H_
+#define VIAEVO_EVOLVER_FIDELITY_SCHEDULE_SCORE_H_
+
+#include "fidelity_schedule.h"
+
+namespace viaevo {
+
+// FidelityScheduleScore grows the number of evaluations per program from
+// min_evaluations to max_evaluations as the best score approaches the maximum
+// score. The growth follows the curve min + (max - min) * f^exponent where f
+// is best_score_fraction. The generation is ignored.
+class FidelityScheduleScore : public FidelitySchedule {
+public:
+  FidelityScheduleScore(int min_evaluations, int max_evaluations,
+                        double exponent = 1.0);
+  // Returns the number of evaluations per program based on the description
+  // above.
+  virtual int EvaluationsPerProgram(int generation,
+                                    double best_score_fraction) const override;
+
+protected:
+  int min_evaluations_ = 1;
+  int max_evaluations_ = 1;
+  // Exponent of the growth curve (1.0 is linear growth, values larger than 1.0
+  // keep the number of evaluations low until the best score gets close to the
+  // maximum score).
+  double exponent_ = 1.0;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_EVOLVER_FIDELITY_SCHEDULE_SCORE_H_
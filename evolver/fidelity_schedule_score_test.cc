@@ -0,0 +1,31 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "fidelity_schedule_score.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(FidelityScheduleScoreTest, EvaluationsPerProgram) {
+  viaevo::FidelityScheduleScore schedule(20, 200);
+
+  EXPECT_EQ(schedule.EvaluationsPerProgram(1, 0.0), 20);
+  EXPECT_EQ(schedule.EvaluationsPerProgram(1, 0.5), 110);
+  EXPECT_EQ(schedule.EvaluationsPerProgram(1, 1.0), 200);
+  // best_score_fraction is clamped between 0.0 and 1.0.
+  EXPECT_EQ(schedule.EvaluationsPerProgram(1, -1.0), 20);
+  EXPECT_EQ(schedule.EvaluationsPerProgram(1, 2.0), 200);
+  // The generation is ignored.
+  EXPECT_EQ(schedule.EvaluationsPerProgram(1000, 0.0), 20);
+
+  viaevo::FidelityScheduleScore schedule_quadratic(20, 200, 2.0);
+  EXPECT_EQ(schedule_quadratic.EvaluationsPerProgram(1, 0.5), 65);
+
+  EXPECT_DEATH(viaevo::FidelityScheduleScore(300, 200),
+               "min_evaluations should be between");
+}
+
+} // namespace
@@ -0,0 +1,35 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "genome_index.h"
+
+namespace viaevo {
+
+unsigned long long GenomeIndex::Hash(const std::vector<char> &code) {
+  unsigned long long hash = 14695981039346656037ULL;
+  for (char c : code) {
+    hash ^= (unsigned char)c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+int GenomeIndex::FindOrAdd(const std::vector<char> &code, int index) {
+  std::vector<int> &bucket = buckets_[Hash(code)];
+  for (int other : bucket) {
+    if (codes_[other] == code)
+      return other;
+  }
+  bucket.push_back(index);
+  codes_[index] = code;
+  return -1;
+}
+
+void GenomeIndex::Clear() {
+  buckets_.clear();
+  codes_.clear();
+}
+
+} // namespace viaevo
@@ -0,0 +1,36 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_EVOLVER_GENOME_INDEX_H_
+#define VIAEVO_EVOLVER_GENOME_INDEX_H_
+
+#include <unordered_map>
+#include <vector>
+
+namespace viaevo {
+
+// GenomeIndex finds programs with identical code (evolvable code) by hashing
+// the code (64-bit FNV-1a) and comparing codes with the same hash.
+class GenomeIndex {
+public:
+  // Returns the 64-bit FNV-1a hash of code.
+  static unsigned long long Hash(const std::vector<char> &code);
+
+  // Returns the index of a previously added program with code identical to
+  // code. Otherwise adds code with index and returns -1.
+  int FindOrAdd(const std::vector<char> &code, int index);
+  // Removes all added codes.
+  void Clear();
+
+protected:
+  // Map hashes to indices of added programs.
+  std::unordered_map<unsigned long long, std::vector<int>> buckets_;
+  // Map indices of added programs to their code.
+  std::unordered_map<int, std::vector<char>> codes_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_EVOLVER_GENOME_INDEX_H_
@@ -0,0 +1,32 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "genome_index.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(GenomeIndexTest, FindOrAdd) {
+  viaevo::GenomeIndex index;
+
+  EXPECT_EQ(index.FindOrAdd({'\x90', '\x90'}, 0), -1);
+  EXPECT_EQ(index.FindOrAdd({'\x90', '\xc3'}, 1), -1);
+  EXPECT_EQ(index.FindOrAdd({'\x90', '\x90'}, 2), 0);
+  EXPECT_EQ(index.FindOrAdd({'\x90', '\xc3'}, 3), 1);
+  EXPECT_EQ(index.FindOrAdd({}, 4), -1);
+  EXPECT_EQ(index.FindOrAdd({}, 5), 4);
+
+  index.Clear();
+  EXPECT_EQ(index.FindOrAdd({'\x90', '\x90'}, 2), -1);
+}
+
+TEST(GenomeIndexTest, Hash) {
+  // Reference values of 64-bit FNV-1a.
+  EXPECT_EQ(viaevo::GenomeIndex::Hash({}), 0xcbf29ce484222325ULL);
+  EXPECT_EQ(viaevo::GenomeIndex::Hash({'a'}), 0xaf63dc4c8601ec8cULL);
+}
+
+} // namespace
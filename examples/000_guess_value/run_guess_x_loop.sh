@@ -10,12 +10,13 @@ fi
 
 VALUE_TO_GUESS=$1
 ITERATIONS=$2
+PREFIX="simple_small_guess_${VALUE_TO_GUESS}_"
 
 echo "value to guess: $VALUE_TO_GUESS iterations: $ITERATIONS"
+echo "output file prefix: $PREFIX"
 
-for i in $(seq $ITERATIONS); do
-  echo "iteration $i of $ITERATIONS"
-  sh examples/000_guess_value/run_guess_x.sh $VALUE_TO_GUESS $i
-done
+# All iterations (trials) run concurrently in a single process, each trial
+# writes its own ${PREFIX}rs_<seed>.log file.
+(time bazel run //examples/trials:viaevo_trials -- --task=guess_value --value_to_guess=$VALUE_TO_GUESS --num_trials=$ITERATIONS --output_filename_prefix="$(pwd)/${PREFIX}") |& tee ${PREFIX}trials.log
 
 exit
@@ -7,14 +7,19 @@
 
 #include <assert.h>
 
+// TODO: Remove relative path.
+#include "../../scorer/score_kernels.h"
+
 namespace viaevo {
 
 ScorerGuessValue::ScorerGuessValue(int value) : value_(value) {
   assert(value_ != -1 && "Value should not be -1.");
+  ResetInputs();
 }
 
-long long ScorerGuessValue::Score(const Program &program) const {
-  const std::vector<int> &results = program.last_results();
+long long ScorerGuessValue::ScoreResults(const int *results,
+                                         size_t results_size,
+                                         const InputSet &input_set) const {
   long long score = 0;
 
   // value_ is expected in results[1]. If results[1] is unchanged, at least
@@ -27,12 +32,7 @@ long long ScorerGuessValue::Score(const Program &program) const {
   if (results[1] == -1) {
     // results[0] is disregarded as it is changed in main of //elfs:simple_small
     // from 10 to 20.
-    for (int i = 2; i < 11; ++i) {
-      if (results[i] != -1) {
-        ++score;
-      }
-    }
-    return score;
+    return CountNotEqual(results + 2, 9, -1);
   }
 
   // Reaching this path means results[1] changed. Start with a score that is
@@ -42,13 +42,7 @@ long long ScorerGuessValue::Score(const Program &program) const {
   score = 20;
 
   // Increment the score for each correctly set bit in results[1].
-  unsigned int matching_bits = ~(results[1] ^ value_);
-  while (matching_bits) {
-    if (matching_bits & 1) {
-      ++score;
-    }
-    matching_bits >>= 1;
-  }
+  score += MatchingBits(results[1], input_set.expected_values[0]);
 
   return score;
 }
@@ -59,6 +53,9 @@ long long ScorerGuessValue::MaxScore() const {
   return 52;
 }
 
-void ScorerGuessValue::ResetInputs() {}
+void ScorerGuessValue::GenerateInputSet(InputSet &input_set) {
+  // No inputs, value_ is expected in results[1].
+  input_set.expected_values = {value_};
+}
 
 } // namespace viaevo
\ No newline at end of file
@@ -20,17 +20,19 @@ namespace viaevo {
 class ScorerGuessValue : public Scorer {
 public:
   explicit ScorerGuessValue(int value);
-  // Returns score for a specific Program.
-  virtual long long Score(const Program &program) const override;
+  // Returns score for results of a Program executed on input_set's inputs.
+  virtual long long ScoreResults(const int *results, size_t results_size,
+                                 const InputSet &input_set) const override;
   // Returns maximum possible score for "perfect" results. Should not depend on
-  // current_inputs_.
+  // the inputs.
   virtual long long MaxScore() const override;
-  // Does nothing for this scorer.
-  virtual void ResetInputs() override;
 
   int value() { return value_; }
 
 protected:
+  // Sets value_ as the expected value (there are no inputs).
+  virtual void GenerateInputSet(InputSet &input_set) override;
+
   // Value to guess. Value MAY NOT be -1 for the scorer to work correctly.
   int value_ = -1;
 };
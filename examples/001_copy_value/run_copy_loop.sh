@@ -10,12 +10,13 @@ fi
 
 NUM_COPIES=$1
 ITERATIONS=$2
+PREFIX="simple_small_copy_n${NUM_COPIES}_"
 
 echo "num value copies in inputs: $NUM_COPIES iterations: $ITERATIONS"
+echo "output file prefix: $PREFIX"
 
-for i in $(seq $ITERATIONS); do
-  echo "iteration $i of $ITERATIONS"
-  sh examples/001_copy_value/run_copy.sh $NUM_COPIES $i
-done
+# All iterations (trials) run concurrently in a single process, each trial
+# writes its own ${PREFIX}rs_<seed>.log file.
+(time bazel run //examples/trials:viaevo_trials -- --task=copy_value --num_value_copies_in_inputs=$NUM_COPIES --num_trials=$ITERATIONS --output_filename_prefix="$(pwd)/${PREFIX}") |& tee ${PREFIX}trials.log
 
 exit
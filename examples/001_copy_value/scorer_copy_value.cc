@@ -7,32 +7,32 @@
 
 #include <assert.h>
 
+// TODO: Remove relative path.
+#include "../../scorer/score_kernels.h"
+
 namespace viaevo {
 
 ScorerCopyValue::ScorerCopyValue(Random &gen,
                                  int number_of_copies_in_current_inputs)
     : gen_(gen),
       number_of_copies_in_current_inputs_(number_of_copies_in_current_inputs) {
-  current_inputs_ = std::vector<int>(number_of_copies_in_current_inputs_, 0);
   ResetInputs();
 }
 
-long long ScorerCopyValue::Score(const Program &program) const {
-  const std::vector<int> &results = program.last_results();
+long long ScorerCopyValue::ScoreResults(const int *results,
+                                        size_t results_size,
+                                        const InputSet &input_set) const {
+  int expected_value = input_set.expected_values[0];
   long long score = 0;
 
-  // If any of the results exactly matches current_inputs_[0], increase the
-  // score significantly. The assumption being that if current_inputs_[0] is
+  // If any of the results exactly matches inputs[0], increase the
+  // score significantly. The assumption being that if inputs[0] is
   // copied to any of the results, it should be easier to learn to copy it to
   // results[1].
-  for (std::vector<int>::size_type i = 0; i < results.size(); ++i) {
-    if (results[i] == current_inputs_[0]) {
-      score += 60;
-      break;
-    }
-  }
+  if (AnyEquals(results, results_size, expected_value))
+    score += 60;
 
-  // current_inputs_[0] is expected in results[1]. If results[1] is unchanged,
+  // inputs[0] is expected in results[1]. If results[1] is unchanged,
   // at least score changes in other elements of results. The assumption is that
   // a change in one of the others is better that no change and a change in
   // multiple is better than a change in one. It is also assumed that a change
@@ -42,11 +42,7 @@ long long ScorerCopyValue::Score(const Program &program) const {
   if (results[1] == -1) {
     // results[0] is disregarded as it is changed in main of //elfs:simple_small
     // from 10 to 20.
-    for (int i = 2; i < 11; ++i) {
-      if (results[i] != -1) {
-        ++score;
-      }
-    }
+    score += CountNotEqual(results + 2, 9, -1);
     return score;
   }
 
@@ -54,18 +50,12 @@ long long ScorerCopyValue::Score(const Program &program) const {
   // higher than the maximum possible score from the path above. The assumption
   // is that changing results[1] alone is better that changing any other (or
   // all other) elements in results.
-  // TODO: Maybe still want to score if current_inputs_[0] is copied to
+  // TODO: Maybe still want to score if inputs[0] is copied to
   // results[1] and not disregard it in this case?
   score += 20;
 
   // Increment the score for each correctly set bit in results[1].
-  unsigned int matching_bits = ~(results[1] ^ current_inputs_[0]);
-  while (matching_bits) {
-    if (matching_bits & 1) {
-      ++score;
-    }
-    matching_bits >>= 1;
-  }
+  score += MatchingBits(results[1], expected_value);
 
   return score;
 }
@@ -77,15 +67,14 @@ long long ScorerCopyValue::MaxScore() const {
   return 112;
 }
 
-void ScorerCopyValue::ResetInputs() {
-  current_inputs_[0] = gen_();
+void ScorerCopyValue::GenerateInputSet(InputSet &input_set) {
+  int value = gen_();
   // Avoid -1 as the scorer does not work correctly in this case.
-  while (current_inputs_[0] == -1) {
-    current_inputs_[0] = gen_();
-  }
-  for (int i = 1; i < number_of_copies_in_current_inputs_; ++i) {
-    current_inputs_[i] = current_inputs_[0];
+  while (value == -1) {
+    value = gen_();
   }
+  input_set.inputs.assign(number_of_copies_in_current_inputs_, value);
+  input_set.expected_values = {value};
 }
 
 } // namespace viaevo
\ No newline at end of file
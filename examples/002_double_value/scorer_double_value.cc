@@ -7,32 +7,32 @@
 
 #include <assert.h>
 
+// TODO: Remove relative path.
+#include "../../scorer/score_kernels.h"
+
 namespace viaevo {
 
 ScorerDoubleValue::ScorerDoubleValue(Random &gen,
                                      int number_of_copies_in_current_inputs)
     : gen_(gen),
       number_of_copies_in_current_inputs_(number_of_copies_in_current_inputs) {
-  current_inputs_ = std::vector<int>(number_of_copies_in_current_inputs_, 0);
   ResetInputs();
 }
 
-long long ScorerDoubleValue::Score(const Program &program) const {
-  const std::vector<int> &results = program.last_results();
+long long ScorerDoubleValue::ScoreResults(const int *results,
+                                          size_t results_size,
+                                          const InputSet &input_set) const {
+  int expected_value = input_set.expected_values[0];
   long long score = 0;
 
-  // If any of the results exactly matches 2 * current_inputs_[0], increase the
-  // score significantly. The assumption being that if 2 * current_inputs_[0]
+  // If any of the results exactly matches 2 * inputs[0], increase the
+  // score significantly. The assumption being that if 2 * inputs[0]
   // ends up in any of the results, it should be easier to learn to make it end
   // up in results[1].
-  for (std::vector<int>::size_type i = 0; i < results.size(); ++i) {
-    if (results[i] == expected_value_) {
-      score += 60;
-      break;
-    }
-  }
+  if (AnyEquals(results, results_size, expected_value))
+    score += 60;
 
-  // current_inputs_[0] is expected in results[1]. If results[1] is unchanged,
+  // inputs[0] is expected in results[1]. If results[1] is unchanged,
   // at least score changes in other elements of results. The assumption is that
   // a change in one of the others is better that no change and a change in
   // multiple is better than a change in one. It is also assumed that a change
@@ -42,11 +42,7 @@ long long ScorerDoubleValue::Score(const Program &program) const {
   if (results[1] == -1) {
     // results[0] is disregarded as it is changed in main of //elfs:simple_small
     // from 10 to 20.
-    for (int i = 2; i < 11; ++i) {
-      if (results[i] != -1) {
-        ++score;
-      }
-    }
+    score += CountNotEqual(results + 2, 9, -1);
 
     return score;
   }
@@ -58,13 +54,7 @@ long long ScorerDoubleValue::Score(const Program &program) const {
   score += 20;
 
   // Increment the score for each correctly set bit in results[1].
-  unsigned int matching_bits = ~(results[1] ^ expected_value_);
-  while (matching_bits) {
-    if (matching_bits & 1) {
-      ++score;
-    }
-    matching_bits >>= 1;
-  }
+  score += MatchingBits(results[1], expected_value);
 
   return score;
 }
@@ -73,13 +63,13 @@ long long ScorerDoubleValue::Score(const Program &program) const {
 //   const std::vector<int> &results = program.last_results();
 
 //   // The highest possible score for a correct result.
-//   if (results[1] == expected_value_) {
+//   if (results[1] == expected value) {
 //     return 1'000'000'000'000;
 //   }
 
 //   // Second highest score if any of the results has the correct score.
 //   for (std::vector<int>::size_type i = 0; i < results.size(); ++i) {
-//     if (results[i] == expected_value_) {
+//     if (results[i] == expected value) {
 //       return 1'000'000'000;
 //     }
 //   }
@@ -124,18 +114,15 @@ long long ScorerDoubleValue::MaxScore() const {
   // return 1'000'000'000'000;
 }
 
-void ScorerDoubleValue::ResetInputs() {
-  current_inputs_[0] = gen_();
+void ScorerDoubleValue::GenerateInputSet(InputSet &input_set) {
+  int value = gen_();
   // Avoid -1 as the scorer does not work correctly in this case. Also prevent
   // overflow or underfow when multiplied by 2.
-  while (current_inputs_[0] == -1 || current_inputs_[0] < -1'000'000'000 ||
-         current_inputs_[0] > 1'000'000'000) {
-    current_inputs_[0] = gen_();
-  }
-  for (int i = 1; i < number_of_copies_in_current_inputs_; ++i) {
-    current_inputs_[i] = current_inputs_[0];
+  while (value == -1 || value < -1'000'000'000 || value > 1'000'000'000) {
+    value = gen_();
   }
-  expected_value_ = 2 * current_inputs_[0];
+  input_set.inputs.assign(number_of_copies_in_current_inputs_, value);
+  input_set.expected_values = {2 * value};
 }
 
 } // namespace viaevo
\ No newline at end of file
@@ -14,32 +14,33 @@
 
 namespace viaevo {
 
-// ScorerDoubleValue expects the value of 2 * current_inputs_[0] in Program's
+// ScorerDoubleValue expects the value of 2 * inputs[0] in Program's
 // results[1]. The value may not be 0 for the scorer to work correctly.
 class ScorerDoubleValue : public Scorer {
 public:
   explicit ScorerDoubleValue(Random &gen,
                              int number_of_copies_in_current_inputs);
-  // Returns score for a specific Program.
-  virtual long long Score(const Program &program) const override;
+  // Returns score for results of a Program executed on input_set's inputs.
+  virtual long long ScoreResults(const int *results, size_t results_size,
+                                 const InputSet &input_set) const override;
   // Returns maximum possible score for "perfect" results. Should be the same
-  // for different values of current_inputs_[0].
+  // for different values of inputs[0].
   virtual long long MaxScore() const override;
-  // Initializes new value(s) for current_inputs_.
-  virtual void ResetInputs() override;
 
-  int expected_value() { return expected_value_; }
+  int expected_value() const {
+    return current_input_set_->expected_values[0];
+  }
 
 protected:
+  // Generates new value(s) for the inputs and the expected value.
+  virtual void GenerateInputSet(InputSet &input_set) override;
+
   // Random number generator.
   Random &gen_;
-  // Number of copies of the value of interest in current_inputs_. The
+  // Number of copies of the value of interest in the inputs. The
   // assumptions is that multiple copies of the value in inputs will make it
   // easier to evolve the Program to copy one of these values to results.
   int number_of_copies_in_current_inputs_ = 1;
-  // expected_value_ holds the value expected in results[1]. In this case, it is
-  // 2 * current_inputs_[0].
-  int expected_value_ = 0;
 };
 
 } // namespace viaevo
@@ -7,7 +7,7 @@
 
 // TODO: Remove relative paths.
 #include "../../evolver/evolver_adhoc.h"
-#include "../../mutator/mutator_composite_random.h"
+#include "../../mutator/mutator_composite_weighted.h"
 #include "../../mutator/mutator_point_last_instruction.h"
 #include "../../mutator/mutator_point_random.h"
 #include "../../mutator/mutator_recombine_random.h"
@@ -30,16 +30,11 @@ int main() {
       mutator_last_instruction =
           std::make_shared<viaevo::MutatorPointLastInstruction>(gen);
 
-  viaevo::MutatorCompositeRandom mutator_composite(gen);
-  mutator_composite.AppendMutator(mutator_point);
-  mutator_composite.AppendMutator(mutator_recombine);
-  mutator_composite.AppendMutator(mutator_recombine_plain_elf);
-  // Naive "implementation of a weighted random composite mutator - just append
-  // a mutator mutiple times."
-  // TODO: Implement a weighted random composite mutator.
-  for (int i = 0; i < 7; ++i) {
-    mutator_composite.AppendMutator(mutator_last_instruction);
-  }
+  viaevo::MutatorCompositeWeighted mutator_composite(gen);
+  mutator_composite.AppendMutator(mutator_point, 1.0);
+  mutator_composite.AppendMutator(mutator_recombine, 1.0);
+  mutator_composite.AppendMutator(mutator_recombine_plain_elf, 1.0);
+  mutator_composite.AppendMutator(mutator_last_instruction, 7.0);
 
   viaevo::ScorerSumTwo scorer(gen, 50);
 
@@ -7,32 +7,31 @@
 
 #include <assert.h>
 
+// TODO: Remove relative path.
+#include "../../scorer/score_kernels.h"
+
 namespace viaevo {
 
 ScorerSumTwo::ScorerSumTwo(Random &gen, int number_of_copies_in_current_inputs)
     : gen_(gen),
       number_of_copies_in_current_inputs_(number_of_copies_in_current_inputs) {
-  current_inputs_ =
-      std::vector<int>(2 * number_of_copies_in_current_inputs_, 0);
   ResetInputs();
 }
 
-long long ScorerSumTwo::Score(const Program &program) const {
-  const std::vector<int> &results = program.last_results();
+long long ScorerSumTwo::ScoreResults(const int *results,
+                                     size_t results_size,
+                                     const InputSet &input_set) const {
+  int expected_value = input_set.expected_values[0];
   long long score = 0;
 
-  // If any of the results exactly matches the expected_value_, increase the
+  // If any of the results exactly matches the expected value, increase the
   // score significantly. The assumption being that if the expected value ends
   // up in any of the results, it should be easier to learn to make it end up in
   // results[1].
-  for (std::vector<int>::size_type i = 0; i < results.size(); ++i) {
-    if (results[i] == expected_value_) {
-      score += 60;
-      break;
-    }
-  }
+  if (AnyEquals(results, results_size, expected_value))
+    score += 60;
 
-  // The expected_value_ is expected in results[1]. If results[1] is unchanged,
+  // The expected value is expected in results[1]. If results[1] is unchanged,
   // at least score changes in other elements of results. The assumption is that
   // a change in one of the others is better that no change and a change in
   // multiple is better than a change in one. It is also assumed that a change
@@ -42,17 +41,8 @@ long long ScorerSumTwo::Score(const Program &program) const {
   if (results[1] == 0) {
     // results[0] is disregarded as it is changed in main of //elfs:simple_small
     // from 10 to 20.
-    for (int i = 2; i < 6; ++i) {
-      if (results[i] != 0) {
-        ++score;
-      }
-    }
-
-    for (int i = 6; i < 11; ++i) {
-      if (results[i] != 3) {
-        ++score;
-      }
-    }
+    score += CountNotEqual(results + 2, 4, 0);
+    score += CountNotEqual(results + 6, 5, 3);
 
     return score;
   }
@@ -64,13 +54,7 @@ long long ScorerSumTwo::Score(const Program &program) const {
   score += 20;
 
   // Increment the score for each correctly set bit in results[1].
-  unsigned int matching_bits = ~(results[1] ^ expected_value_);
-  while (matching_bits) {
-    if (matching_bits & 1) {
-      ++score;
-    }
-    matching_bits >>= 1;
-  }
+  score += MatchingBits(results[1], expected_value);
 
   return score;
 }
@@ -82,20 +66,23 @@ long long ScorerSumTwo::MaxScore() const {
   return 112;
 }
 
-void ScorerSumTwo::ResetInputs() {
-  expected_value_ = 0;
+void ScorerSumTwo::GenerateInputSet(InputSet &input_set) {
+  std::vector<int> &inputs = input_set.inputs;
+  inputs.assign(2 * number_of_copies_in_current_inputs_, 0);
+  int expected_value = 0;
   // Avoid 0 as the scorer does not work correctly in this case. Also prevent
   // overflow or underfow when multiplied by 2.
-  while (expected_value_ == 0) {
+  while (expected_value == 0) {
     // Dividing by two as a hack to prevent overflow/underflow for the sum(?).
-    current_inputs_[0] = gen_() / 2;
-    current_inputs_[1] = gen_() / 2;
-    expected_value_ = current_inputs_[0] + current_inputs_[1];
+    inputs[0] = gen_() / 2;
+    inputs[1] = gen_() / 2;
+    expected_value = inputs[0] + inputs[1];
   }
   for (int i = 1; i < number_of_copies_in_current_inputs_; ++i) {
-    current_inputs_[2 * i] = current_inputs_[0];
-    current_inputs_[2 * i + 1] = current_inputs_[1];
+    inputs[2 * i] = inputs[0];
+    inputs[2 * i + 1] = inputs[1];
   }
+  input_set.expected_values = {expected_value};
 }
 
 } // namespace viaevo
\ No newline at end of file
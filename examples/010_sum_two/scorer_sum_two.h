@@ -14,31 +14,32 @@
 
 namespace viaevo {
 
-// ScorerSumTwo expects the value of current_inputs_[0] + current_inputs_[1] in
+// ScorerSumTwo expects the value of inputs[0] + inputs[1] in
 // Program's results[1]. The sum may not be 0 for the scorer to work correctly.
 class ScorerSumTwo : public Scorer {
 public:
   explicit ScorerSumTwo(Random &gen, int number_of_copies_in_current_inputs);
-  // Returns score for a specific Program.
-  virtual long long Score(const Program &program) const override;
+  // Returns score for results of a Program executed on input_set's inputs.
+  virtual long long ScoreResults(const int *results, size_t results_size,
+                                 const InputSet &input_set) const override;
   // Returns maximum possible score for "perfect" results. Should be the same
-  // for different values of current_inputs_[0].
+  // for different values of inputs[0].
   virtual long long MaxScore() const override;
-  // Initializes new value(s) for current_inputs_.
-  virtual void ResetInputs() override;
 
-  int expected_value() { return expected_value_; }
+  int expected_value() const {
+    return current_input_set_->expected_values[0];
+  }
 
 protected:
+  // Generates new value(s) for the inputs and the expected value.
+  virtual void GenerateInputSet(InputSet &input_set) override;
+
   // Random number generator.
   Random &gen_;
-  // Number of copies of the two values to be added in current_inputs_. The
+  // Number of copies of the two values to be added in the inputs. The
   // assumptions is that multiple copies of the values in inputs will make it
   // easier to evolve the Program to sum these values to results.
   int number_of_copies_in_current_inputs_ = 1;
-  // expected_value_ holds the value expected in results[1]. In this case, it is
-  // current_inputs_[0] + current_inputs_[1].
-  int expected_value_ = 0;
 };
 
 } // namespace viaevo
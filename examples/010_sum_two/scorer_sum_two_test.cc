@@ -5,6 +5,9 @@
 
 #include "scorer_sum_two.h"
 
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 // TODO: Remove relative path.
@@ -109,4 +112,44 @@ TEST(ScorerSumTwoTest, MaxScore) {
   EXPECT_EQ(scorer.MaxScore(), 112);
 }
 
+TEST(ScorerSumTwoTest, ScoreConcurrently) {
+  viaevo::RandomMock gen({28, 56, 10, 20});
+  viaevo::ScorerSumTwo scorer(gen, 1);
+
+  // Input sets are not affected by generating the next ones.
+  std::shared_ptr<const viaevo::InputSet> first = scorer.NextInputSet();
+  std::shared_ptr<const viaevo::InputSet> second = scorer.NextInputSet();
+  EXPECT_EQ(first->number + 1, second->number);
+  EXPECT_EQ(first->inputs, (std::vector<int>{5, 10}));
+  EXPECT_EQ(first->expected_values, std::vector<int>{15});
+  EXPECT_EQ(second->inputs, (std::vector<int>{14, 28}));
+  EXPECT_EQ(second->expected_values, std::vector<int>{42});
+
+  std::vector<int> results{20, 42, 0, 0, 0, 0, 3, 3, 3, 3, 15};
+  long long expected_first =
+      scorer.ScoreResults(results.data(), results.size(), *first);
+  long long expected_second =
+      scorer.ScoreResults(results.data(), results.size(), *second);
+  EXPECT_EQ(expected_first, 60 + 20 + 29);
+  EXPECT_EQ(expected_second, 60 + 20 + 32);
+
+  // Scoring is const and stateless, i.e. may run on multiple threads.
+  std::vector<int> mismatches(4, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      const viaevo::InputSet &input_set = t % 2 ? *second : *first;
+      long long expected = t % 2 ? expected_second : expected_first;
+      for (int i = 0; i < 10'000; ++i) {
+        if (scorer.ScoreResults(results.data(), results.size(), input_set) !=
+            expected)
+          ++mismatches[t];
+      }
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+  EXPECT_EQ(mismatches, std::vector<int>(4, 0));
+}
+
 } // namespace
@@ -13,9 +13,21 @@
 
 // TODO: Remove relative paths.
 #include "../../evolver/evolver_adhoc.h"
-#include "../../mutator/mutator_composite_random.h"
+#include "../../evolver/fidelity_schedule_generations.h"
+#include "../../evolver/fidelity_schedule_score.h"
+#include "../../mutator/mutator_composite_adaptive.h"
+#include "../../mutator/mutator_composite_weighted.h"
+#include "../../mutator/mutator_dictionary.h"
+#include "../../mutator/mutator_instruction_field.h"
+#include "../../mutator/mutator_instruction_replace.h"
+#include "../../mutator/mutator_mask_burst.h"
+#include "../../mutator/mutator_mask_poisson.h"
+#include "../../mutator/mutator_mask_window.h"
+#include "../../mutator/mutator_point_covered.h"
 #include "../../mutator/mutator_point_last_instruction.h"
 #include "../../mutator/mutator_point_random.h"
+#include "../../mutator/mutator_recombine_aligned.h"
+#include "../../mutator/mutator_recombine_covered.h"
 #include "../../mutator/mutator_recombine_plain_elf.h"
 #include "../../mutator/mutator_recombine_random.h"
 #include "../../util/random.h"
@@ -41,6 +53,87 @@ ABSL_FLAG(int32_t, lambda, 140,
 ABSL_FLAG(int32_t, evaluations_per_program, 200,
           "number of evaluations to be performed on each program in each "
           "generation (scores are accumulated across evaluations)");
+ABSL_FLAG(std::string, fidelity_schedule, "none",
+          "schedule for the number of evaluations per program in each "
+          "generation: 'none' (always evaluations_per_program), "
+          "'generations' (grow from min_evaluations_per_program to "
+          "evaluations_per_program over fidelity_ramp_generations) or 'score' "
+          "(grow from min_evaluations_per_program to evaluations_per_program "
+          "as the best score approaches the maximum score)");
+ABSL_FLAG(int32_t, min_evaluations_per_program, 20,
+          "number of evaluations per program at the start of a fidelity "
+          "schedule (not applicable for fidelity_schedule 'none')");
+ABSL_FLAG(int32_t, fidelity_ramp_generations, 1000,
+          "number of generations to reach evaluations_per_program for "
+          "fidelity_schedule 'generations'");
+ABSL_FLAG(double, fidelity_exponent, 1.0,
+          "exponent of the growth curve of the fidelity schedule (1.0 is "
+          "linear growth)");
+ABSL_FLAG(int32_t, samples_per_label, 0,
+          "draw the samples in class-balanced batches of samples_per_label "
+          "samples of each digit (e.g. 20 for 200 evaluations_per_program) "
+          "instead of uniformly at random (0)");
+ABSL_FLAG(int32_t, rotated_samples_per_label, 0,
+          "number of samples of each digit replaced in each class-balanced "
+          "batch (all samples_per_label samples if 0; the remaining samples "
+          "are kept from the previous batch)");
+ABSL_FLAG(bool, deduplicate, false,
+          "execute programs with identical code only once per generation");
+ABSL_FLAG(int32_t, max_remutations, 0,
+          "maximum number of re-mutations of offspring identical to another "
+          "program in the generation (applicable with deduplicate)");
+ABSL_FLAG(int32_t, pipeline_threads, 0,
+          "number of threads executing programs with pipelined generations "
+          "(0 disables pipelining)");
+ABSL_FLAG(std::string, evaluation_order, "inputs_major",
+          "order of the executions in each generation: 'inputs_major' (all "
+          "programs on the inputs of an evaluation at a time) or "
+          "'programs_major' (each program on the inputs of all evaluations at "
+          "once) or 'programs_major_batched' (as 'programs_major' with the "
+          "executions of a program batched into as few processes as "
+          "possible)");
+ABSL_FLAG(bool, deterministic_execution, false,
+          "execute programs without ASLR, with an emulated time stamp counter, "
+          "fixed auxiliary vector and without getrandom");
+ABSL_FLAG(int32_t, determinism_checks, 0,
+          "number of programs re-executed in each generation to find "
+          "nondeterministic programs (not deduplicated once found)");
+ABSL_FLAG(bool, batch_mutation, false,
+          "create all offspring of a generation in one batch from an arena of "
+          "the parents' code (each offspring draws from its own random "
+          "stream)");
+ABSL_FLAG(int32_t, mutation_threads, 1,
+          "number of threads creating the offspring with batch_mutation");
+ABSL_FLAG(std::string, recombination, "random",
+          "recombination of two parents' code: 'random' (byte-aligned random "
+          "ranges), 'aligned' (ranges of whole instructions) or 'homologous' "
+          "(ranges of whole instructions at the same position in both "
+          "parents)");
+ABSL_FLAG(bool, prescreen, false,
+          "statically reject (and re-mutate) offspring certain to fault in the "
+          "mutated instructions before executing them");
+ABSL_FLAG(int32_t, max_prescreen_rejections, 8,
+          "maximum number of re-mutations of an offspring rejected by the "
+          "prescreen (applicable with prescreen)");
+ABSL_FLAG(bool, instruction_mutators, false,
+          "also mutate opcodes, operands and immediates of decoded x86-64 "
+          "instructions and replace instructions with instructions of the "
+          "same length (each with weight 1)");
+ABSL_FLAG(bool, coverage_mutators, false,
+          "trace the instructions executed by each new program once and add "
+          "a bit flip and a recombination within the executed code (each with "
+          "weight 1)");
+ABSL_FLAG(bool, dictionary_mutator, false,
+          "also insert or replace sequences of instructions harvested from "
+          "offspring that improved on their parents (weight 1)");
+ABSL_FLAG(bool, mask_mutators, false,
+          "also flip a Poisson-distributed number of random bits, flip a "
+          "burst of contiguous bits and randomize a window of bytes (each "
+          "with weight 1)");
+ABSL_FLAG(bool, adaptive_mutator_rates, false,
+          "re-weight the mutators in each generation based on how often their "
+          "offspring survive the selection and improve on their parents "
+          "(the initial weights are used otherwise)");
 ABSL_FLAG(int32_t, max_generations, 10000,
           "maximum number of generations for the evolution");
 ABSL_FLAG(
@@ -77,6 +170,31 @@ int main(int argc, char **argv) {
   int phi = absl::GetFlag(FLAGS_phi);
   int lambda = absl::GetFlag(FLAGS_lambda);
   int evaluations_per_program = absl::GetFlag(FLAGS_evaluations_per_program);
+  std::string fidelity_schedule = absl::GetFlag(FLAGS_fidelity_schedule);
+  int min_evaluations_per_program =
+      absl::GetFlag(FLAGS_min_evaluations_per_program);
+  int fidelity_ramp_generations =
+      absl::GetFlag(FLAGS_fidelity_ramp_generations);
+  double fidelity_exponent = absl::GetFlag(FLAGS_fidelity_exponent);
+  int samples_per_label = absl::GetFlag(FLAGS_samples_per_label);
+  int rotated_samples_per_label =
+      absl::GetFlag(FLAGS_rotated_samples_per_label);
+  bool deduplicate = absl::GetFlag(FLAGS_deduplicate);
+  int max_remutations = absl::GetFlag(FLAGS_max_remutations);
+  int pipeline_threads = absl::GetFlag(FLAGS_pipeline_threads);
+  std::string evaluation_order = absl::GetFlag(FLAGS_evaluation_order);
+  bool deterministic_execution = absl::GetFlag(FLAGS_deterministic_execution);
+  int determinism_checks = absl::GetFlag(FLAGS_determinism_checks);
+  bool batch_mutation = absl::GetFlag(FLAGS_batch_mutation);
+  int mutation_threads = absl::GetFlag(FLAGS_mutation_threads);
+  std::string recombination = absl::GetFlag(FLAGS_recombination);
+  bool prescreen = absl::GetFlag(FLAGS_prescreen);
+  int max_prescreen_rejections = absl::GetFlag(FLAGS_max_prescreen_rejections);
+  bool instruction_mutators = absl::GetFlag(FLAGS_instruction_mutators);
+  bool coverage_mutators = absl::GetFlag(FLAGS_coverage_mutators);
+  bool dictionary_mutator = absl::GetFlag(FLAGS_dictionary_mutator);
+  bool mask_mutators = absl::GetFlag(FLAGS_mask_mutators);
+  bool adaptive_mutator_rates = absl::GetFlag(FLAGS_adaptive_mutator_rates);
   int max_generations = absl::GetFlag(FLAGS_max_generations);
   bool score_results_history = absl::GetFlag(FLAGS_score_results_history);
   std::string output_filename_prefix =
@@ -90,6 +208,38 @@ int main(int argc, char **argv) {
   std::cout << "# phi: " << phi << "\n";
   std::cout << "# lambda: " << lambda << "\n";
   std::cout << "# evaluations_per_program: " << evaluations_per_program << "\n";
+  std::cout << "# fidelity_schedule: " << fidelity_schedule << "\n";
+  std::cout << "# min_evaluations_per_program: " << min_evaluations_per_program
+            << "\n";
+  std::cout << "# fidelity_ramp_generations: " << fidelity_ramp_generations
+            << "\n";
+  std::cout << "# fidelity_exponent: " << fidelity_exponent << "\n";
+  std::cout << "# samples_per_label: " << samples_per_label << "\n";
+  std::cout << "# rotated_samples_per_label: " << rotated_samples_per_label
+            << "\n";
+  std::cout << "# deduplicate: " << std::boolalpha << deduplicate << "\n";
+  std::cout << "# max_remutations: " << max_remutations << "\n";
+  std::cout << "# pipeline_threads: " << pipeline_threads << "\n";
+  std::cout << "# evaluation_order: " << evaluation_order << "\n";
+  std::cout << "# deterministic_execution: " << std::boolalpha
+            << deterministic_execution << "\n";
+  std::cout << "# determinism_checks: " << determinism_checks << "\n";
+  std::cout << "# batch_mutation: " << std::boolalpha << batch_mutation
+            << "\n";
+  std::cout << "# mutation_threads: " << mutation_threads << "\n";
+  std::cout << "# recombination: " << recombination << "\n";
+  std::cout << "# prescreen: " << std::boolalpha << prescreen << "\n";
+  std::cout << "# max_prescreen_rejections: " << max_prescreen_rejections
+            << "\n";
+  std::cout << "# instruction_mutators: " << std::boolalpha
+            << instruction_mutators << "\n";
+  std::cout << "# coverage_mutators: " << std::boolalpha << coverage_mutators
+            << "\n";
+  std::cout << "# dictionary_mutator: " << std::boolalpha << dictionary_mutator
+            << "\n";
+  std::cout << "# mask_mutators: " << std::boolalpha << mask_mutators << "\n";
+  std::cout << "# adaptive_mutator_rates: " << std::boolalpha
+            << adaptive_mutator_rates << "\n";
   std::cout << "# max_generations: " << max_generations << "\n";
   std::cout << "# score_results_history: " << std::boolalpha
             << score_results_history << "\n";
@@ -99,13 +249,28 @@ int main(int argc, char **argv) {
             << initialize_programs_to_all_nops << "\n";
   std::cout << std::flush;
 
+  if (samples_per_label < 0 || rotated_samples_per_label < 0 ||
+      rotated_samples_per_label > samples_per_label) {
+    std::cerr << "rotated_samples_per_label should be in 0..samples_per_label"
+              << "\n";
+    return 1;
+  }
+
   viaevo::Random gen;
   gen.Seed(random_seed);
 
   std::shared_ptr<viaevo::MutatorPointRandom> mutator_point =
       std::make_shared<viaevo::MutatorPointRandom>(gen);
-  std::shared_ptr<viaevo::MutatorRecombineRandom> mutator_recombine =
-      std::make_shared<viaevo::MutatorRecombineRandom>(gen);
+  std::shared_ptr<viaevo::Mutator> mutator_recombine;
+  if (recombination == "random") {
+    mutator_recombine = std::make_shared<viaevo::MutatorRecombineRandom>(gen);
+  } else if (recombination == "aligned" || recombination == "homologous") {
+    mutator_recombine = std::make_shared<viaevo::MutatorRecombineAligned>(
+        gen, recombination == "homologous");
+  } else {
+    std::cerr << "Unknown recombination: " << recombination << "\n";
+    return 1;
+  }
   std::shared_ptr<viaevo::MutatorRecombinePlainElf>
       mutator_recombine_plain_elf =
           std::make_shared<viaevo::MutatorRecombinePlainElf>(gen, elf_filename);
@@ -113,25 +278,79 @@ int main(int argc, char **argv) {
       mutator_last_instruction =
           std::make_shared<viaevo::MutatorPointLastInstruction>(gen);
 
-  viaevo::MutatorCompositeRandom mutator_composite(gen);
-  mutator_composite.AppendMutator(mutator_point);
-  mutator_composite.AppendMutator(mutator_recombine);
-  mutator_composite.AppendMutator(mutator_recombine_plain_elf);
-  // Naive "implementation" of a weighted random composite mutator - just append
-  // a mutator mutiple times.
-  // TODO: Implement a weighted random composite mutator.
-  for (int i = 0; i < 7; ++i) {
-    mutator_composite.AppendMutator(mutator_last_instruction);
+  std::unique_ptr<viaevo::MutatorCompositeWeighted> mutator_composite(
+      adaptive_mutator_rates ? new viaevo::MutatorCompositeAdaptive(gen)
+                             : new viaevo::MutatorCompositeWeighted(gen));
+  mutator_composite->AppendMutator(mutator_point, 1.0);
+  mutator_composite->AppendMutator(mutator_recombine, 1.0);
+  mutator_composite->AppendMutator(mutator_recombine_plain_elf, 1.0);
+  mutator_composite->AppendMutator(mutator_last_instruction, 7.0);
+  if (instruction_mutators) {
+    for (auto field : {viaevo::MutatorInstructionField::kOpcode,
+                       viaevo::MutatorInstructionField::kOperands,
+                       viaevo::MutatorInstructionField::kImmediate}) {
+      mutator_composite->AppendMutator(
+          std::make_shared<viaevo::MutatorInstructionField>(gen, field), 1.0);
+    }
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorInstructionReplace>(gen), 1.0);
+  }
+  if (coverage_mutators) {
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorPointCovered>(gen), 1.0);
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorRecombineCovered>(gen), 1.0);
+  }
+  if (dictionary_mutator) {
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorDictionary>(gen), 1.0);
+  }
+  if (mask_mutators) {
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorMaskPoisson>(gen), 1.0);
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorMaskBurst>(gen), 1.0);
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorMaskWindow>(gen), 1.0);
   }
 
   viaevo::ScorerMnistDigits scorer(
       gen, "examples/100_mnist_digits/data/train-images-idx3-ubyte",
-      "examples/100_mnist_digits/data/train-labels-idx1-ubyte");
+      "examples/100_mnist_digits/data/train-labels-idx1-ubyte",
+      samples_per_label, rotated_samples_per_label);
 
   viaevo::EvolverAdHoc evolver(
-      elf_filename, mu, phi, lambda, scorer, mutator_composite, gen,
+      elf_filename, mu, phi, lambda, scorer, *mutator_composite, gen,
       evaluations_per_program, max_generations, score_results_history,
       output_filename_prefix, initialize_programs_to_all_nops);
+  if (fidelity_schedule == "generations") {
+    evolver.set_fidelity_schedule(
+        std::make_shared<viaevo::FidelityScheduleGenerations>(
+            min_evaluations_per_program, evaluations_per_program,
+            fidelity_ramp_generations, fidelity_exponent));
+  } else if (fidelity_schedule == "score") {
+    evolver.set_fidelity_schedule(
+        std::make_shared<viaevo::FidelityScheduleScore>(
+            min_evaluations_per_program, evaluations_per_program,
+            fidelity_exponent));
+  } else if (fidelity_schedule != "none") {
+    std::cerr << "Unknown fidelity_schedule: " << fidelity_schedule << "\n";
+    return 1;
+  }
+  evolver.set_deduplicate(deduplicate, max_remutations);
+  evolver.set_prescreen(prescreen, max_prescreen_rejections);
+  evolver.set_determinism(deterministic_execution, determinism_checks);
+  evolver.set_coverage(coverage_mutators);
+  evolver.set_batch_mutation(batch_mutation, random_seed, mutation_threads);
+  evolver.set_pipelined(pipeline_threads);
+  if (evaluation_order == "programs_major") {
+    evolver.set_evaluation_order(viaevo::EvolverAdHoc::kProgramsMajor);
+  } else if (evaluation_order == "programs_major_batched") {
+    evolver.set_evaluation_order(viaevo::EvolverAdHoc::kProgramsMajorBatched);
+  } else if (evaluation_order != "inputs_major") {
+    std::cerr << "Unknown evaluation_order: " << evaluation_order << "\n";
+    return 1;
+  }
   evolver.Run();
 
   return 0;
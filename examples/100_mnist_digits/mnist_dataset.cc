@@ -0,0 +1,142 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mnist_dataset.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace viaevo {
+
+namespace {
+
+void Fail(const std::string &filename, const char *message) {
+  fprintf(stderr, "%s: %s\n", filename.c_str(), message);
+  exit(EXIT_FAILURE);
+}
+
+// Read-only memory mapping of a whole file, unmapped on destruction.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &filename) : filename_(filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+      Fail(filename, "open failed");
+    struct stat st;
+    if (fstat(fd, &st) == -1)
+      Fail(filename, "fstat failed");
+    size_ = st.st_size;
+    if (size_ > 0) {
+      void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED)
+        Fail(filename, "mmap failed");
+      data_ = static_cast<const uint8_t *>(data);
+    }
+    close(fd);
+  }
+  ~MappedFile() {
+    if (data_ != nullptr)
+      munmap(const_cast<uint8_t *>(data_), size_);
+  }
+
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // Validates the IDX header (unsigned byte data with num_dimensions
+  // dimensions) and returns the dimension sizes.
+  std::vector<int> ReadIdxHeader(int num_dimensions) const {
+    size_t header_size = 4 + 4 * num_dimensions;
+    if (size_ < header_size)
+      Fail(filename_, "file too small for the IDX header");
+    if (data_[0] != 0 || data_[1] != 0)
+      Fail(filename_, "first two bytes should be 0");
+    if (data_[2] != 8)
+      Fail(filename_, "data type is not the expected 'unsigned byte'");
+    if (data_[3] != num_dimensions)
+      Fail(filename_, "unexpected number of dimensions");
+
+    std::vector<int> dimensions_sizes(num_dimensions);
+    size_t data_size = 1;
+    for (int i = 0; i < num_dimensions; ++i) {
+      const uint8_t *bytes = data_ + 4 + 4 * i;
+      dimensions_sizes[i] =
+          (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+      data_size *= dimensions_sizes[i];
+    }
+    if (size_ != header_size + data_size)
+      Fail(filename_, "file size does not match the IDX header");
+    return dimensions_sizes;
+  }
+
+private:
+  std::string filename_;
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace
+
+MnistDataset::MnistDataset(const std::string &images_filename,
+                           const std::string &labels_filename) {
+  MappedFile images(images_filename);
+  std::vector<int> images_dimensions = images.ReadIdxHeader(3);
+  MappedFile labels(labels_filename);
+  std::vector<int> labels_dimensions = labels.ReadIdxHeader(1);
+
+  if (images_dimensions[0] != labels_dimensions[0])
+    Fail(labels_filename, "number of labels does not match number of images");
+  num_samples_ = images_dimensions[0];
+  rows_ = images_dimensions[1];
+  columns_ = images_dimensions[2];
+
+  // The pixels are packed into ints followed by a zero int.
+  size_t image_size = rows_ * columns_;
+  inputs_size_ = 1 + (image_size + sizeof(int) - 1) / sizeof(int);
+  inputs_.assign(num_samples_ * inputs_size_, 0);
+  const uint8_t *image = images.data() + 16;
+  for (int i = 0; i < num_samples_; ++i, image += image_size) {
+    memcpy(inputs_.data() + i * inputs_size_, image, image_size);
+  }
+
+  const uint8_t *label = labels.data() + 8;
+  labels_.assign(label, label + num_samples_);
+  samples_by_label_.resize(10);
+  for (int i = 0; i < num_samples_; ++i) {
+    if (labels_[i] > 9)
+      Fail(labels_filename, "label out of range 0-9");
+    samples_by_label_[labels_[i]].push_back(i);
+  }
+}
+
+std::shared_ptr<const MnistDataset>
+MnistDataset::Load(const std::string &images_filename,
+                   const std::string &labels_filename) {
+  static std::mutex cache_mutex;
+  static std::map<std::pair<std::string, std::string>,
+                  std::shared_ptr<const MnistDataset>>
+      cache;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto key = std::make_pair(images_filename, labels_filename);
+  auto it = cache.find(key);
+  if (it != cache.end())
+    return it->second;
+
+  std::shared_ptr<const MnistDataset> dataset(
+      new MnistDataset(images_filename, labels_filename));
+  cache.emplace(key, dataset);
+  return dataset;
+}
+
+} // namespace viaevo
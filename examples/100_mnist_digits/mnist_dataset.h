@@ -0,0 +1,70 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_EXAMPLES_100_MNIST_DIGITS_MNIST_DATASET_H_
+#define VIAEVO_EXAMPLES_100_MNIST_DIGITS_MNIST_DATASET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace viaevo {
+
+// MnistDataset holds the images and labels of an MNIST data set
+// (http://yann.lecun.com/exdb/mnist/) read from a pair of IDX files. The files
+// are memory-mapped and their headers are validated once (failing the process
+// on invalid files also in optimized builds). Each image is pre-expanded into
+// the layout of the inputs of the evolved programs: the raw pixel bytes packed
+// into inputs_size() ints followed by a zero int.
+class MnistDataset {
+public:
+  // Returns the data set for the pair of files, loading it on the first call.
+  // Subsequent calls (e.g. by the scorers of concurrent trials) share the
+  // loaded data set. Thread-safe.
+  static std::shared_ptr<const MnistDataset>
+  Load(const std::string &images_filename, const std::string &labels_filename);
+
+  MnistDataset(const MnistDataset &) = delete;
+  MnistDataset &operator=(const MnistDataset &) = delete;
+
+  int num_samples() const { return num_samples_; }
+  int rows() const { return rows_; }
+  int columns() const { return columns_; }
+  // Number of ints of inputs per sample.
+  size_t inputs_size() const { return inputs_size_; }
+  // Inputs (inputs_size() ints) for the sample at index.
+  const int *inputs(int index) const {
+    return inputs_.data() + index * inputs_size_;
+  }
+  // Digit (0-9) of the sample at index.
+  int label(int index) const { return labels_[index]; }
+  // Indices of the samples of each digit (in increasing order), i.e.
+  // samples_by_label()[digit] lists the samples with label digit.
+  const std::vector<std::vector<int>> &samples_by_label() const {
+    return samples_by_label_;
+  }
+
+private:
+  MnistDataset(const std::string &images_filename,
+               const std::string &labels_filename);
+
+  int num_samples_ = 0;
+  int rows_ = 0;
+  int columns_ = 0;
+  size_t inputs_size_ = 0;
+  // Inputs of all the samples, laid out once when loading (the packed pixels
+  // followed by a zero int, which the mapped files do not have) and referenced
+  // rather than copied afterwards (see ScorerMnistDigits::LoadSample).
+  std::vector<int> inputs_;
+  std::vector<uint8_t> labels_;
+  std::vector<std::vector<int>> samples_by_label_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_EXAMPLES_100_MNIST_DIGITS_MNIST_DATASET_H_
@@ -0,0 +1,96 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mnist_dataset.h"
+
+#include <stdint.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Writes an IDX file of unsigned bytes with dimensions and data.
+void WriteIdx(const std::string &filename, const std::vector<int> &dimensions,
+              const std::vector<uint8_t> &data) {
+  std::ofstream ofs(filename, std::ios::binary);
+  ofs.put(0).put(0).put(8).put(dimensions.size());
+  for (int dimension : dimensions) {
+    for (int shift = 24; shift >= 0; shift -= 8)
+      ofs.put((dimension >> shift) & 0xff);
+  }
+  ofs.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+TEST(MnistDatasetTest, Load) {
+  std::string images_filename = testing::TempDir() + "mnist_test_images";
+  std::string labels_filename = testing::TempDir() + "mnist_test_labels";
+  // Three 4x2 images with pixels i * 10 + j.
+  std::vector<uint8_t> pixels;
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 8; ++j)
+      pixels.push_back(i * 10 + j);
+  WriteIdx(images_filename, {3, 4, 2}, pixels);
+  WriteIdx(labels_filename, {3}, {7, 0, 9});
+
+  std::shared_ptr<const viaevo::MnistDataset> dataset =
+      viaevo::MnistDataset::Load(images_filename, labels_filename);
+
+  EXPECT_EQ(dataset->num_samples(), 3);
+  EXPECT_EQ(dataset->rows(), 4);
+  EXPECT_EQ(dataset->columns(), 2);
+  // 8 bytes of pixels in 2 ints and a zero int.
+  ASSERT_EQ(dataset->inputs_size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    const uint8_t *bytes =
+        reinterpret_cast<const uint8_t *>(dataset->inputs(i));
+    EXPECT_EQ(std::vector<uint8_t>(bytes, bytes + 8),
+              std::vector<uint8_t>(pixels.begin() + i * 8,
+                                   pixels.begin() + (i + 1) * 8));
+    EXPECT_EQ(dataset->inputs(i)[2], 0);
+  }
+  EXPECT_EQ(dataset->label(0), 7);
+  EXPECT_EQ(dataset->label(1), 0);
+  EXPECT_EQ(dataset->label(2), 9);
+  ASSERT_EQ(dataset->samples_by_label().size(), 10);
+  EXPECT_EQ(dataset->samples_by_label()[7], std::vector<int>({0}));
+  EXPECT_EQ(dataset->samples_by_label()[0], std::vector<int>({1}));
+  EXPECT_EQ(dataset->samples_by_label()[9], std::vector<int>({2}));
+  EXPECT_TRUE(dataset->samples_by_label()[5].empty());
+
+  // The loaded data set is shared.
+  EXPECT_EQ(viaevo::MnistDataset::Load(images_filename, labels_filename),
+            dataset);
+}
+
+TEST(MnistDatasetTest, InvalidFiles) {
+  std::string images_filename = testing::TempDir() + "mnist_invalid_images";
+  std::string labels_filename = testing::TempDir() + "mnist_invalid_labels";
+
+  // Truncated images (two 2x2 images need 8 bytes).
+  WriteIdx(images_filename, {2, 2, 2}, std::vector<uint8_t>(6));
+  WriteIdx(labels_filename, {2}, {1, 2});
+  EXPECT_DEATH(viaevo::MnistDataset::Load(images_filename, labels_filename),
+               "file size does not match");
+
+  // Label count mismatch.
+  WriteIdx(images_filename, {2, 2, 2}, std::vector<uint8_t>(8));
+  WriteIdx(labels_filename, {3}, {1, 2, 3});
+  EXPECT_DEATH(viaevo::MnistDataset::Load(images_filename, labels_filename),
+               "number of labels");
+
+  // Label out of range.
+  WriteIdx(labels_filename, {2}, {1, 10});
+  EXPECT_DEATH(viaevo::MnistDataset::Load(images_filename, labels_filename),
+               "label out of range");
+
+  EXPECT_DEATH(viaevo::MnistDataset::Load(images_filename, "does_not_exist"),
+               "open failed");
+}
+
+} // namespace
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mnist_validator.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// TODO: Remove relative paths.
+#include "../../program/program.h"
+#include "../../util/worker_pool.h"
+
+namespace viaevo {
+
+constexpr int MnistValidationReport::kInvalidPrediction;
+
+void MnistValidationReport::Merge(const MnistValidationReport &other) {
+  num_samples += other.num_samples;
+  num_executions += other.num_executions;
+  num_correct += other.num_correct;
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j <= kInvalidPrediction; ++j)
+      confusion[i][j] += other.confusion[i][j];
+  }
+  for (const auto &entry : other.signals)
+    signals[entry.first] += entry.second;
+  num_nondeterministic += other.num_nondeterministic;
+}
+
+void MnistValidationReport::Print(std::ostream &os) const {
+  os << "samples: " << num_samples << " (" << num_executions
+     << " executions)\n";
+  os << "accuracy: " << std::fixed << std::setprecision(2)
+     << 100.0 * accuracy() << "% (" << num_correct << "/" << num_samples
+     << ")\n";
+
+  os << "confusion matrix (rows: expected, columns: results[1], '-': "
+        "outside 0-9):\n";
+  os << "     ";
+  for (int j = 0; j < kInvalidPrediction; ++j)
+    os << std::setw(7) << j;
+  os << std::setw(7) << "-" << "\n";
+  for (int i = 0; i < 10; ++i) {
+    os << std::setw(5) << i;
+    for (int j = 0; j <= kInvalidPrediction; ++j)
+      os << std::setw(7) << confusion[i][j];
+    os << "\n";
+  }
+
+  os << "executions by (stop signal, term signal):\n";
+  for (const auto &entry : signals) {
+    os << "  (" << entry.first.first << ", " << entry.first.second
+       << "): " << entry.second << "\n";
+  }
+  os << "nondeterministic samples: " << num_nondeterministic << "\n";
+  os << "time: " << std::setprecision(3) << seconds << " s ("
+     << std::setprecision(1) << images_per_second() << " images/s)\n";
+}
+
+MnistValidator::MnistValidator(std::string elf_filename, int num_threads,
+                               int repeats)
+    : elf_filename_(elf_filename),
+      num_threads_(num_threads > 0
+                       ? num_threads
+                       : std::max(1u, std::thread::hardware_concurrency())),
+      repeats_(repeats) {
+  assert(repeats_ >= 1 && "repeats should be at least 1");
+}
+
+MnistValidationReport MnistValidator::Validate(const MnistDataset &dataset,
+                                               int num_samples) const {
+  auto start = std::chrono::steady_clock::now();
+  if (num_samples < 0 || num_samples > dataset.num_samples())
+    num_samples = dataset.num_samples();
+
+  // Several chunks per thread balance the load when some samples run until
+  // the timeout.
+  int chunk_size = std::max(1, num_samples / (8 * num_threads_));
+  MnistValidationReport report;
+  std::mutex report_mutex;
+  {
+    WorkerPool pool(num_threads_);
+    for (int begin = 0; begin < num_samples; begin += chunk_size) {
+      int end = std::min(num_samples, begin + chunk_size);
+      pool.Submit([this, &dataset, &report, &report_mutex, begin, end] {
+        std::shared_ptr<Program> program = Program::Create(elf_filename_);
+        MnistValidationReport chunk_report;
+        for (int i = begin; i < end; ++i) {
+          program->SetElfInputs(dataset.inputs(i), dataset.inputs_size());
+
+          int first_result = 0;
+          bool deterministic = true;
+          for (int r = 0; r < repeats_; ++r) {
+            program->Execute();
+            const std::vector<int> &results = program->last_results();
+            int result = results.size() > 1 ? results[1] : -1;
+            if (r == 0)
+              first_result = result;
+            else if (result != first_result)
+              deterministic = false;
+            ++chunk_report.signals[std::make_pair(
+                program->last_stop_signal(), program->last_term_signal())];
+            ++chunk_report.num_executions;
+          }
+
+          int expected = dataset.label(i);
+          int predicted = (first_result >= 0 && first_result <= 9)
+                              ? first_result
+                              : MnistValidationReport::kInvalidPrediction;
+          ++chunk_report.confusion[expected][predicted];
+          if (predicted == expected)
+            ++chunk_report.num_correct;
+          if (!deterministic)
+            ++chunk_report.num_nondeterministic;
+          ++chunk_report.num_samples;
+        }
+        std::lock_guard<std::mutex> lock(report_mutex);
+        report.Merge(chunk_report);
+      });
+    }
+    pool.Wait();
+  }
+
+  report.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return report;
+}
+
+} // namespace viaevo
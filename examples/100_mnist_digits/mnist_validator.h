@@ -0,0 +1,73 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_EXAMPLES_100_MNIST_DIGITS_MNIST_VALIDATOR_H_
+#define VIAEVO_EXAMPLES_100_MNIST_DIGITS_MNIST_VALIDATOR_H_
+
+#include <array>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "mnist_dataset.h"
+
+namespace viaevo {
+
+// MnistValidationReport summarizes the executions of an evolved program on the
+// samples of an MnistDataset.
+struct MnistValidationReport {
+  // Column of confusion for results[1] outside of the range 0-9.
+  static constexpr int kInvalidPrediction = 10;
+
+  int num_samples = 0;
+  int num_executions = 0;
+  // Samples with the expected digit in results[1] (in the first execution).
+  int num_correct = 0;
+  // confusion[expected][predicted] counts the samples by the expected digit
+  // and results[1] (in the first execution).
+  std::array<std::array<int, 11>, 10> confusion{};
+  // Number of executions by (last stop signal, last term signal).
+  std::map<std::pair<int, int>, int> signals;
+  // Samples for which the repeated executions gave different results[1].
+  int num_nondeterministic = 0;
+  // Wall time of the validation.
+  double seconds = 0.0;
+
+  double accuracy() const {
+    return num_samples > 0 ? (double)num_correct / num_samples : 0.0;
+  }
+  double images_per_second() const {
+    return seconds > 0.0 ? num_samples / seconds : 0.0;
+  }
+  // Adds the counts of other (except seconds).
+  void Merge(const MnistValidationReport &other);
+  // Prints the report in a human-readable form.
+  void Print(std::ostream &os) const;
+};
+
+// MnistValidator executes an evolved ELF on the samples of an MnistDataset in
+// parallel. Each worker thread executes its own Program instance of the ELF.
+// Each sample is executed repeats times to detect nondeterministic programs.
+class MnistValidator {
+public:
+  // num_threads <= 0 uses all hardware threads.
+  MnistValidator(std::string elf_filename, int num_threads = 0,
+                 int repeats = 1);
+
+  // Validates the program on the first num_samples samples of dataset (all
+  // samples if num_samples < 0).
+  MnistValidationReport Validate(const MnistDataset &dataset,
+                                 int num_samples = -1) const;
+
+protected:
+  std::string elf_filename_;
+  int num_threads_ = 1;
+  int repeats_ = 1;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_EXAMPLES_100_MNIST_DIGITS_MNIST_VALIDATOR_H_
@@ -0,0 +1,95 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mnist_validator.h"
+
+#include <stdint.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Writes an IDX file of unsigned bytes with dimensions and data.
+void WriteIdx(const std::string &filename, const std::vector<int> &dimensions,
+              const std::vector<uint8_t> &data) {
+  std::ofstream ofs(filename, std::ios::binary);
+  ofs.put(0).put(0).put(8).put(dimensions.size());
+  for (int dimension : dimensions) {
+    for (int shift = 24; shift >= 0; shift -= 8)
+      ofs.put((dimension >> shift) & 0xff);
+  }
+  ofs.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+TEST(MnistValidatorTest, Validate) {
+  std::string images_filename = testing::TempDir() + "validator_test_images";
+  std::string labels_filename = testing::TempDir() + "validator_test_labels";
+  std::vector<uint8_t> labels;
+  for (int i = 0; i < 30; ++i)
+    labels.push_back(i % 10);
+  WriteIdx(images_filename, {30, 4, 4}, std::vector<uint8_t>(30 * 16, 1));
+  WriteIdx(labels_filename, {30}, labels);
+  std::shared_ptr<const viaevo::MnistDataset> dataset =
+      viaevo::MnistDataset::Load(images_filename, labels_filename);
+
+  viaevo::MnistValidator validator("elfs/intermediate_medium", 4, 2);
+  viaevo::MnistValidationReport report = validator.Validate(*dataset, 25);
+
+  EXPECT_EQ(report.num_samples, 25);
+  EXPECT_EQ(report.num_executions, 50);
+  int confusion_total = 0;
+  for (int i = 0; i < 10; ++i) {
+    int row_total = 0;
+    for (int count : report.confusion[i])
+      row_total += count;
+    // Labels 0-4 appear three times and 5-9 twice in the first 25 samples.
+    EXPECT_EQ(row_total, i < 5 ? 3 : 2);
+    confusion_total += row_total;
+  }
+  EXPECT_EQ(confusion_total, 25);
+  int signals_total = 0;
+  for (const auto &entry : report.signals)
+    signals_total += entry.second;
+  EXPECT_EQ(signals_total, 50);
+  EXPECT_GT(report.seconds, 0.0);
+
+  std::ostringstream oss;
+  report.Print(oss);
+  EXPECT_NE(oss.str().find("confusion matrix"), std::string::npos);
+
+  // All samples by default.
+  EXPECT_EQ(validator.Validate(*dataset).num_samples, 30);
+}
+
+TEST(MnistValidatorTest, Merge) {
+  viaevo::MnistValidationReport report1, report2;
+  report1.num_samples = 2;
+  report1.num_correct = 1;
+  report1.confusion[3][3] = 1;
+  report1.confusion[4][10] = 1;
+  report1.signals[{5, 9}] = 2;
+  report2.num_samples = 1;
+  report2.confusion[3][3] = 1;
+  report2.signals[{5, 9}] = 1;
+  report2.signals[{14, 9}] = 1;
+  report2.num_nondeterministic = 1;
+
+  report1.Merge(report2);
+  EXPECT_EQ(report1.num_samples, 3);
+  EXPECT_EQ(report1.num_correct, 1);
+  EXPECT_EQ(report1.confusion[3][3], 2);
+  EXPECT_EQ(report1.confusion[4][10], 1);
+  EXPECT_EQ(report1.signals[std::make_pair(5, 9)], 3);
+  EXPECT_EQ(report1.signals[std::make_pair(14, 9)], 1);
+  EXPECT_EQ(report1.num_nondeterministic, 1);
+  EXPECT_NEAR(report1.accuracy(), 1.0 / 3, 1e-9);
+}
+
+} // namespace
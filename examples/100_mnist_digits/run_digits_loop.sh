@@ -9,12 +9,13 @@ if [ $# -ne 1 ]; then
 fi
 
 ITERATIONS=$1
+PREFIX="intermediate_medium_digits_"
 
 echo "iterations: $ITERATIONS"
+echo "output file prefix: $PREFIX"
 
-for i in $(seq $ITERATIONS); do
-  echo "iteration $i of $ITERATIONS"
-  sh examples/100_mnist_digits/run_digits.sh $i
-done
+# All iterations (trials) run concurrently in a single process, each trial
+# writes its own ${PREFIX}rs_<seed>.log file.
+(time bazel run //examples/trials:viaevo_trials -- --task=mnist_digits --num_trials=$ITERATIONS --output_filename_prefix="$(pwd)/${PREFIX}") |& tee ${PREFIX}trials.log
 
 exit
@@ -6,11 +6,15 @@
 #ifndef VIAEVO_EXAMPLES_100_MNIST_DIGITS_SCORER_MNIST_DIGITS_H_
 #define VIAEVO_EXAMPLES_100_MNIST_DIGITS_SCORER_MNIST_DIGITS_H_
 
+#include <memory>
 #include <vector>
 
+#include "mnist_dataset.h"
+
 // TODO: Remove relative path.
 #include "../../scorer/scorer.h"
 #include "../../util/random.h"
+#include "../../util/stratified_sampler.h"
 
 namespace viaevo {
 
@@ -19,40 +23,53 @@ namespace viaevo {
 // digit value (0-9) in results[1]. The scorer expects the results to be
 // initialized to -1 (using e.g. the elfs/intermediate_medium elf). (The results
 // in e.g. *_small elfs are initialized to 0 or 3 what may interfere with the
-// scoring.)
+// scoring.) The data set is loaded once and shared by all scorers for the same
+// files (see MnistDataset).
+//
+// By default, each InputSet is a sample drawn uniformly at random. With
+// samples_per_label > 0, the samples are drawn in batches of samples_per_label
+// samples of each digit in a random order (see StratifiedSampler), i.e. with
+// evaluations_per_program equal to 10 * samples_per_label each generation
+// evaluates the programs on the same number of samples of each digit. With
+// 0 < rotated_samples_per_label < samples_per_label, only
+// rotated_samples_per_label samples of each digit are replaced in each batch
+// (all samples are replaced otherwise).
 class ScorerMnistDigits : public Scorer {
 public:
   explicit ScorerMnistDigits(Random &gen, std::string images_filename,
-                             std::string labels_filename);
-  // Returns score for a specific Program.
-  virtual long long Score(const Program &program) const override;
+                             std::string labels_filename,
+                             int samples_per_label = 0,
+                             int rotated_samples_per_label = 0);
+  // Returns score for results of a Program executed on input_set's inputs.
+  virtual long long ScoreResults(const int *results, size_t results_size,
+                                 const InputSet &input_set) const override;
   // Returns score for a specific Program's results history.
   virtual long long
-  ScoreResultsHistory(const std::vector<std::vector<int>> &) const override;
+  ScoreResultsHistory(const ResultsHistory &) const override;
   // Returns maximum possible score for "perfect" results. Should be the same
-  // for different values of current_inputs_.
+  // for different inputs.
   virtual long long MaxScore() const override;
   // Returns maximum possible score for "perfect" results history.
   virtual long long MaxScoreResultsHistory() const override;
-  // Initializes new value(s) for current_inputs_.
-  virtual void ResetInputs() override;
 
-  int expected_value() { return expected_value_; }
+  int expected_value() const {
+    return current_input_set_->expected_values[0];
+  }
 
 protected:
-  // Loads the image of the digit in pos position from images_filename_ and sets
-  // the expected_value_ accordingly based on labels_filename_.
-  void LoadSample(int pos);
+  // Generates new value(s) for the inputs and the expected value.
+  virtual void GenerateInputSet(InputSet &input_set) override;
+
+  // Sets input_set's inputs to a view of the image of the digit in pos
+  // position (not copied) and the expected value accordingly.
+  void LoadSample(int pos, InputSet &input_set) const;
 
   // Random number generator.
   Random &gen_;
-  // Filenames for images and labels of the training set.
-  std::string images_filename_, labels_filename_;
-  // expected_value_ holds the value expected in results[1]. In this case, it is
-  // the value of the digit in current_inputs_.
-  int expected_value_ = -1;
-  // Number of digit samples in input data.
-  static constexpr int num_samples_ = 60'000;
+  // Images and labels of the training set.
+  std::shared_ptr<const MnistDataset> dataset_;
+  // Class-balanced sampling of the samples (if samples_per_label > 0).
+  std::unique_ptr<StratifiedSampler> sampler_;
 };
 
 } // namespace viaevo
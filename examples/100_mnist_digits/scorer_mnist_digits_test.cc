@@ -70,7 +70,8 @@ TEST(ScorerMnistDigitsTest, ResetInputs) {
   // clang-format on
 
   const unsigned char *tmp =
-      reinterpret_cast<const unsigned char *>(scorer.current_inputs().data());
+      reinterpret_cast<const unsigned char *>(
+          scorer.current_input_set().inputs_data());
   std::vector<unsigned char> read_image0;
   for (int i = 0; i < 28 * 28; ++i)
     read_image0.push_back(tmp[i]);
@@ -113,7 +114,8 @@ TEST(ScorerMnistDigitsTest, ResetInputs) {
   };
   // clang-format on
 
-  tmp = reinterpret_cast<const unsigned char *>(scorer.current_inputs().data());
+  tmp = reinterpret_cast<const unsigned char *>(
+      scorer.current_input_set().inputs_data());
   std::vector<unsigned char> read_image14;
   for (int i = 0; i < 28 * 28; ++i)
     read_image14.push_back(tmp[i]);
@@ -198,7 +200,8 @@ TEST(ScorerMnistDigitsTest, ResetInputs) {
   };
   // clang-format on
 
-  tmp = reinterpret_cast<const unsigned char *>(scorer.current_inputs().data());
+  tmp = reinterpret_cast<const unsigned char *>(
+      scorer.current_input_set().inputs_data());
   std::vector<unsigned char> read_image1;
   for (int i = 0; i < 28 * 28; ++i)
     read_image1.push_back(tmp[i]);
@@ -207,7 +210,7 @@ TEST(ScorerMnistDigitsTest, ResetInputs) {
   EXPECT_EQ(scorer.expected_value(), 0);
 
   // tmp = reinterpret_cast<const unsigned char
-  // *>(scorer.current_inputs().data());
+  // *>(scorer.current_input_set().inputs_data());
 
   // for (int i = 0; i < 28; ++i) {
   //   for (int j = 0; j < 28; ++j)
@@ -296,6 +299,23 @@ TEST(ScorerMnistDigitsTest, AllLabelValues) {
   EXPECT_EQ(scorer.expected_value(), 4);
 }
 
+TEST(ScorerMnistDigitsTest, StratifiedSamples) {
+  viaevo::Random gen;
+  viaevo::ScorerMnistDigits scorer(
+      gen, "examples/100_mnist_digits/data/train-images-idx3-ubyte",
+      "examples/100_mnist_digits/data/train-labels-idx1-ubyte", 2);
+
+  // Each batch of 20 samples has 2 samples of each digit.
+  for (int batch = 0; batch < 3; ++batch) {
+    std::vector<int> label_counts(10, 0);
+    for (int i = 0; i < 20; ++i) {
+      ++label_counts[scorer.expected_value()];
+      scorer.ResetInputs();
+    }
+    EXPECT_EQ(label_counts, std::vector<int>(10, 2));
+  }
+}
+
 TEST(ScorerMnistDigitsTest, Score) {
   viaevo::RandomMock gen({0, 14});
   EXPECT_EQ(gen(), 0);
@@ -351,33 +371,33 @@ TEST(ScorerMnistDigitsTest, ScoreResultsHistory) {
       "examples/100_mnist_digits/data/train-labels-idx1-ubyte");
   EXPECT_EQ(scorer.expected_value(), 5);
 
-  std::vector<std::vector<int>> results_history;
+  viaevo::ResultsHistory results_history;
 
   EXPECT_EQ(scorer.ScoreResultsHistory(results_history), 0);
 
-  results_history.push_back({20, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1});
+  results_history.Append({20, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1});
   EXPECT_EQ(scorer.ScoreResultsHistory(results_history), 0);
 
-  results_history.push_back({20, -1, -1, -1, -1, -1, -1, -1, -1, -1, 100});
+  results_history.Append({20, -1, -1, -1, -1, -1, -1, -1, -1, -1, 100});
   EXPECT_EQ(scorer.ScoreResultsHistory(results_history), 0);
 
-  results_history.push_back({-9999, -1, -1, -1, -1, -1, -1, -1, -1, -1, 100});
+  results_history.Append({-9999, -1, -1, -1, -1, -1, -1, -1, -1, -1, 100});
   EXPECT_EQ(scorer.ScoreResultsHistory(results_history), 0);
 
-  results_history.push_back({-9999, -5, -1, -1, -1, -1, -1, -1, -1, -1, 100});
+  results_history.Append({-9999, -5, -1, -1, -1, -1, -1, -1, -1, -1, 100});
   EXPECT_EQ(scorer.ScoreResultsHistory(results_history), 1'997'000'000'000'000);
 
   // Same results as the nearest above should not change the score.
-  results_history.push_back({-9999, 5, -1, -1, -1, -1, -1, -1, -1, -1, 100});
+  results_history.Append({-9999, 5, -1, -1, -1, -1, -1, -1, -1, -1, 100});
   EXPECT_EQ(scorer.ScoreResultsHistory(results_history), 2'997'000'000'000'000);
 
-  results_history.push_back({-9999, 7, -1, -1, -1, -1, -1, -1, -1, -1, 100});
+  results_history.Append({-9999, 7, -1, -1, -1, -1, -1, -1, -1, -1, 100});
   EXPECT_EQ(scorer.ScoreResultsHistory(results_history), 3'997'000'000'000'000);
 
-  results_history.push_back({-9999, 7, 42, -1, -1, -1, -1, -1, -1, -1, 100});
+  results_history.Append({-9999, 7, 42, -1, -1, -1, -1, -1, -1, -1, 100});
   EXPECT_EQ(scorer.ScoreResultsHistory(results_history), 3'997'000'000'000'000);
 
-  results_history.push_back({-9999, 42, -1, -1, -1, -1, -1, -1, -1, -1, -1});
+  results_history.Append({-9999, 42, -1, -1, -1, -1, -1, -1, -1, -1, -1});
   EXPECT_EQ(scorer.ScoreResultsHistory(results_history), 3'996'000'000'000'000);
 }
 
@@ -0,0 +1,187 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+// Converts a CSV file of integers into a tabular data set file (see
+// TabularDataset). Each line is a row: the inputs followed by num_expected
+// expected values. Empty lines and lines starting with '#' are skipped. The
+// CSV file is read twice (once to count the rows and once to write them), so
+// files larger than memory can be converted.
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+
+// TODO: Remove relative path.
+#include "../../scorer/tabular_dataset.h"
+
+ABSL_FLAG(std::string, input, "", "CSV file to convert");
+ABSL_FLAG(std::string, output, "", "tabular data set file to write");
+ABSL_FLAG(int32_t, num_expected, 1,
+          "number of expected values at the end of each line (the other "
+          "values are the inputs)");
+ABSL_FLAG(std::string, scoring_mode, "bit_match",
+          "how results are scored against the expected values: 'bit_match', "
+          "'exact_match' or 'range_reward'");
+ABSL_FLAG(int32_t, range_min, 0,
+          "smallest valid result for scoring_mode 'range_reward'");
+ABSL_FLAG(int32_t, range_max, 0,
+          "largest valid result for scoring_mode 'range_reward'");
+
+namespace {
+
+void Fail(const std::string &filename, size_t line_number,
+          const std::string &message) {
+  std::cerr << filename;
+  if (line_number > 0)
+    std::cerr << ":" << line_number;
+  std::cerr << ": " << message << "\n";
+  exit(EXIT_FAILURE);
+}
+
+// Parses the comma-separated integers in line into values. Returns false for
+// lines to be skipped.
+bool ParseLine(const std::string &filename, size_t line_number,
+               const std::string &line, std::vector<int> &values) {
+  values.clear();
+  size_t first = line.find_first_not_of(" \t\r");
+  if (first == std::string::npos || line[first] == '#')
+    return false;
+  const char *pos = line.c_str();
+  while (true) {
+    char *end = nullptr;
+    errno = 0;
+    long value = strtol(pos, &end, 10);
+    if (end == pos)
+      Fail(filename, line_number, "expected an integer");
+    if (errno == ERANGE || value < INT_MIN || value > INT_MAX)
+      Fail(filename, line_number, "integer out of range");
+    values.push_back(value);
+    while (*end == ' ' || *end == '\t' || *end == '\r')
+      ++end;
+    if (*end == '\0')
+      return true;
+    if (*end != ',')
+      Fail(filename, line_number, "expected ','");
+    pos = end + 1;
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  absl::SetProgramUsageMessage(
+      "This program converts a CSV file of integers (a row of inputs followed "
+      "by expected values per line) into a tabular data set file for "
+      "ScorerTabular.\n\nSample usage via the bazel build system:\n\nbazel "
+      "run //examples/200_tabular_dataset:csv_to_tabular_tool -- "
+      "--input=/tmp/sum_two.csv --output=/tmp/sum_two.vtd --num_expected=1 "
+      "--scoring_mode=bit_match");
+
+  absl::ParseCommandLine(argc, argv);
+
+  std::string input = absl::GetFlag(FLAGS_input);
+  std::string output = absl::GetFlag(FLAGS_output);
+  int num_expected = absl::GetFlag(FLAGS_num_expected);
+  std::string scoring_mode = absl::GetFlag(FLAGS_scoring_mode);
+
+  viaevo::TabularDataset::ScoringMode mode;
+  if (scoring_mode == "bit_match") {
+    mode = viaevo::TabularDataset::kBitMatch;
+  } else if (scoring_mode == "exact_match") {
+    mode = viaevo::TabularDataset::kExactMatch;
+  } else if (scoring_mode == "range_reward") {
+    mode = viaevo::TabularDataset::kRangeReward;
+  } else {
+    std::cerr << "Unknown scoring_mode: " << scoring_mode << "\n";
+    return 1;
+  }
+  if (input.empty() || output.empty()) {
+    std::cerr << "Missing --input or --output\n";
+    return 1;
+  }
+  if (num_expected <= 0) {
+    std::cerr << "num_expected should be positive\n";
+    return 1;
+  }
+
+  // The first pass counts the rows and checks that all rows have the same
+  // number of values.
+  std::vector<int> values;
+  size_t num_values = 0;
+  uint64_t num_rows = 0;
+  {
+    std::ifstream ifs(input);
+    if (!ifs)
+      Fail(input, 0, "open failed");
+    std::string line;
+    for (size_t line_number = 1; std::getline(ifs, line); ++line_number) {
+      if (!ParseLine(input, line_number, line, values))
+        continue;
+      if (num_rows == 0)
+        num_values = values.size();
+      if (values.size() != num_values)
+        Fail(input, line_number, "all rows should have the same length");
+      ++num_rows;
+    }
+  }
+  if (num_rows == 0)
+    Fail(input, 0, "no rows");
+  if (num_values <= static_cast<size_t>(num_expected))
+    Fail(input, 0, "rows should have at least one input");
+
+  viaevo::TabularDataset::Header header = viaevo::TabularDataset::MakeHeader(
+      mode, num_values - num_expected, num_expected, num_rows,
+      absl::GetFlag(FLAGS_range_min), absl::GetFlag(FLAGS_range_max));
+  uint64_t expected_offset = viaevo::TabularDataset::ExpectedOffset(header);
+  uint64_t size =
+      expected_offset + num_rows * header.expected_size * sizeof(int32_t);
+  {
+    std::ofstream ofs(output, std::ios::binary | std::ios::trunc);
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!ofs)
+      Fail(output, 0, "write failed");
+  }
+  if (truncate(output.c_str(), size) == -1)
+    Fail(output, 0, "truncate failed");
+
+  // The second pass writes both column blocks sequentially.
+  std::fstream inputs_stream(output,
+                             std::ios::binary | std::ios::in | std::ios::out);
+  std::fstream expected_stream(output,
+                               std::ios::binary | std::ios::in | std::ios::out);
+  inputs_stream.seekp(viaevo::TabularDataset::InputsOffset(header));
+  expected_stream.seekp(expected_offset);
+  std::ifstream ifs(input);
+  std::string line;
+  for (size_t line_number = 1; std::getline(ifs, line); ++line_number) {
+    if (!ParseLine(input, line_number, line, values))
+      continue;
+    inputs_stream.write(reinterpret_cast<const char *>(values.data()),
+                        header.inputs_size * sizeof(int32_t));
+    expected_stream.write(
+        reinterpret_cast<const char *>(values.data() + header.inputs_size),
+        header.expected_size * sizeof(int32_t));
+  }
+  inputs_stream.flush();
+  expected_stream.flush();
+  if (!inputs_stream || !expected_stream)
+    Fail(output, 0, "write failed");
+
+  std::cout << output << ": " << num_rows << " rows of "
+            << header.inputs_size << " inputs and " << header.expected_size
+            << " expected values\n";
+
+  return 0;
+}
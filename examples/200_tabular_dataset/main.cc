@@ -0,0 +1,140 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include <iostream>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+
+// TODO: Remove relative paths.
+#include "../../evolver/evolver_adhoc.h"
+#include "../../mutator/mutator_composite_weighted.h"
+#include "../../mutator/mutator_point_last_instruction.h"
+#include "../../mutator/mutator_point_random.h"
+#include "../../mutator/mutator_recombine_plain_elf.h"
+#include "../../mutator/mutator_recombine_random.h"
+#include "../../scorer/scorer_tabular.h"
+#include "../../util/random.h"
+
+ABSL_FLAG(std::string, dataset, "",
+          "filename of the tabular data set defining the task (see "
+          "csv_to_tabular_tool)");
+ABSL_FLAG(std::string, elf_filename, "elfs/intermediate_small",
+          "filename of the ELF executable to be used as the starting template "
+          "for evolution (NOTE: its inputs should fit the inputs of a row and "
+          "its results should have room for the expected values from "
+          "results[1])");
+ABSL_FLAG(
+    int32_t, mu, 60,
+    "number of parents selected in each generation to generate lambda "
+    "offspring (the size of the population in each generation is mu + lambda)");
+ABSL_FLAG(int32_t, phi, 10,
+          "number of parents selected randomly in each generation as opposed "
+          "to (mu - phi) parents that are selected based on their scores (mu "
+          ">= phi)");
+ABSL_FLAG(int32_t, lambda, 140,
+          "number of offspring to generate from mu parents in each generation "
+          "(the size of the population in each generation is mu + lambda)");
+ABSL_FLAG(int32_t, evaluations_per_program, 10,
+          "number of evaluations (rows of the data set) to be performed on "
+          "each program in each generation (scores are accumulated across "
+          "evaluations)");
+ABSL_FLAG(int32_t, max_generations, 1'000'000,
+          "maximum number of generations for the evolution");
+ABSL_FLAG(int32_t, block_rows, 4096,
+          "number of consecutive rows of the data set shuffled together (rows "
+          "are drawn block by block)");
+ABSL_FLAG(bool, release_blocks, false,
+          "drop the memory pages of each block of rows once the next block is "
+          "drawn (for data sets larger than memory)");
+ABSL_FLAG(
+    std::string, output_filename_prefix, "",
+    "prefix to prepend to output file names (e.g. for saved evolved elfs)");
+ABSL_FLAG(uint32_t, random_seed, 1,
+          "random seed for the evolution (and the order of the rows)");
+
+int main(int argc, char **argv) {
+  absl::SetProgramUsageMessage(
+      "This program evolves ELFs to compute the expected values of the rows "
+      "of a tabular data set from the rows' inputs (the data set also defines "
+      "how the results are scored).\n\nWARNING: The evolution produces invalid "
+      "executables. To protect your system, always run this program in a "
+      "sandbox!\n\nSample usage via the bazel build system (with 'build "
+      "--spawn_strategy=linux-sandbox' in .bazelrc):\n\nbazel run "
+      "//examples/200_tabular_dataset:main -- --dataset=/tmp/sum_two.vtd");
+
+  absl::ParseCommandLine(argc, argv);
+
+  std::string dataset = absl::GetFlag(FLAGS_dataset);
+  std::string elf_filename = absl::GetFlag(FLAGS_elf_filename);
+  int mu = absl::GetFlag(FLAGS_mu);
+  int phi = absl::GetFlag(FLAGS_phi);
+  int lambda = absl::GetFlag(FLAGS_lambda);
+  int evaluations_per_program = absl::GetFlag(FLAGS_evaluations_per_program);
+  int max_generations = absl::GetFlag(FLAGS_max_generations);
+  int block_rows = absl::GetFlag(FLAGS_block_rows);
+  bool release_blocks = absl::GetFlag(FLAGS_release_blocks);
+  std::string output_filename_prefix =
+      absl::GetFlag(FLAGS_output_filename_prefix);
+  unsigned int random_seed = absl::GetFlag(FLAGS_random_seed);
+
+  if (dataset.empty()) {
+    std::cerr << "Missing --dataset\n";
+    return 1;
+  }
+  if (block_rows <= 0) {
+    std::cerr << "block_rows should be positive\n";
+    return 1;
+  }
+
+  std::cout << "# dataset: " << dataset << "\n";
+  std::cout << "# elf_filename: " << elf_filename << "\n";
+  std::cout << "# mu: " << mu << "\n";
+  std::cout << "# phi: " << phi << "\n";
+  std::cout << "# lambda: " << lambda << "\n";
+  std::cout << "# evaluations_per_program: " << evaluations_per_program << "\n";
+  std::cout << "# max_generations: " << max_generations << "\n";
+  std::cout << "# block_rows: " << block_rows << "\n";
+  std::cout << "# release_blocks: " << std::boolalpha << release_blocks
+            << "\n";
+  std::cout << "# output_filename_prefix: " << output_filename_prefix << "\n";
+  std::cout << "# random_seed: " << random_seed << "\n";
+  std::cout << std::flush;
+
+  viaevo::Random gen;
+  gen.Seed(random_seed);
+
+  std::shared_ptr<viaevo::MutatorPointRandom> mutator_point =
+      std::make_shared<viaevo::MutatorPointRandom>(gen);
+  std::shared_ptr<viaevo::MutatorRecombineRandom> mutator_recombine =
+      std::make_shared<viaevo::MutatorRecombineRandom>(gen);
+  std::shared_ptr<viaevo::MutatorRecombinePlainElf>
+      mutator_recombine_plain_elf =
+          std::make_shared<viaevo::MutatorRecombinePlainElf>(gen, elf_filename);
+  std::shared_ptr<viaevo::MutatorPointLastInstruction>
+      mutator_last_instruction =
+          std::make_shared<viaevo::MutatorPointLastInstruction>(gen);
+
+  viaevo::MutatorCompositeWeighted mutator_composite(gen);
+  mutator_composite.AppendMutator(mutator_point, 1.0);
+  mutator_composite.AppendMutator(mutator_recombine, 1.0);
+  mutator_composite.AppendMutator(mutator_recombine_plain_elf, 1.0);
+  mutator_composite.AppendMutator(mutator_last_instruction, 7.0);
+
+  viaevo::ScorerTabular scorer(gen, dataset, block_rows, release_blocks);
+  std::cout << "# rows: " << scorer.dataset().num_rows() << "\n";
+  std::cout << "# max_score: " << scorer.MaxScore() << "\n";
+  std::cout << std::flush;
+
+  viaevo::EvolverAdHoc evolver(elf_filename, mu, phi, lambda, scorer,
+                               mutator_composite, gen,
+                               evaluations_per_program, max_generations,
+                               /*score_results_history=*/false,
+                               output_filename_prefix);
+  evolver.Run();
+
+  return 0;
+}
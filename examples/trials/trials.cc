@@ -0,0 +1,402 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+
+// TODO: Remove relative paths.
+#include "../../evolver/evolver_adhoc.h"
+#include "../../mutator/mutator_composite_adaptive.h"
+#include "../../mutator/mutator_composite_weighted.h"
+#include "../../mutator/mutator_dictionary.h"
+#include "../../mutator/mutator_instruction_field.h"
+#include "../../mutator/mutator_instruction_replace.h"
+#include "../../mutator/mutator_mask_burst.h"
+#include "../../mutator/mutator_mask_poisson.h"
+#include "../../mutator/mutator_mask_window.h"
+#include "../../mutator/mutator_point_covered.h"
+#include "../../mutator/mutator_point_last_instruction.h"
+#include "../../mutator/mutator_point_random.h"
+#include "../../mutator/mutator_recombine_aligned.h"
+#include "../../mutator/mutator_recombine_covered.h"
+#include "../../mutator/mutator_recombine_plain_elf.h"
+#include "../../mutator/mutator_recombine_random.h"
+#include "../../util/random.h"
+#include "../../util/worker_pool.h"
+#include "../000_guess_value/scorer_guess_value.h"
+#include "../001_copy_value/scorer_copy_value.h"
+#include "../002_double_value/scorer_double_value.h"
+#include "../010_sum_two/scorer_sum_two.h"
+#include "../100_mnist_digits/scorer_mnist_digits.h"
+
+ABSL_FLAG(std::string, task, "guess_value",
+          "evolution task: 'guess_value', 'copy_value', 'double_value', "
+          "'sum_two' or 'mnist_digits' (the settings of each task match the "
+          "defaults of the corresponding example's main)");
+ABSL_FLAG(int32_t, num_trials, 10,
+          "number of evolution trials (each with a different random seed)");
+ABSL_FLAG(uint32_t, first_random_seed, 1,
+          "random seed of the first trial (trials use consecutive seeds)");
+ABSL_FLAG(int32_t, num_threads, 0,
+          "number of trials running concurrently (0 for the number of "
+          "hardware threads)");
+ABSL_FLAG(int32_t, max_generations, 0,
+          "maximum number of generations for each trial (0 for the task's "
+          "default)");
+ABSL_FLAG(std::string, output_filename_prefix, "",
+          "prefix to prepend to output file names (each trial writes "
+          "<prefix>rs_<seed>.log and its evolved elfs with the "
+          "<prefix>rs_<seed>_ prefix)");
+ABSL_FLAG(bool, batch_mutation, false,
+          "create all offspring of a generation in one batch from an arena of "
+          "the parents' code (each offspring draws from its own random "
+          "stream)");
+ABSL_FLAG(std::string, recombination, "random",
+          "recombination of two parents' code: 'random' (byte-aligned random "
+          "ranges), 'aligned' (ranges of whole instructions) or 'homologous' "
+          "(ranges of whole instructions at the same position in both "
+          "parents)");
+ABSL_FLAG(bool, prescreen, false,
+          "statically reject (and re-mutate) offspring certain to fault in the "
+          "mutated instructions before executing them");
+ABSL_FLAG(bool, instruction_mutators, false,
+          "also mutate opcodes, operands and immediates of decoded x86-64 "
+          "instructions and replace instructions with instructions of the "
+          "same length (each with weight 1)");
+ABSL_FLAG(bool, coverage_mutators, false,
+          "trace the instructions executed by each new program once and add "
+          "a bit flip and a recombination within the executed code (each with "
+          "weight 1)");
+ABSL_FLAG(bool, dictionary_mutator, false,
+          "also insert or replace sequences of instructions harvested from "
+          "offspring that improved on their parents (weight 1)");
+ABSL_FLAG(bool, mask_mutators, false,
+          "also flip a Poisson-distributed number of random bits, flip a "
+          "burst of contiguous bits and randomize a window of bytes (each "
+          "with weight 1)");
+ABSL_FLAG(bool, adaptive_mutator_rates, false,
+          "re-weight the mutators in each generation based on how often their "
+          "offspring survive the selection and improve on their parents");
+ABSL_FLAG(int32_t, value_to_guess, 42, "value to guess for task guess_value");
+ABSL_FLAG(int32_t, num_value_copies_in_inputs, 10,
+          "number of value copies in inputs for tasks copy_value and "
+          "double_value");
+
+namespace {
+
+// TrialResult summarizes a single evolution trial.
+struct TrialResult {
+  unsigned int random_seed = 0;
+  bool reached_max_score = false;
+  int generations = 0;
+  long long best_score = 0;
+  double seconds = 0.0;
+};
+
+// Settings of a trial for a specific task.
+struct TaskSettings {
+  std::string elf_filename;
+  int mu = 60;
+  int phi = 10;
+  int lambda = 140;
+  int evaluations_per_program = 10;
+  int max_generations = 1000;
+  bool score_results_history = false;
+  // Append MutatorRecombinePlainElf for plain_elf_filename (if not empty).
+  std::string plain_elf_filename;
+  // Weight of MutatorPointLastInstruction in the composite mutator (the other
+  // mutators have weight 1.0).
+  double last_instruction_weight = 1.0;
+  // Mutator options shared by all tasks (set from the flags).
+  bool instruction_mutators = false;
+  bool coverage_mutators = false;
+  bool dictionary_mutator = false;
+  bool mask_mutators = false;
+  bool adaptive_mutator_rates = false;
+  // 'random', 'aligned' or 'homologous' (see the recombination flag).
+  std::string recombination = "random";
+  bool prescreen = false;
+  bool batch_mutation = false;
+};
+
+// Returns the settings for task or false if task is unknown.
+bool GetTaskSettings(const std::string &task, TaskSettings &settings) {
+  if (task == "guess_value" || task == "copy_value" ||
+      task == "double_value") {
+    settings.elf_filename = "elfs/simple_small";
+  } else if (task == "sum_two") {
+    settings.elf_filename = "elfs/intermediate_small";
+    settings.max_generations = 1'000'000;
+    settings.plain_elf_filename = "elfs/intermediate_small";
+    settings.last_instruction_weight = 7.0;
+  } else if (task == "mnist_digits") {
+    settings.elf_filename = "elfs/intermediate_medium";
+    settings.evaluations_per_program = 200;
+    settings.max_generations = 10'000;
+    settings.score_results_history = true;
+    settings.plain_elf_filename = "elfs/intermediate_medium";
+    settings.last_instruction_weight = 7.0;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<viaevo::Scorer> CreateScorer(const std::string &task,
+                                             viaevo::Random &gen) {
+  if (task == "guess_value")
+    return std::unique_ptr<viaevo::Scorer>(
+        new viaevo::ScorerGuessValue(absl::GetFlag(FLAGS_value_to_guess)));
+  if (task == "copy_value")
+    return std::unique_ptr<viaevo::Scorer>(new viaevo::ScorerCopyValue(
+        gen, absl::GetFlag(FLAGS_num_value_copies_in_inputs)));
+  if (task == "double_value")
+    return std::unique_ptr<viaevo::Scorer>(new viaevo::ScorerDoubleValue(
+        gen, absl::GetFlag(FLAGS_num_value_copies_in_inputs)));
+  if (task == "sum_two")
+    return std::unique_ptr<viaevo::Scorer>(new viaevo::ScorerSumTwo(gen, 50));
+  return std::unique_ptr<viaevo::Scorer>(new viaevo::ScorerMnistDigits(
+      gen, "examples/100_mnist_digits/data/train-images-idx3-ubyte",
+      "examples/100_mnist_digits/data/train-labels-idx1-ubyte"));
+}
+
+// Runs a single evolution trial with random_seed. All objects except for the
+// memoized template data in Program are owned by the trial, so trials can run
+// concurrently.
+TrialResult RunTrial(const std::string &task, const TaskSettings &settings,
+                     unsigned int random_seed, const std::string &prefix) {
+  auto start = std::chrono::steady_clock::now();
+  std::string trial_prefix = prefix + "rs_" + std::to_string(random_seed);
+  std::ofstream log(trial_prefix + ".log");
+
+  viaevo::Random gen;
+  gen.Seed(random_seed);
+
+  std::unique_ptr<viaevo::MutatorCompositeWeighted> mutator_composite(
+      settings.adaptive_mutator_rates
+          ? new viaevo::MutatorCompositeAdaptive(gen)
+          : new viaevo::MutatorCompositeWeighted(gen));
+  mutator_composite->AppendMutator(
+      std::make_shared<viaevo::MutatorPointRandom>(gen), 1.0);
+  if (settings.recombination == "random") {
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorRecombineRandom>(gen), 1.0);
+  } else {
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorRecombineAligned>(
+            gen, settings.recombination == "homologous"),
+        1.0);
+  }
+  if (!settings.plain_elf_filename.empty()) {
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorRecombinePlainElf>(
+            gen, settings.plain_elf_filename),
+        1.0);
+  }
+  mutator_composite->AppendMutator(
+      std::make_shared<viaevo::MutatorPointLastInstruction>(gen),
+      settings.last_instruction_weight);
+  if (settings.instruction_mutators) {
+    for (auto field : {viaevo::MutatorInstructionField::kOpcode,
+                       viaevo::MutatorInstructionField::kOperands,
+                       viaevo::MutatorInstructionField::kImmediate}) {
+      mutator_composite->AppendMutator(
+          std::make_shared<viaevo::MutatorInstructionField>(gen, field), 1.0);
+    }
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorInstructionReplace>(gen), 1.0);
+  }
+  if (settings.coverage_mutators) {
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorPointCovered>(gen), 1.0);
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorRecombineCovered>(gen), 1.0);
+  }
+  if (settings.dictionary_mutator) {
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorDictionary>(gen), 1.0);
+  }
+  if (settings.mask_mutators) {
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorMaskPoisson>(gen), 1.0);
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorMaskBurst>(gen), 1.0);
+    mutator_composite->AppendMutator(
+        std::make_shared<viaevo::MutatorMaskWindow>(gen), 1.0);
+  }
+
+  std::unique_ptr<viaevo::Scorer> scorer = CreateScorer(task, gen);
+
+  log << "# task: " << task << "\n";
+  log << "# random_seed: " << random_seed << "\n" << std::flush;
+
+  viaevo::EvolverAdHoc evolver(
+      settings.elf_filename, settings.mu, settings.phi, settings.lambda,
+      *scorer, *mutator_composite, gen, settings.evaluations_per_program,
+      settings.max_generations, settings.score_results_history,
+      trial_prefix + "_");
+  evolver.set_output_stream(log, false);
+  evolver.set_prescreen(settings.prescreen);
+  evolver.set_coverage(settings.coverage_mutators);
+  evolver.set_batch_mutation(settings.batch_mutation, random_seed);
+  evolver.Run();
+
+  TrialResult result;
+  result.random_seed = random_seed;
+  result.reached_max_score = evolver.reached_max_score();
+  result.generations = evolver.current_generation();
+  result.best_score = evolver.best_overall_score();
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
+
+// Prints a table with a row for each trial followed by the success rate and
+// statistics of generations to reach the maximum score.
+void PrintSummary(const std::vector<TrialResult> &results) {
+  std::cout << "\n  seed |   result | generations |           best score |"
+               "     time (s)\n";
+  std::vector<int> generations_to_max;
+  for (auto &result : results) {
+    std::cout << std::setw(6) << result.random_seed << " | "
+              << std::setw(8) << (result.reached_max_score ? "max" : "not max")
+              << " | " << std::setw(11) << result.generations << " | "
+              << std::setw(20) << result.best_score << " | " << std::setw(12)
+              << std::fixed << std::setprecision(1) << result.seconds << "\n";
+    if (result.reached_max_score)
+      generations_to_max.push_back(result.generations);
+  }
+
+  std::cout << "\nsuccess rate: " << generations_to_max.size() << "/"
+            << results.size() << " (" << std::setprecision(1)
+            << (results.empty() ? 0.0
+                                : 100.0 * generations_to_max.size() /
+                                      results.size())
+            << "%)\n";
+  if (generations_to_max.empty())
+    return;
+  std::sort(generations_to_max.begin(), generations_to_max.end());
+  double mean = 0.0;
+  for (int generations : generations_to_max)
+    mean += generations;
+  mean /= generations_to_max.size();
+  int n = generations_to_max.size();
+  double median =
+      n % 2 == 1 ? generations_to_max[n / 2]
+                 : (generations_to_max[n / 2 - 1] + generations_to_max[n / 2]) /
+                       2.0;
+  std::cout << "generations to max score: min " << generations_to_max.front()
+            << " | median " << median << " | mean " << mean << " | max "
+            << generations_to_max.back() << "\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  absl::SetProgramUsageMessage(
+      "This program runs multiple evolution trials (with different random "
+      "seeds) of one of the examples concurrently and summarizes the success "
+      "rate of the trials.\n\nWARNING: The evolution produces invalid "
+      "executables. To protect your system, always run this program in a "
+      "sandbox!\n\nSample usage via the bazel build system (with 'build "
+      "--spawn_strategy=linux-sandbox' in .bazelrc):\n\nbazel run "
+      "//examples/trials:viaevo_trials -- --task=copy_value --num_trials=100");
+
+  absl::ParseCommandLine(argc, argv);
+
+  std::string task = absl::GetFlag(FLAGS_task);
+  int num_trials = absl::GetFlag(FLAGS_num_trials);
+  unsigned int first_random_seed = absl::GetFlag(FLAGS_first_random_seed);
+  int num_threads = absl::GetFlag(FLAGS_num_threads);
+  int max_generations = absl::GetFlag(FLAGS_max_generations);
+  std::string output_filename_prefix =
+      absl::GetFlag(FLAGS_output_filename_prefix);
+
+  TaskSettings settings;
+  if (!GetTaskSettings(task, settings)) {
+    std::cerr << "Unknown task: " << task << "\n";
+    return 1;
+  }
+  settings.instruction_mutators = absl::GetFlag(FLAGS_instruction_mutators);
+  settings.coverage_mutators = absl::GetFlag(FLAGS_coverage_mutators);
+  settings.dictionary_mutator = absl::GetFlag(FLAGS_dictionary_mutator);
+  settings.mask_mutators = absl::GetFlag(FLAGS_mask_mutators);
+  settings.adaptive_mutator_rates = absl::GetFlag(FLAGS_adaptive_mutator_rates);
+  settings.recombination = absl::GetFlag(FLAGS_recombination);
+  if (settings.recombination != "random" &&
+      settings.recombination != "aligned" &&
+      settings.recombination != "homologous") {
+    std::cerr << "Unknown recombination: " << settings.recombination << "\n";
+    return 1;
+  }
+  settings.prescreen = absl::GetFlag(FLAGS_prescreen);
+  settings.batch_mutation = absl::GetFlag(FLAGS_batch_mutation);
+  if (max_generations > 0)
+    settings.max_generations = max_generations;
+  if (num_threads <= 0)
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "# task: " << task << "\n";
+  std::cout << "# num_trials: " << num_trials << "\n";
+  std::cout << "# first_random_seed: " << first_random_seed << "\n";
+  std::cout << "# num_threads: " << num_threads << "\n";
+  std::cout << "# elf_filename: " << settings.elf_filename << "\n";
+  std::cout << "# max_generations: " << settings.max_generations << "\n";
+  std::cout << "# output_filename_prefix: " << output_filename_prefix << "\n";
+  std::cout << "# instruction_mutators: " << std::boolalpha
+            << settings.instruction_mutators << "\n";
+  std::cout << "# coverage_mutators: " << std::boolalpha
+            << settings.coverage_mutators << "\n";
+  std::cout << "# dictionary_mutator: " << std::boolalpha
+            << settings.dictionary_mutator << "\n";
+  std::cout << "# mask_mutators: " << std::boolalpha << settings.mask_mutators
+            << "\n";
+  std::cout << "# adaptive_mutator_rates: " << std::boolalpha
+            << settings.adaptive_mutator_rates << "\n";
+  std::cout << "# recombination: " << settings.recombination << "\n";
+  std::cout << "# prescreen: " << std::boolalpha << settings.prescreen << "\n";
+  std::cout << "# batch_mutation: " << std::boolalpha << settings.batch_mutation
+            << "\n";
+  std::cout << std::flush;
+
+  std::vector<TrialResult> results(num_trials);
+  std::mutex cout_mutex;
+  int finished_trials = 0;
+  {
+    viaevo::WorkerPool pool(num_threads);
+    for (int i = 0; i < num_trials; ++i) {
+      pool.Submit([&, i] {
+        results[i] = RunTrial(task, settings, first_random_seed + i,
+                              output_filename_prefix);
+        std::lock_guard<std::mutex> lock(cout_mutex);
+        ++finished_trials;
+        std::cout << "trial " << finished_trials << " of " << num_trials
+                  << " finished (random seed: " << results[i].random_seed
+                  << ", " << (results[i].reached_max_score ? "max" : "not max")
+                  << " score in " << results[i].generations
+                  << " generations)\n"
+                  << std::flush;
+      });
+    }
+    pool.Wait();
+  }
+
+  PrintSummary(results);
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "genome_arena.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+namespace viaevo {
+
+void GenomeArena::Reset(int num_genomes, size_t genome_size) {
+  genome_size_ = genome_size;
+  data_.resize(num_genomes * genome_size);
+  last_rip_offsets_.assign(num_genomes, -1);
+  coverage_size_ = (genome_size + 7) / 8;
+  coverage_.resize(num_genomes * coverage_size_);
+  has_coverage_.assign(num_genomes, false);
+}
+
+void GenomeArena::Load(int index, const Program &program) {
+  assert(program.elf_code_size() == genome_size_ &&
+         "program's code size should match genome_size_");
+  program.ReadElfCode(code(index));
+  last_rip_offsets_[index] = program.last_rip_offset();
+  has_coverage_[index] = program.has_coverage();
+  if (has_coverage_[index])
+    std::copy(program.coverage().begin(), program.coverage().end(),
+              coverage_.begin() + index * coverage_size_);
+}
+
+void GenomeArena::Store(int index, Program &program) const {
+  assert(program.elf_code_size() == genome_size_ &&
+         "program's code size should match genome_size_");
+  program.WriteElfCode(code(index));
+}
+
+Genome GenomeArena::genome(int index) const {
+  Genome genome;
+  genome.code = code(index);
+  genome.size = genome_size_;
+  genome.last_rip_offset = last_rip_offsets_[index];
+  if (has_coverage_[index])
+    genome.coverage = coverage_.data() + index * coverage_size_;
+  return genome;
+}
+
+} // namespace viaevo
@@ -0,0 +1,76 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_GENOME_ARENA_H_
+#define VIAEVO_MUTATOR_GENOME_ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+// TODO: Remove relative path.
+#include "../program/program.h"
+
+namespace viaevo {
+
+// Genome is a read-only view of a program's evolvable code together with the
+// state of its last execution used by mutators.
+struct Genome {
+  const char *code = nullptr;
+  size_t size = 0;
+  unsigned long long last_rip_offset = -1;
+  // Bitmap of the offsets of the instructions executed by the program (see
+  // Program::coverage), nullptr if the program has no coverage.
+  const uint8_t *coverage = nullptr;
+
+  bool IsCovered(size_t offset) const {
+    return coverage && offset < size &&
+           (coverage[offset / 8] >> (offset % 8) & 1);
+  }
+};
+
+// GenomeArena stores the evolvable code (genomes) of a set of programs in one
+// contiguous buffer (genome i starts at i * genome_size()) so that a batch of
+// offspring can be created without reading the parents' code from their ELF
+// memory files for each offspring (see Mutator::MutateBatch).
+class GenomeArena {
+public:
+  // Resizes the arena to num_genomes genomes of genome_size bytes each. The
+  // contents of the genomes are unspecified.
+  void Reset(int num_genomes, size_t genome_size);
+
+  // Copies program's evolvable code (and its last rip offset and coverage) to
+  // genome index.
+  void Load(int index, const Program &program);
+  // Writes genome index to program's evolvable code.
+  void Store(int index, Program &program) const;
+
+  char *code(int index) { return data_.data() + index * genome_size_; }
+  const char *code(int index) const {
+    return data_.data() + index * genome_size_;
+  }
+  Genome genome(int index) const;
+  void set_last_rip_offset(int index, unsigned long long last_rip_offset) {
+    last_rip_offsets_[index] = last_rip_offset;
+  }
+  void ClearCoverage(int index) { has_coverage_[index] = false; }
+
+  int num_genomes() const { return last_rip_offsets_.size(); }
+  size_t genome_size() const { return genome_size_; }
+
+protected:
+  size_t genome_size_ = 0;
+  std::vector<char> data_;
+  std::vector<unsigned long long> last_rip_offsets_;
+  // Coverage bitmaps of all genomes (coverage_size_ bytes each).
+  size_t coverage_size_ = 0;
+  std::vector<uint8_t> coverage_;
+  std::vector<char> has_coverage_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_GENOME_ARENA_H_
@@ -0,0 +1,47 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "genome_arena.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(GenomeArenaTest, LoadStore) {
+  std::shared_ptr<viaevo::Program> program1 =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> program2 =
+      viaevo::Program::Create("elfs/simple_small");
+  program2->SetElfCodeToAllNops();
+  size_t size = program1->elf_code_size();
+  ASSERT_EQ(program1->GetElfCode().size(), size);
+
+  viaevo::GenomeArena arena;
+  arena.Reset(2, size);
+  EXPECT_EQ(arena.num_genomes(), 2);
+  EXPECT_EQ(arena.genome_size(), size);
+  arena.Load(0, *program1);
+  arena.Load(1, *program2);
+  EXPECT_EQ(arena.code(1), arena.code(0) + size);
+  EXPECT_EQ(std::vector<char>(arena.code(0), arena.code(0) + size),
+            program1->GetElfCode());
+  EXPECT_EQ(std::vector<char>(arena.code(1), arena.code(1) + size),
+            program2->GetElfCode());
+
+  viaevo::Genome genome = arena.genome(0);
+  EXPECT_EQ(genome.code, arena.code(0));
+  EXPECT_EQ(genome.size, size);
+  EXPECT_EQ(genome.last_rip_offset, program1->last_rip_offset());
+  arena.set_last_rip_offset(0, 7);
+  EXPECT_EQ(arena.genome(0).last_rip_offset, 7);
+
+  arena.code(0)[0] = (char)0x90;
+  arena.Store(0, *program2);
+  std::vector<char> expected = program1->GetElfCode();
+  expected[0] = (char)0x90;
+  EXPECT_EQ(program2->GetElfCode(), expected);
+}
+
+} // namespace
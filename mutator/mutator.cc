@@ -0,0 +1,102 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <future>
+
+namespace viaevo {
+
+constexpr uint32_t Mutator::kMutationPurpose;
+
+void Mutator::MutateGenome(char *target, const Genome &parent1,
+                           const Genome &parent2, Random &gen) {
+  // Also fails with NDEBUG (the offspring would silently remain a copy of
+  // parent1).
+  fprintf(stderr, "MutateGenome is not implemented by the mutator\n");
+  exit(EXIT_FAILURE);
+}
+
+void Mutator::MutateBatch(const GenomeArena &parents,
+                          const std::vector<MutationSlot> &slots,
+                          GenomeArena &offspring, const RandomStream &streams,
+                          uint32_t generation, WorkerPool *pool) {
+  assert(parents.genome_size() == offspring.genome_size() &&
+         "parents and offspring should have the same genome size");
+  PrepareBatch();
+  auto mutate_slots = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      RandomStream gen = streams.Derive(generation, i, kMutationPurpose);
+      MutateSlot(i, parents, slots[i], offspring, gen);
+    }
+  };
+  if (!pool || pool->num_threads() <= 1 || slots.size() < 2) {
+    mutate_slots(0, slots.size());
+    return;
+  }
+  // A few chunks per thread to balance mutators of different costs.
+  size_t num_chunks = std::min(slots.size(), (size_t)pool->num_threads() * 4);
+  std::vector<std::future<void>> chunks;
+  for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+    size_t begin = slots.size() * chunk / num_chunks;
+    size_t end = slots.size() * (chunk + 1) / num_chunks;
+    chunks.push_back(
+        pool->Submit([&mutate_slots, begin, end] { mutate_slots(begin, end); }));
+  }
+  for (auto &chunk : chunks)
+    chunk.get();
+}
+
+void Mutator::MutateSlot(size_t index, const GenomeArena &parents,
+                         const MutationSlot &slot, GenomeArena &offspring,
+                         Random &gen) {
+  MutateGenome(InitializeSlotTarget(parents, slot, offspring),
+               parents.genome(slot.parent1), parents.genome(slot.parent2), gen);
+}
+
+char *Mutator::InitializeSlotTarget(const GenomeArena &parents,
+                                    const MutationSlot &slot,
+                                    GenomeArena &offspring) {
+  char *target = offspring.code(slot.target);
+  memcpy(target, parents.code(slot.parent1), parents.genome_size());
+  offspring.set_last_rip_offset(slot.target, -1);
+  offspring.ClearCoverage(slot.target);
+  return target;
+}
+
+void Mutator::MutateViaGenome(std::shared_ptr<Program> target,
+                              std::shared_ptr<Program> parent1,
+                              std::shared_ptr<Program> parent2, Random &gen,
+                              bool read_parent2) {
+  std::vector<char> code1 = parent1->GetElfCode();
+  std::vector<char> code2;
+  if (read_parent2 && parent2 != parent1)
+    code2 = parent2->GetElfCode();
+  Genome genome1;
+  genome1.code = code1.data();
+  genome1.size = code1.size();
+  genome1.last_rip_offset = parent1->last_rip_offset();
+  if (parent1->has_coverage())
+    genome1.coverage = parent1->coverage().data();
+  Genome genome2 = genome1;
+  if (!code2.empty()) {
+    genome2.code = code2.data();
+    genome2.size = code2.size();
+    genome2.last_rip_offset = parent2->last_rip_offset();
+    genome2.coverage =
+        parent2->has_coverage() ? parent2->coverage().data() : nullptr;
+  }
+  std::vector<char> code = code1;
+  MutateGenome(code.data(), genome1, genome2, gen);
+  target->SetElfCode(code);
+}
+
+} // namespace viaevo
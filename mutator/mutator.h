@@ -6,13 +6,46 @@
 #ifndef VIAEVO_MUTATOR_MUTATOR_H_
 #define VIAEVO_MUTATOR_MUTATOR_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
+#include <vector>
+
+#include "genome_arena.h"
 
-// TODO: Remove relative path.
+// TODO: Remove relative paths.
 #include "../program/program.h"
+#include "../util/random.h"
+#include "../util/random_stream.h"
+#include "../util/worker_pool.h"
 
 namespace viaevo {
 
+// MutationOutcome describes the fate of an offspring (target of Mutate) after
+// it was evaluated and the parents of the next generation were selected.
+struct MutationOutcome {
+  std::shared_ptr<Program> target;
+  // The parent1 passed to Mutate for target. Its code is unchanged when the
+  // outcomes are passed to Update.
+  std::shared_ptr<Program> parent1;
+  // The offspring was selected as a parent of the next generation.
+  bool survived = false;
+  // The offspring scored higher than its parent1.
+  bool improved = false;
+};
+
+// MutationSlot describes an offspring created by MutateBatch: genome target of
+// the offspring arena is created from genomes parent1 and parent2 of the
+// parents arena. target_program (optional) is the Program the offspring will
+// be stored to (e.g. to attribute the outcomes passed to Update).
+struct MutationSlot {
+  int target = 0;
+  int parent1 = 0;
+  int parent2 = 0;
+  const Program *target_program = nullptr;
+};
+
 // Mutator is an abstract base class defining the interface to change Program's
 // evolvable code.
 class Mutator {
@@ -22,6 +55,54 @@ public:
   virtual void Mutate(std::shared_ptr<Program> target,
                       std::shared_ptr<Program> parent1,
                       std::shared_ptr<Program> parent2) = 0;
+  // Called by the evolver with the outcomes of the offspring of a generation
+  // (e.g. to adapt the rates of mutation operators). Does nothing by default.
+  virtual void Update(const std::vector<MutationOutcome> &outcomes) {}
+
+  // Creates new code in target (of parent1.size bytes, initialized to a copy
+  // of parent1's code) like Mutate, but draws the random numbers from gen
+  // instead of the mutator's random number generator. Mutate and MutateGenome
+  // create the same code from the same random numbers. Must be safe to call
+  // concurrently (for different targets) after PrepareBatch. Not implemented
+  // by default (exits with an error).
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen);
+  // Prepares the mutator (and the mutators it delegates to) for concurrent
+  // MutateGenome calls. Does nothing by default.
+  virtual void PrepareBatch() {}
+  // Creates offspring.code(slot.target) for each slot of slots via
+  // MutateGenome. slots[i] draws its random numbers from
+  // streams.Derive(generation, i, kMutationPurpose), i.e. the offspring do not
+  // depend on the order in which the slots are processed. With pool, the slots
+  // are processed on pool's threads (the call returns when all offspring are
+  // created).
+  virtual void MutateBatch(const GenomeArena &parents,
+                           const std::vector<MutationSlot> &slots,
+                           GenomeArena &offspring, const RandomStream &streams,
+                           uint32_t generation, WorkerPool *pool = nullptr);
+
+  // Purpose of the random streams passed to MutateGenome by MutateBatch (see
+  // RandomStream::Derive).
+  static constexpr uint32_t kMutationPurpose = 1;
+
+protected:
+  // Creates offspring.code(slot.target) for slots[index] (called by MutateBatch
+  // for each slot, possibly concurrently).
+  virtual void MutateSlot(size_t index, const GenomeArena &parents,
+                          const MutationSlot &slot, GenomeArena &offspring,
+                          Random &gen);
+  // Copies parent1's genome to the slot's target genome and returns the target
+  // genome's code.
+  static char *InitializeSlotTarget(const GenomeArena &parents,
+                                    const MutationSlot &slot,
+                                    GenomeArena &offspring);
+  // Mutates target via MutateGenome with gen (helper for the implementations of
+  // Mutate). parent2's code is read only if read_parent2 is true (parent1's
+  // genome is passed as parent2 otherwise).
+  void MutateViaGenome(std::shared_ptr<Program> target,
+                       std::shared_ptr<Program> parent1,
+                       std::shared_ptr<Program> parent2, Random &gen,
+                       bool read_parent2 = true);
 };
 
 } // namespace viaevo
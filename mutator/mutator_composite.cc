@@ -5,6 +5,8 @@
 
 #include "mutator_composite.h"
 
+#include <algorithm>
+
 namespace viaevo {
 
 void MutatorComposite::Mutate(std::shared_ptr<Program> target,
@@ -13,6 +15,27 @@ void MutatorComposite::Mutate(std::shared_ptr<Program> target,
   GetMutator()->Mutate(target, parent1, parent2);
 }
 
+void MutatorComposite::Update(const std::vector<MutationOutcome> &outcomes) {
+  // The same mutator may be appended multiple times.
+  for (auto it = mutators_.begin(); it != mutators_.end(); ++it) {
+    if (std::find(mutators_.begin(), it, *it) == it)
+      (*it)->Update(outcomes);
+  }
+}
+
+void MutatorComposite::MutateGenome(char *target, const Genome &parent1,
+                                    const Genome &parent2, Random &gen) {
+  mutators_[SelectMutatorIndex(gen)]->MutateGenome(target, parent1, parent2,
+                                                   gen);
+}
+
+void MutatorComposite::PrepareBatch() {
+  for (auto it = mutators_.begin(); it != mutators_.end(); ++it) {
+    if (std::find(mutators_.begin(), it, *it) == it)
+      (*it)->PrepareBatch();
+  }
+}
+
 void MutatorComposite::AppendMutator(std::shared_ptr<Mutator> mutator) {
   mutators_.push_back(mutator);
 }
@@ -22,11 +22,21 @@ public:
                       std::shared_ptr<Program> parent1,
                       std::shared_ptr<Program> parent2) override;
 
+  // Forwards the outcomes to the (distinct) mutators in mutators_.
+  virtual void Update(const std::vector<MutationOutcome> &outcomes) override;
+
+  // Selects a mutator from mutators_ with random numbers from gen and forwards
+  // to its MutateGenome.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
+  // Forwards to the (distinct) mutators in mutators_.
+  virtual void PrepareBatch() override;
+
   // Appends a mutator to mutators_.
-  void AppendMutator(std::shared_ptr<Mutator> mutator);
+  virtual void AppendMutator(std::shared_ptr<Mutator> mutator);
 
   // Clears mutators_.
-  void Clear();
+  virtual void Clear();
 
 protected:
   std::vector<std::shared_ptr<Mutator>> mutators_;
@@ -34,6 +44,10 @@ protected:
   // The virtual function GetMutator is intended to define the behavior of
   // derived classes in terms of selecting a specific a mutator from mutators_.
   virtual std::shared_ptr<Mutator> GetMutator() = 0;
+  // Returns the index of a mutator in mutators_ selected with random numbers
+  // from gen (the same selection GetMutator makes with the same random
+  // numbers). Must be safe to call concurrently after PrepareBatch.
+  virtual int SelectMutatorIndex(Random &gen) = 0;
 };
 
 } // namespace viaevo
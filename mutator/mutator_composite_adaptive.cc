@@ -0,0 +1,78 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_composite_adaptive.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+namespace viaevo {
+
+MutatorCompositeAdaptive::MutatorCompositeAdaptive(Random &gen,
+                                                   double adaptation_rate,
+                                                   double min_probability,
+                                                   double survival_credit,
+                                                   double improvement_credit)
+    : MutatorCompositeWeighted(gen), adaptation_rate_(adaptation_rate),
+      min_probability_(min_probability), survival_credit_(survival_credit),
+      improvement_credit_(improvement_credit) {
+  assert(adaptation_rate_ > 0.0 && adaptation_rate_ <= 1.0 &&
+         "adaptation_rate should be in (0, 1]");
+  assert(min_probability_ >= 0.0 && "min_probability should be non-negative");
+}
+
+void MutatorCompositeAdaptive::Update(
+    const std::vector<MutationOutcome> &outcomes) {
+  int n = mutators_.size();
+  if (n > 0) {
+    // Start at the normalized weights (also after appending mutators).
+    if (static_cast<int>(qualities_.size()) != n) {
+      qualities_.resize(n);
+      for (int i = 0; i < n; ++i)
+        qualities_[i] = probability(i);
+    }
+
+    std::vector<double> credits(n, 0.0);
+    std::vector<int> counts(n, 0);
+    for (auto &outcome : outcomes) {
+      auto it = target_mutators_.find(outcome.target.get());
+      if (it == target_mutators_.end())
+        continue;
+      ++counts[it->second];
+      if (outcome.survived)
+        credits[it->second] += survival_credit_;
+      if (outcome.improved)
+        credits[it->second] += improvement_credit_;
+    }
+
+    // Mutators without offspring in this generation keep their quality.
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+      if (counts[i] > 0) {
+        qualities_[i] +=
+            adaptation_rate_ * (credits[i] / counts[i] - qualities_[i]);
+      }
+      sum += qualities_[i];
+    }
+
+    double min_probability = std::min(min_probability_, 1.0 / n);
+    for (int i = 0; i < n; ++i) {
+      weights_[i] = min_probability + (1.0 - n * min_probability) *
+                                          (sum > 0.0 ? qualities_[i] / sum
+                                                     : 1.0 / n);
+    }
+    alias_table_dirty_ = true;
+  }
+
+  MutatorComposite::Update(outcomes);
+}
+
+void MutatorCompositeAdaptive::Clear() {
+  MutatorCompositeWeighted::Clear();
+  qualities_.clear();
+}
+
+} // namespace viaevo
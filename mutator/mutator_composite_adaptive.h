@@ -0,0 +1,56 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_COMPOSITE_ADAPTIVE_H_
+#define VIAEVO_MUTATOR_MUTATOR_COMPOSITE_ADAPTIVE_H_
+
+#include "mutator_composite_weighted.h"
+
+#include <vector>
+
+namespace viaevo {
+
+// MutatorCompositeAdaptive is a MutatorCompositeWeighted that re-weights its
+// mutators in each Update based on the outcomes of their offspring (adaptive
+// operator selection via probability matching). Each offspring earns
+// survival_credit if it survives the selection and improvement_credit if it
+// scores higher than its parent1. The quality of a mutator is an exponential
+// recency-weighted average of the mean credit of its offspring and the
+// mutators are selected with probabilities
+//   min_probability + (1 - n * min_probability) * quality / sum of qualities
+// where n is the number of mutators, i.e. no mutator is ever abandoned. The
+// qualities start at the normalized weights the mutators were appended with.
+class MutatorCompositeAdaptive : public MutatorCompositeWeighted {
+public:
+  MutatorCompositeAdaptive(Random &gen, double adaptation_rate = 0.2,
+                           double min_probability = 0.05,
+                           double survival_credit = 1.0,
+                           double improvement_credit = 1.0);
+
+  // Updates the qualities of the mutators and their weights based on outcomes
+  // and forwards outcomes to the mutators.
+  virtual void Update(const std::vector<MutationOutcome> &outcomes) override;
+
+  virtual void Clear() override;
+
+  const std::vector<double> &qualities() const { return qualities_; }
+
+protected:
+  // Weight of the mean credit of the current generation in the qualities (in
+  // (0, 1]).
+  double adaptation_rate_ = 0.2;
+  // Minimal probability of selecting each mutator (reduced to 1 / n for n
+  // mutators if larger).
+  double min_probability_ = 0.05;
+  double survival_credit_ = 1.0;
+  double improvement_credit_ = 1.0;
+
+  // Quality of each mutator in mutators_.
+  std::vector<double> qualities_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_COMPOSITE_ADAPTIVE_H_
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_composite_adaptive.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "mutator_mock.h"
+
+// TODO: Remove relative path.
+#include "../util/random_mock.h"
+
+namespace {
+
+TEST(MutatorCompositeAdaptiveTest, Update) {
+  std::shared_ptr<viaevo::Program> target1 =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> target2 =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> target3 =
+      viaevo::Program::Create("elfs/simple_small");
+
+  auto mutator1 = std::make_shared<viaevo::MutatorMock>();
+  auto mutator2 = std::make_shared<viaevo::MutatorMock>();
+
+  // Selects mutator1 for target1 and mutator2 for target2 and target3.
+  viaevo::RandomMock gen({0, 0, 1, 0, 1, 0});
+  viaevo::MutatorCompositeAdaptive mutator_composite(gen, 0.2, 0.05);
+  mutator_composite.AppendMutator(mutator1);
+  mutator_composite.AppendMutator(mutator2);
+  mutator_composite.Mutate(target1, target1, target1);
+  mutator_composite.Mutate(target2, target2, target2);
+  mutator_composite.Mutate(target3, target3, target3);
+  EXPECT_EQ(mutator1->mutate_calls(), 1);
+  EXPECT_EQ(mutator2->mutate_calls(), 2);
+
+  // target1 survived and improved (credit 2.0), target2 survived (credit 1.0)
+  // and target3 neither (credit 0.0).
+  std::vector<viaevo::MutationOutcome> outcomes(3);
+  outcomes[0].target = target1;
+  outcomes[0].survived = true;
+  outcomes[0].improved = true;
+  outcomes[1].target = target2;
+  outcomes[1].survived = true;
+  outcomes[2].target = target3;
+  mutator_composite.Update(outcomes);
+
+  // Qualities start at 0.5 and move 0.2 towards the mean credits 2.0 and 0.5.
+  ASSERT_EQ(mutator_composite.qualities().size(), 2);
+  EXPECT_DOUBLE_EQ(mutator_composite.qualities()[0], 0.8);
+  EXPECT_DOUBLE_EQ(mutator_composite.qualities()[1], 0.5);
+  EXPECT_DOUBLE_EQ(mutator_composite.probability(0),
+                   0.05 + 0.9 * 0.8 / 1.3);
+  EXPECT_DOUBLE_EQ(mutator_composite.probability(1),
+                   0.05 + 0.9 * 0.5 / 1.3);
+
+  EXPECT_EQ(mutator1->update_calls(), 1);
+  EXPECT_EQ(mutator2->update_calls(), 1);
+}
+
+TEST(MutatorCompositeAdaptiveTest, MinProbability) {
+  std::shared_ptr<viaevo::Program> target1 =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> target2 =
+      viaevo::Program::Create("elfs/simple_small");
+
+  auto mutator1 = std::make_shared<viaevo::MutatorMock>();
+  auto mutator2 = std::make_shared<viaevo::MutatorMock>();
+
+  viaevo::RandomMock gen({0, 0, 1, 0});
+  viaevo::MutatorCompositeAdaptive mutator_composite(gen, 1.0, 0.1);
+  mutator_composite.AppendMutator(mutator1);
+  mutator_composite.AppendMutator(mutator2);
+  mutator_composite.Mutate(target1, target1, target1);
+  mutator_composite.Mutate(target2, target2, target2);
+
+  // Only the offspring of mutator1 pays off, mutator2 keeps min_probability.
+  std::vector<viaevo::MutationOutcome> outcomes(2);
+  outcomes[0].target = target1;
+  outcomes[0].survived = true;
+  outcomes[1].target = target2;
+  mutator_composite.Update(outcomes);
+  EXPECT_DOUBLE_EQ(mutator_composite.probability(0), 0.9);
+  EXPECT_DOUBLE_EQ(mutator_composite.probability(1), 0.1);
+}
+
+} // namespace
@@ -12,7 +12,11 @@ MutatorCompositeRandom::MutatorCompositeRandom(Random &gen) : gen_(gen) {}
 std::shared_ptr<Mutator> MutatorCompositeRandom::GetMutator() {
   // TODO: Add myfail when mutators_ are empty. Also update the message in the
   // test's EXPECT_DEATH.
-  return mutators_[gen_() % mutators_.size()];
+  return mutators_[SelectMutatorIndex(gen_)];
+}
+
+int MutatorCompositeRandom::SelectMutatorIndex(Random &gen) {
+  return gen() % mutators_.size();
 }
 
 } // namespace viaevo
@@ -26,6 +26,7 @@ protected:
 
   // Selects a mutator from mutators_ at random with equal probability.
   virtual std::shared_ptr<Mutator> GetMutator();
+  virtual int SelectMutatorIndex(Random &gen) override;
 };
 
 } // namespace viaevo
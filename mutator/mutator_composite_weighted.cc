@@ -0,0 +1,101 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_composite_weighted.h"
+
+#include <assert.h>
+
+namespace viaevo {
+
+MutatorCompositeWeighted::MutatorCompositeWeighted(Random &gen) : gen_(gen) {}
+
+void MutatorCompositeWeighted::Mutate(std::shared_ptr<Program> target,
+                                      std::shared_ptr<Program> parent1,
+                                      std::shared_ptr<Program> parent2) {
+  int index = SelectMutatorIndex();
+  target_mutators_[target.get()] = index;
+  mutators_[index]->Mutate(target, parent1, parent2);
+}
+
+void MutatorCompositeWeighted::AppendMutator(std::shared_ptr<Mutator> mutator) {
+  AppendMutator(mutator, 1.0);
+}
+
+void MutatorCompositeWeighted::AppendMutator(std::shared_ptr<Mutator> mutator,
+                                             double weight) {
+  assert(weight >= 0.0 && "weight should be non-negative");
+  MutatorComposite::AppendMutator(mutator);
+  weights_.push_back(weight);
+  alias_table_dirty_ = true;
+}
+
+void MutatorCompositeWeighted::Clear() {
+  MutatorComposite::Clear();
+  weights_.clear();
+  target_mutators_.clear();
+  alias_table_dirty_ = true;
+}
+
+double MutatorCompositeWeighted::probability(int index) {
+  if (alias_table_dirty_) {
+    alias_table_.Reset(weights_);
+    alias_table_dirty_ = false;
+  }
+  return alias_table_.probability(index);
+}
+
+int MutatorCompositeWeighted::SelectMutatorIndex() {
+  return SelectMutatorIndex(gen_);
+}
+
+int MutatorCompositeWeighted::SelectMutatorIndex(Random &gen) {
+  assert(!mutators_.empty() && "mutators_ should not be empty");
+  if (alias_table_dirty_) {
+    alias_table_.Reset(weights_);
+    alias_table_dirty_ = false;
+  }
+  return alias_table_.Sample(gen);
+}
+
+void MutatorCompositeWeighted::PrepareBatch() {
+  assert(!mutators_.empty() && "mutators_ should not be empty");
+  if (alias_table_dirty_) {
+    alias_table_.Reset(weights_);
+    alias_table_dirty_ = false;
+  }
+  MutatorComposite::PrepareBatch();
+}
+
+void MutatorCompositeWeighted::MutateBatch(
+    const GenomeArena &parents, const std::vector<MutationSlot> &slots,
+    GenomeArena &offspring, const RandomStream &streams, uint32_t generation,
+    WorkerPool *pool) {
+  slot_mutators_.assign(slots.size(), -1);
+  MutatorComposite::MutateBatch(parents, slots, offspring, streams, generation,
+                                pool);
+  for (size_t i = 0; i < slots.size(); ++i) {
+    if (slots[i].target_program)
+      target_mutators_[slots[i].target_program] = slot_mutators_[i];
+  }
+}
+
+void MutatorCompositeWeighted::MutateSlot(size_t index,
+                                          const GenomeArena &parents,
+                                          const MutationSlot &slot,
+                                          GenomeArena &offspring,
+                                          Random &gen) {
+  int mutator_index = SelectMutatorIndex(gen);
+  slot_mutators_[index] = mutator_index;
+  mutators_[mutator_index]->MutateGenome(InitializeSlotTarget(parents, slot,
+                                                              offspring),
+                                         parents.genome(slot.parent1),
+                                         parents.genome(slot.parent2), gen);
+}
+
+std::shared_ptr<Mutator> MutatorCompositeWeighted::GetMutator() {
+  return mutators_[SelectMutatorIndex()];
+}
+
+} // namespace viaevo
@@ -0,0 +1,87 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_COMPOSITE_WEIGHTED_H_
+#define VIAEVO_MUTATOR_MUTATOR_COMPOSITE_WEIGHTED_H_
+
+#include "mutator_composite.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// TODO: Remove relative paths.
+#include "../util/alias_table.h"
+#include "../util/random.h"
+
+namespace viaevo {
+
+// MutatorCompositeWeighted will select a mutator from mutators_ at random with
+// probability proportional to the mutator's weight. The selection takes O(1)
+// time regardless of the number of mutators (see AliasTable).
+class MutatorCompositeWeighted : public MutatorComposite {
+public:
+  MutatorCompositeWeighted(Random &gen);
+
+  // Selects a mutator, mutates target and remembers the selected mutator for
+  // target (see target_mutators_).
+  virtual void Mutate(std::shared_ptr<Program> target,
+                      std::shared_ptr<Program> parent1,
+                      std::shared_ptr<Program> parent2) override;
+
+  // Builds the alias table and prepares the mutators.
+  virtual void PrepareBatch() override;
+  // Mutates the slots and remembers the selected mutator for the slots'
+  // target_program (if set, see target_mutators_).
+  virtual void MutateBatch(const GenomeArena &parents,
+                           const std::vector<MutationSlot> &slots,
+                           GenomeArena &offspring, const RandomStream &streams,
+                           uint32_t generation,
+                           WorkerPool *pool = nullptr) override;
+
+  // Appends a mutator with weight 1.0.
+  virtual void AppendMutator(std::shared_ptr<Mutator> mutator) override;
+  // Appends a mutator with weight (non-negative).
+  void AppendMutator(std::shared_ptr<Mutator> mutator, double weight);
+
+  // Clears mutators_ and their weights.
+  virtual void Clear() override;
+
+  // Probability of selecting mutators_[index].
+  double probability(int index);
+
+protected:
+  // Random number genrator.
+  Random &gen_;
+
+  // Weights of mutators_ and the alias table for sampling them (rebuilt when
+  // weights_ change).
+  std::vector<double> weights_;
+  AliasTable alias_table_;
+  bool alias_table_dirty_ = true;
+
+  // Index of the mutator in mutators_ that created the current code of each
+  // target (e.g. to credit the mutators for the outcomes of their offspring).
+  std::unordered_map<const Program *, int> target_mutators_;
+
+  // Index of the mutator selected for each slot by the last MutateBatch.
+  std::vector<int> slot_mutators_;
+
+  // Returns the index of a mutator from mutators_ selected at random according
+  // to weights_ (with random numbers from gen_ or gen).
+  int SelectMutatorIndex();
+  virtual int SelectMutatorIndex(Random &gen) override;
+  // Selects a mutator for slots[index] and records it in slot_mutators_.
+  virtual void MutateSlot(size_t index, const GenomeArena &parents,
+                          const MutationSlot &slot, GenomeArena &offspring,
+                          Random &gen) override;
+
+  // Selects a mutator from mutators_ at random according to weights_.
+  virtual std::shared_ptr<Mutator> GetMutator() override;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_COMPOSITE_WEIGHTED_H_
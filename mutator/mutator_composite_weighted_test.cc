@@ -0,0 +1,86 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_composite_weighted.h"
+
+#include <gtest/gtest-death-test.h>
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "mutator_mock.h"
+
+// TODO: Remove relative path.
+#include "../util/random_mock.h"
+
+namespace {
+
+TEST(MutatorCompositeWeightedTest, Mutate) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+
+  auto mutator1 = std::make_shared<viaevo::MutatorMock>();
+  auto mutator2 = std::make_shared<viaevo::MutatorMock>();
+  auto mutator3 = std::make_shared<viaevo::MutatorMock>();
+
+  viaevo::RandomMock gen({0, 0, 1, 0, 2, 4294967295});
+  viaevo::MutatorCompositeWeighted mutator_composite(gen);
+  mutator_composite.AppendMutator(mutator1, 1.0);
+  mutator_composite.AppendMutator(mutator2, 0.0);
+  mutator_composite.AppendMutator(mutator3, 2.0);
+
+  EXPECT_DOUBLE_EQ(mutator_composite.probability(0), 1.0 / 3.0);
+  EXPECT_DOUBLE_EQ(mutator_composite.probability(1), 0.0);
+  EXPECT_DOUBLE_EQ(mutator_composite.probability(2), 2.0 / 3.0);
+
+  // Column 0 (mutator1), column 1 (mutator2 with weight 0.0 is always
+  // replaced by its alias mutator3), column 2 (mutator3).
+  mutator_composite.Mutate(target, target, target);
+  mutator_composite.Mutate(target, target, target);
+  mutator_composite.Mutate(target, target, target);
+  EXPECT_EQ(mutator1->mutate_calls(), 1);
+  EXPECT_EQ(mutator2->mutate_calls(), 0);
+  EXPECT_EQ(mutator3->mutate_calls(), 2);
+
+  // Expect death when executing Mutate and mutators_ is empty.
+  mutator_composite.Clear();
+  EXPECT_DEATH(mutator_composite.Mutate(target, target, target),
+               "mutators_ should not be empty");
+}
+
+TEST(MutatorCompositeWeightedTest, Frequencies) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+
+  auto mutator1 = std::make_shared<viaevo::MutatorMock>();
+  auto mutator2 = std::make_shared<viaevo::MutatorMock>();
+
+  viaevo::Random gen;
+  gen.Seed(1);
+  viaevo::MutatorCompositeWeighted mutator_composite(gen);
+  // Same as appending mutator2 seven times to MutatorCompositeRandom.
+  mutator_composite.AppendMutator(mutator1);
+  mutator_composite.AppendMutator(mutator2, 7.0);
+  for (int i = 0; i < 8000; ++i)
+    mutator_composite.Mutate(target, target, target);
+  EXPECT_NEAR(mutator1->mutate_calls(), 1000, 150);
+  EXPECT_NEAR(mutator2->mutate_calls(), 7000, 150);
+}
+
+TEST(MutatorCompositeWeightedTest, UpdateIsForwardedOnce) {
+  auto mutator1 = std::make_shared<viaevo::MutatorMock>();
+  auto mutator2 = std::make_shared<viaevo::MutatorMock>();
+
+  viaevo::RandomMock gen({0});
+  viaevo::MutatorCompositeWeighted mutator_composite(gen);
+  mutator_composite.AppendMutator(mutator1);
+  mutator_composite.AppendMutator(mutator2);
+  mutator_composite.AppendMutator(mutator2);
+
+  mutator_composite.Update({});
+  EXPECT_EQ(mutator1->update_calls(), 1);
+  EXPECT_EQ(mutator2->update_calls(), 1);
+}
+
+} // namespace
@@ -0,0 +1,158 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_dictionary.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "mutator_instruction_replace.h"
+
+// TODO: Remove relative path.
+#include "../x86/instruction_decoder.h"
+
+namespace viaevo {
+
+namespace {
+
+// True for nop (0x90 other than xchg with r8) and multi-byte nop (0x0f 0x1f).
+bool IsNop(const DecodedInstruction &instruction) {
+  return (instruction.map == 0 && instruction.opcode == 0x90 &&
+          !(instruction.rex & 1)) ||
+         (instruction.map == 1 && instruction.opcode == 0x1f);
+}
+
+} // namespace
+
+MutatorDictionary::MutatorDictionary(Random &gen, int max_entries,
+                                     int max_length)
+    : MutatorPointRandom(gen), max_entries_(max_entries),
+      max_length_(max_length) {
+  assert(max_entries_ >= 1 && "max_entries should be at least 1");
+  assert(max_length_ >= 1 && "max_length should be at least 1");
+}
+
+void MutatorDictionary::Mutate(std::shared_ptr<Program> target,
+                               std::shared_ptr<Program> parent1,
+                               std::shared_ptr<Program> parent2) {
+  PrepareBatch();
+  MutateViaGenome(target, parent1, parent2, gen_, false);
+}
+
+void MutatorDictionary::MutateGenome(char *target, const Genome &parent1,
+                                     const Genome &parent2, Random &gen) {
+  if (entries_.empty()) {
+    MutatorPointRandom::MutateGenome(target, parent1, parent2, gen);
+    return;
+  }
+  assert(!alias_table_dirty_ &&
+         "PrepareBatch should be called after the dictionary changes");
+
+  const std::string &entry = entries_[alias_table_.Sample(gen)];
+  mt_type::result_type random_numbers[2];
+  gen.Fill(random_numbers, 2);
+
+  std::vector<DecodedInstruction> instructions =
+      InstructionDecoder::DecodeAll(parent1.code, parent1.size);
+  size_t index = random_numbers[0] % instructions.size();
+  size_t position = instructions[index].offset;
+  size_t length = std::min(entry.size(), parent1.size - position);
+
+  if (random_numbers[1] % 2 == 0) {
+    // Insert.
+    memmove(target + position + length, target + position,
+            parent1.size - position - length);
+    memcpy(target + position, entry.data(), length);
+    return;
+  }
+
+  // Replace.
+  memcpy(target + position, entry.data(), length);
+  size_t end = position + length;
+  while (index < instructions.size() && instructions[index].offset < end)
+    ++index;
+  size_t boundary =
+      index < instructions.size() ? instructions[index].offset : parent1.size;
+  if (boundary > end)
+    MutatorInstructionReplace::WriteNop(target + end, boundary - end);
+}
+
+void MutatorDictionary::Update(const std::vector<MutationOutcome> &outcomes) {
+  for (auto &outcome : outcomes) {
+    if (!outcome.improved || !outcome.target || !outcome.parent1)
+      continue;
+    Harvest(outcome.target->GetElfCode(), outcome.parent1->GetElfCode());
+  }
+  PrepareBatch();
+}
+
+void MutatorDictionary::PrepareBatch() {
+  if (!alias_table_dirty_)
+    return;
+  std::vector<double> weights(counts_.begin(), counts_.end());
+  alias_table_.Reset(weights);
+  alias_table_dirty_ = false;
+}
+
+void MutatorDictionary::AddEntry(const std::string &entry) {
+  alias_table_dirty_ = true;
+  auto it = entry_indices_.find(entry);
+  if (it != entry_indices_.end()) {
+    ++counts_[it->second];
+    return;
+  }
+  if ((int)entries_.size() < max_entries_) {
+    entry_indices_[entry] = entries_.size();
+    entries_.push_back(entry);
+    counts_.push_back(1);
+    return;
+  }
+  int index = std::min_element(counts_.begin(), counts_.end()) - counts_.begin();
+  entry_indices_.erase(entries_[index]);
+  entry_indices_[entry] = index;
+  entries_[index] = entry;
+  ++counts_[index];
+}
+
+int MutatorDictionary::FindEntry(const std::string &entry) const {
+  auto it = entry_indices_.find(entry);
+  return it == entry_indices_.end() ? -1 : it->second;
+}
+
+void MutatorDictionary::Harvest(const std::vector<char> &code,
+                                const std::vector<char> &parent_code) {
+  if (code.size() != parent_code.size())
+    return;
+  // The range of bytes that differ from parent_code.
+  size_t first = 0;
+  while (first < code.size() && code[first] == parent_code[first])
+    ++first;
+  if (first == code.size())
+    return;
+  size_t last = code.size();
+  while (code[last - 1] == parent_code[last - 1])
+    --last;
+
+  std::vector<DecodedInstruction> instructions =
+      InstructionDecoder::DecodeAll(code);
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    if (instructions[i].offset >= last)
+      break;
+    size_t start = instructions[i].offset;
+    bool all_nops = true;
+    for (size_t j = i; j < instructions.size() && j < i + max_length_; ++j) {
+      if (!instructions[j].valid)
+        break;
+      all_nops = all_nops && IsNop(instructions[j]);
+      size_t end = instructions[j].offset + instructions[j].length;
+      if (end > first && !all_nops)
+        AddEntry(std::string(code.data() + start, end - start));
+    }
+  }
+}
+
+} // namespace viaevo
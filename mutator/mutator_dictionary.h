@@ -0,0 +1,85 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_DICTIONARY_H_
+#define VIAEVO_MUTATOR_MUTATOR_DICTIONARY_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mutator_point_random.h"
+
+// TODO: Remove relative paths.
+#include "../util/alias_table.h"
+#include "../util/random.h"
+
+namespace viaevo {
+
+// MutatorDictionary creates new code for target based on parent1 (parent2 is
+// ignored) by writing a sequence of instructions from a dictionary at a random
+// instruction boundary of parent1's code. The sequence either replaces
+// parent1's instructions (the remaining bytes of a partially overwritten
+// instruction are overwritten with a nop) or is inserted (the following code is
+// shifted towards the end, the bytes shifted past the end are dropped). Without
+// dictionary entries, reverts to MutatorPointRandom behavior. The code of
+// parent1 is not changed.
+//
+// The dictionary is harvested in Update from the offspring that improved on
+// their parent1: all sequences of 1 to max_length valid decoded instructions
+// of the offspring's code overlapping the bytes that differ from parent1's code
+// (other than sequences of nops) are counted. Only the offspring of the last
+// generation are decoded (the population is not rescanned). The dictionary
+// keeps at most max_entries sequences. When it is full, a new sequence replaces
+// the sequence with the lowest count and inherits its count (the Space-Saving
+// algorithm, i.e. frequent sequences are kept). Sequences are sampled with
+// probability proportional to their counts.
+class MutatorDictionary : public MutatorPointRandom {
+public:
+  MutatorDictionary(Random &gen, int max_entries = 1024, int max_length = 4);
+  // Creates new code for target based on the description above.
+  virtual void Mutate(std::shared_ptr<Program> target,
+                      std::shared_ptr<Program> parent1,
+                      std::shared_ptr<Program> parent2) override;
+  // Same as Mutate, drawing random numbers from gen.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
+  // Harvests the improved offspring of outcomes (see above).
+  virtual void Update(const std::vector<MutationOutcome> &outcomes) override;
+  // Rebuilds the alias table if the dictionary changed.
+  virtual void PrepareBatch() override;
+
+  // Counts entry (a sequence of instructions) in the dictionary.
+  void AddEntry(const std::string &entry);
+
+  int num_entries() const { return entries_.size(); }
+  const std::string &entry(int index) const { return entries_[index]; }
+  long long count(int index) const { return counts_[index]; }
+  // Index of entry in the dictionary or -1.
+  int FindEntry(const std::string &entry) const;
+
+protected:
+  // Counts the sequences of code overlapping the bytes that differ from
+  // parent_code.
+  void Harvest(const std::vector<char> &code,
+               const std::vector<char> &parent_code);
+
+  int max_entries_ = 1024;
+  int max_length_ = 4;
+
+  // The dictionary: entries_[i] was counted counts_[i] times.
+  std::vector<std::string> entries_;
+  std::vector<long long> counts_;
+  std::unordered_map<std::string, int> entry_indices_;
+
+  // Alias table for sampling entries_ by counts_ (rebuilt by PrepareBatch and
+  // Mutate when the dictionary changed).
+  AliasTable alias_table_;
+  bool alias_table_dirty_ = false;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_DICTIONARY_H_
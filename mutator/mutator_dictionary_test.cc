@@ -0,0 +1,124 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_dictionary.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+// TODO: Remove relative path.
+#include "../util/random_mock.h"
+
+namespace {
+
+const std::string kMov("\xb8\x01\x00\x00\x00", 5); // mov eax, 1
+const std::string kAdd("\x01\xc0", 2);             // add eax, eax
+
+TEST(MutatorDictionaryTest, Update) {
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+
+  std::vector<char> code(parent->elf_code_size(), '\x90');
+  parent->SetElfCode(code);
+  std::copy(kMov.begin(), kMov.end(), code.begin() + 100);
+  std::copy(kAdd.begin(), kAdd.end(), code.begin() + 105);
+  target->SetElfCode(code);
+
+  viaevo::RandomMock gen;
+  viaevo::MutatorDictionary mutator(gen, 1024, 2);
+
+  std::vector<viaevo::MutationOutcome> outcomes(1);
+  outcomes[0].target = target;
+  outcomes[0].parent1 = parent;
+  mutator.Update(outcomes);
+  EXPECT_EQ(mutator.num_entries(), 0)
+      << "Offspring that did not improve should not be harvested";
+
+  outcomes[0].improved = true;
+  mutator.Update(outcomes);
+  // nop + mov, mov, mov + add, add, add + nop (sequences of nops are skipped).
+  EXPECT_EQ(mutator.num_entries(), 5);
+  for (const std::string &entry :
+       {"\x90" + kMov, kMov, kMov + kAdd, kAdd, kAdd + "\x90"}) {
+    int index = mutator.FindEntry(entry);
+    ASSERT_NE(index, -1);
+    EXPECT_EQ(mutator.count(index), 1);
+  }
+
+  mutator.Update(outcomes);
+  EXPECT_EQ(mutator.num_entries(), 5);
+  EXPECT_EQ(mutator.count(mutator.FindEntry(kMov)), 2);
+}
+
+TEST(MutatorDictionaryTest, AddEntryBounded) {
+  viaevo::RandomMock gen;
+  viaevo::MutatorDictionary mutator(gen, 2);
+
+  mutator.AddEntry("a");
+  mutator.AddEntry("a");
+  mutator.AddEntry("b");
+  // The full dictionary replaces the entry with the lowest count.
+  mutator.AddEntry("c");
+  EXPECT_EQ(mutator.num_entries(), 2);
+  EXPECT_EQ(mutator.FindEntry("b"), -1);
+  EXPECT_EQ(mutator.count(mutator.FindEntry("a")), 2);
+  EXPECT_EQ(mutator.count(mutator.FindEntry("c")), 2);
+}
+
+TEST(MutatorDictionaryTest, MutateGenome) {
+  // 32 add instructions (2 bytes each).
+  std::vector<char> code;
+  for (int i = 0; i < 32; ++i)
+    code.insert(code.end(), kAdd.begin(), kAdd.end());
+
+  viaevo::Genome genome;
+  genome.code = code.data();
+  genome.size = code.size();
+
+  // Without entries, a single bit flip.
+  viaevo::RandomMock gen({8 * 8});
+  viaevo::MutatorDictionary mutator(gen);
+  std::vector<char> target = code;
+  mutator.MutateGenome(target.data(), genome, genome, gen);
+  std::vector<char> expected = code;
+  expected[8] ^= 1;
+  EXPECT_EQ(target, expected);
+
+  mutator.AddEntry(kMov);
+  mutator.PrepareBatch();
+
+  // Replace at instruction 5 (offset 10). The add at offset 14 is partially
+  // overwritten and its remaining byte is replaced with a nop.
+  gen.set_values({0, 0, 5, 1});
+  target = code;
+  mutator.MutateGenome(target.data(), genome, genome, gen);
+  expected = code;
+  std::copy(kMov.begin(), kMov.end(), expected.begin() + 10);
+  expected[15] = '\x90';
+  EXPECT_EQ(target, expected);
+
+  // Insert at instruction 5 (offset 10).
+  gen.set_values({0, 0, 5, 0});
+  target = code;
+  mutator.MutateGenome(target.data(), genome, genome, gen);
+  expected = code;
+  expected.insert(expected.begin() + 10, kMov.begin(), kMov.end());
+  expected.resize(code.size());
+  EXPECT_EQ(target, expected);
+
+  // Truncated at the end of the code.
+  gen.set_values({0, 0, 31, 1});
+  target = code;
+  mutator.MutateGenome(target.data(), genome, genome, gen);
+  expected = code;
+  expected[62] = kMov[0];
+  expected[63] = kMov[1];
+  EXPECT_EQ(target, expected);
+}
+
+} // namespace
@@ -0,0 +1,96 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_instruction_field.h"
+
+#include <stdint.h>
+
+// TODO: Remove relative path.
+#include "../x86/instruction_decoder.h"
+
+namespace viaevo {
+
+MutatorInstructionField::MutatorInstructionField(Random &gen, Field field)
+    : MutatorPointRandom(gen), field_(field) {}
+
+void MutatorInstructionField::Mutate(std::shared_ptr<Program> target,
+                                     std::shared_ptr<Program> parent1,
+                                     std::shared_ptr<Program> parent2) {
+  MutateViaGenome(target, parent1, parent2, gen_, false);
+}
+
+void MutatorInstructionField::MutateGenome(char *target, const Genome &parent1,
+                                           const Genome &parent2,
+                                           Random &gen) {
+  char *code = target;
+  std::vector<DecodedInstruction> instructions =
+      InstructionDecoder::DecodeAll(code, parent1.size);
+
+  std::vector<const DecodedInstruction *> candidates;
+  for (auto &instruction : instructions) {
+    if (!instruction.valid)
+      continue;
+    if ((field_ == kOpcode) ||
+        (field_ == kOperands && instruction.modrm_offset != -1) ||
+        (field_ == kImmediate && instruction.immediate_size > 0))
+      candidates.push_back(&instruction);
+  }
+  if (candidates.empty()) {
+    MutatorPointRandom::MutateGenome(target, parent1, parent2, gen);
+    return;
+  }
+  const DecodedInstruction &instruction =
+      *candidates[gen() % candidates.size()];
+
+  if (field_ == kImmediate) {
+    char *immediate = code + instruction.offset + instruction.immediate_offset;
+    auto random_number = gen();
+    if (random_number & 1) {
+      // Little-endian increment/decrement (by -8 to -1 or 1 to 8) truncated to
+      // the size of the immediate.
+      int delta = (int)((random_number >> 1) % 16) - 8;
+      if (delta >= 0)
+        ++delta;
+      uint64_t value = 0;
+      for (int i = instruction.immediate_size - 1; i >= 0; --i)
+        value = (value << 8) | (uint8_t)immediate[i];
+      value += delta;
+      for (int i = 0; i < instruction.immediate_size; ++i)
+        immediate[i] = (char)(value >> (8 * i));
+    } else {
+      for (int i = 0; i < instruction.immediate_size; ++i) {
+        if (i % 4 == 0)
+          random_number = gen();
+        immediate[i] = (char)(random_number >> (8 * (i % 4)));
+      }
+    }
+    return;
+  }
+
+  // Opcode or a byte of ModRM, SIB and displacement.
+  int first = instruction.opcode_offset;
+  int size = 1;
+  if (field_ == kOperands) {
+    first = instruction.modrm_offset;
+    size = 1 + (instruction.sib_offset != -1 ? 1 : 0) +
+           instruction.displacement_size;
+  }
+  for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+    size_t pos = instruction.offset + first + (size > 1 ? gen() % size : 0);
+    char old_byte = code[pos];
+    code[pos] = (char)gen();
+    DecodedInstruction mutated;
+    if (code[pos] != old_byte &&
+        InstructionDecoder::Decode(code + instruction.offset,
+                                   parent1.size - instruction.offset,
+                                   mutated) &&
+        mutated.length == instruction.length)
+      return;
+    code[pos] = old_byte;
+  }
+  MutatorPointRandom::MutateGenome(target, parent1, parent2, gen);
+}
+
+} // namespace viaevo
@@ -0,0 +1,49 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_INSTRUCTION_FIELD_H_
+#define VIAEVO_MUTATOR_MUTATOR_INSTRUCTION_FIELD_H_
+
+#include "mutator_point_random.h"
+
+namespace viaevo {
+
+// MutatorInstructionField creates new code for target based on parent1
+// (parent2 is ignored). Parent1's code is decoded into x86-64 instructions
+// (see InstructionDecoder) and a field of a random instruction having the field
+// is changed:
+// - kOpcode: the opcode byte is replaced by a random byte,
+// - kOperands: a random byte of ModRM, SIB or the displacement is replaced by a
+//   random byte,
+// - kImmediate: the immediate is either incremented/decremented by 1 to 8 or
+//   replaced by a random value.
+// Opcode and operand changes are retried (up to kMaxAttempts times) until the
+// changed instruction decodes to a valid instruction of the same length, i.e.
+// the boundaries of the following instructions are preserved. If no
+// instruction has the field or all attempts fail, reverts to MutatorPointRandom
+// behavior (random bit flip anywhere in the mutable code).
+class MutatorInstructionField : public MutatorPointRandom {
+public:
+  enum Field { kOpcode, kOperands, kImmediate };
+
+  MutatorInstructionField(Random &gen, Field field);
+  // Creates new code for target based on parent1 with a changed instruction
+  // field.
+  virtual void Mutate(std::shared_ptr<Program> target,
+                      std::shared_ptr<Program> parent1,
+                      std::shared_ptr<Program> parent2) override;
+  // Same as Mutate, drawing random numbers from gen.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
+
+protected:
+  static constexpr int kMaxAttempts = 16;
+
+  Field field_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_INSTRUCTION_FIELD_H_
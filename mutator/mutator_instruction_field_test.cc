@@ -0,0 +1,110 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_instruction_field.h"
+
+#include <gtest/gtest.h>
+
+// TODO: Remove relative path.
+#include "../util/random_mock.h"
+
+namespace {
+
+// The evolvable code of simple_small starts with:
+//   0: 55                            push rbp
+//   1: 48 89 e5                      mov rbp, rsp
+//   4: c7 05 xx xx xx xx 14 00 00 00 mov dword ptr [rip + xx], 0x14
+
+TEST(MutatorInstructionFieldTest, MutateOpcode) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // Selects the first instruction and replaces push rbp with push rbx.
+  viaevo::RandomMock gen({0, 0x53});
+  viaevo::MutatorInstructionField mutator(
+      gen, viaevo::MutatorInstructionField::kOpcode);
+  mutator.Mutate(target, parent, parent);
+
+  std::vector<char> parent_code = parent->GetElfCode();
+  std::vector<char> target_code = target->GetElfCode();
+  EXPECT_EQ(target_code[0], 0x53);
+  target_code[0] = parent_code[0];
+  EXPECT_EQ(parent_code, target_code);
+}
+
+TEST(MutatorInstructionFieldTest, MutateOpcodeSameLength) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // Selects the first instruction. The opcode 0x06 (invalid) and 0x01 (add
+  // with ModRM, i.e. a different length) are rejected, 0x5b (pop rbx) is
+  // accepted.
+  viaevo::RandomMock gen({0, 0x06, 0x01, 0x5b});
+  viaevo::MutatorInstructionField mutator(
+      gen, viaevo::MutatorInstructionField::kOpcode);
+  mutator.Mutate(target, parent, parent);
+
+  std::vector<char> parent_code = parent->GetElfCode();
+  std::vector<char> target_code = target->GetElfCode();
+  EXPECT_EQ(target_code[0], 0x5b);
+  target_code[0] = parent_code[0];
+  EXPECT_EQ(parent_code, target_code);
+}
+
+TEST(MutatorInstructionFieldTest, MutateOperands) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // Selects the first instruction with ModRM (mov rbp, rsp) and replaces
+  // ModRM to obtain mov rsp, rbp.
+  viaevo::RandomMock gen({0, 0xec});
+  viaevo::MutatorInstructionField mutator(
+      gen, viaevo::MutatorInstructionField::kOperands);
+  mutator.Mutate(target, parent, parent);
+
+  std::vector<char> parent_code = parent->GetElfCode();
+  std::vector<char> target_code = target->GetElfCode();
+  EXPECT_EQ(target_code[3], '\xec');
+  target_code[3] = parent_code[3];
+  EXPECT_EQ(parent_code, target_code);
+}
+
+TEST(MutatorInstructionFieldTest, MutateImmediate) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // Selects the first instruction with an immediate and decrements the
+  // immediate by 6 (odd random number 5 with (5 >> 1) % 16 - 8 = -6).
+  viaevo::RandomMock gen({0, 5});
+  viaevo::MutatorInstructionField mutator(
+      gen, viaevo::MutatorInstructionField::kImmediate);
+  mutator.Mutate(target, parent, parent);
+
+  std::vector<char> parent_code = parent->GetElfCode();
+  std::vector<char> target_code = target->GetElfCode();
+  EXPECT_EQ(target_code[10], 0x14 - 6);
+  target_code[10] = parent_code[10];
+  EXPECT_EQ(parent_code, target_code);
+
+  // Replaces the immediate with a random value (even random number followed
+  // by the value).
+  gen.set_values({0, 2, 0x12345678});
+  mutator.Mutate(target, parent, parent);
+  target_code = target->GetElfCode();
+  EXPECT_EQ(target_code[10], 0x78);
+  EXPECT_EQ(target_code[11], 0x56);
+  EXPECT_EQ(target_code[12], 0x34);
+  EXPECT_EQ(target_code[13], 0x12);
+}
+
+} // namespace
@@ -0,0 +1,75 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_instruction_replace.h"
+
+#include <string.h>
+
+// TODO: Remove relative path.
+#include "../x86/instruction_decoder.h"
+
+namespace viaevo {
+
+namespace {
+// Recommended multi-byte nops of lengths 1 to 9 (Intel SDM, NOP instruction).
+const char *const kNops[] = {
+    "\x90",
+    "\x66\x90",
+    "\x0f\x1f\x00",
+    "\x0f\x1f\x40\x00",
+    "\x0f\x1f\x44\x00\x00",
+    "\x66\x0f\x1f\x44\x00\x00",
+    "\x0f\x1f\x80\x00\x00\x00\x00",
+    "\x0f\x1f\x84\x00\x00\x00\x00\x00",
+    "\x66\x0f\x1f\x84\x00\x00\x00\x00\x00",
+};
+} // namespace
+
+MutatorInstructionReplace::MutatorInstructionReplace(Random &gen)
+    : gen_(gen) {}
+
+void MutatorInstructionReplace::Mutate(std::shared_ptr<Program> target,
+                                       std::shared_ptr<Program> parent1,
+                                       std::shared_ptr<Program> parent2) {
+  MutateViaGenome(target, parent1, parent2, gen_, false);
+}
+
+void MutatorInstructionReplace::MutateGenome(char *target,
+                                             const Genome &parent1,
+                                             const Genome &parent2,
+                                             Random &gen) {
+  std::vector<DecodedInstruction> instructions =
+      InstructionDecoder::DecodeAll(target, parent1.size);
+  if (instructions.empty())
+    return;
+  const DecodedInstruction &instruction =
+      instructions[gen() % instructions.size()];
+
+  int length = instruction.length;
+  // 4 random bytes from each random number (at most 15 bytes).
+  mt_type::result_type random_numbers[4];
+  char candidate[InstructionDecoder::kMaxInstructionLength];
+  for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+    gen.Fill(random_numbers, (length + 3) / 4);
+    for (int i = 0; i < length; ++i)
+      candidate[i] = (char)(random_numbers[i / 4] >> (8 * (i % 4)));
+    DecodedInstruction replacement;
+    if (InstructionDecoder::Decode(candidate, length, replacement) &&
+        replacement.length == length) {
+      memcpy(target + instruction.offset, candidate, length);
+      return;
+    }
+  }
+  WriteNop(target + instruction.offset, length);
+}
+
+void MutatorInstructionReplace::WriteNop(char *code, int length) {
+  // Longer nops are the 9 byte nop with additional operand size prefixes.
+  int prefixes = length > 9 ? length - 9 : 0;
+  memset(code, 0x66, prefixes);
+  memcpy(code + prefixes, kNops[length - prefixes - 1], length - prefixes);
+}
+
+} // namespace viaevo
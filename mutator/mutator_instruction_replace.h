@@ -0,0 +1,46 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_INSTRUCTION_REPLACE_H_
+#define VIAEVO_MUTATOR_MUTATOR_INSTRUCTION_REPLACE_H_
+
+#include "mutator.h"
+
+// TODO: Remove relative path.
+#include "../util/random.h"
+
+namespace viaevo {
+
+// MutatorInstructionReplace creates new code for target based on parent1
+// (parent2 is ignored). Parent1's code is decoded into x86-64 instructions
+// (see InstructionDecoder) and a random instruction (or an undecodable byte) is
+// replaced by random bytes forming a valid instruction of the same length, i.e.
+// the boundaries of the following instructions are preserved. If no random
+// bytes form such an instruction within kMaxAttempts attempts, the instruction
+// is replaced by a nop of the same length.
+class MutatorInstructionReplace : public Mutator {
+public:
+  explicit MutatorInstructionReplace(Random &gen);
+  // Creates new code for target based on parent1 with a replaced instruction.
+  virtual void Mutate(std::shared_ptr<Program> target,
+                      std::shared_ptr<Program> parent1,
+                      std::shared_ptr<Program> parent2) override;
+  // Same as Mutate, drawing random numbers from gen.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
+
+  // Writes the recommended (multi-byte) nop of length bytes (1 to 15) to code.
+  static void WriteNop(char *code, int length);
+
+protected:
+  static constexpr int kMaxAttempts = 32;
+
+  // Random number generator.
+  Random &gen_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_INSTRUCTION_REPLACE_H_
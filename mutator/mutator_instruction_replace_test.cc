@@ -0,0 +1,76 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_instruction_replace.h"
+
+#include <gtest/gtest.h>
+
+// TODO: Remove relative path.
+#include "../util/random.h"
+#include "../util/random_mock.h"
+#include "../x86/instruction_decoder.h"
+
+namespace {
+
+TEST(MutatorInstructionReplaceTest, Mutate) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // Replaces the first instruction (push rbp) with push rbx.
+  viaevo::RandomMock gen({0, 0x53});
+  viaevo::MutatorInstructionReplace mutator(gen);
+  mutator.Mutate(target, parent, parent);
+
+  std::vector<char> parent_code = parent->GetElfCode();
+  std::vector<char> target_code = target->GetElfCode();
+  EXPECT_EQ(target_code[0], 0x53);
+  target_code[0] = parent_code[0];
+  EXPECT_EQ(parent_code, target_code);
+
+  // Replaces the first instruction with a nop as 0x06 (invalid) and 0x00
+  // (truncated) do not form an instruction of length 1.
+  gen.set_values({0, 0x06});
+  mutator.Mutate(target, parent, parent);
+  target_code = target->GetElfCode();
+  EXPECT_EQ(target_code[0], '\x90');
+}
+
+TEST(MutatorInstructionReplaceTest, PreservesInstructionBoundaries) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  std::vector<viaevo::DecodedInstruction> parent_instructions =
+      viaevo::InstructionDecoder::DecodeAll(parent->GetElfCode());
+
+  viaevo::Random gen;
+  gen.Seed(1);
+  viaevo::MutatorInstructionReplace mutator(gen);
+  for (int i = 0; i < 100; ++i) {
+    mutator.Mutate(target, parent, parent);
+    std::vector<viaevo::DecodedInstruction> target_instructions =
+        viaevo::InstructionDecoder::DecodeAll(target->GetElfCode());
+    ASSERT_EQ(parent_instructions.size(), target_instructions.size());
+    for (size_t j = 0; j < target_instructions.size(); ++j) {
+      EXPECT_EQ(parent_instructions[j].offset, target_instructions[j].offset);
+      EXPECT_TRUE(target_instructions[j].valid);
+    }
+  }
+}
+
+TEST(MutatorInstructionReplaceTest, WriteNop) {
+  for (int length = 1; length <= 15; ++length) {
+    char code[15];
+    viaevo::MutatorInstructionReplace::WriteNop(code, length);
+    viaevo::DecodedInstruction instruction;
+    ASSERT_TRUE(viaevo::InstructionDecoder::Decode(code, length, instruction));
+    EXPECT_EQ(instruction.length, length);
+  }
+}
+
+} // namespace
@@ -0,0 +1,47 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_mask.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <vector>
+
+// TODO: Remove relative path.
+#include "../util/xor_kernels.h"
+
+namespace viaevo {
+
+MutatorMask::MutatorMask(Random &gen) : gen_(gen) {}
+
+void MutatorMask::Mutate(std::shared_ptr<Program> target,
+                         std::shared_ptr<Program> parent1,
+                         std::shared_ptr<Program> parent2) {
+  MutateViaGenome(target, parent1, parent2, gen_, false);
+}
+
+void MutatorMask::MutateGenome(char *target, const Genome &parent1,
+                               const Genome &parent2, Random &gen) {
+  if (parent1.size == 0)
+    return;
+
+  // The mask is kept all zeros between calls (only the used range is cleared)
+  // so a mutation does not touch more memory than it changes. One mask per
+  // thread makes MutateGenome safe to call concurrently.
+  thread_local std::vector<char> mask;
+  if (mask.size() < parent1.size)
+    mask.resize(parent1.size, 0);
+
+  MaskRange range = FillMask(mask.data(), parent1.size, gen);
+  assert(range.begin <= range.end && range.end <= parent1.size &&
+         "mask range out of bounds");
+
+  XorMask(target + range.begin, mask.data() + range.begin,
+          range.end - range.begin);
+  memset(mask.data() + range.begin, 0, range.end - range.begin);
+}
+
+} // namespace viaevo
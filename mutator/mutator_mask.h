@@ -0,0 +1,53 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_MASK_H_
+#define VIAEVO_MUTATOR_MUTATOR_MASK_H_
+
+#include "mutator.h"
+
+#include <stddef.h>
+
+// TODO: Remove relative path.
+#include "../util/random.h"
+
+namespace viaevo {
+
+// MutatorMask is an abstract base class for mutators changing many bits of
+// parent1's code at once (parent2 is ignored). A subclass sets the bits to flip
+// in a mask over the code and the mask is XORed into target's code by a
+// vectorized kernel (see util/xor_kernels.h) so that the cost of a mutation is
+// bounded by the memory bandwidth also for large genomes.
+class MutatorMask : public Mutator {
+public:
+  explicit MutatorMask(Random &gen);
+  // Creates new code for target based on parent1 with the bits of the mask
+  // flipped.
+  virtual void Mutate(std::shared_ptr<Program> target,
+                      std::shared_ptr<Program> parent1,
+                      std::shared_ptr<Program> parent2) override;
+  // Same as Mutate, drawing random numbers from gen.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
+
+protected:
+  // Range [begin, end) of the mask set by FillMask.
+  struct MaskRange {
+    size_t begin = 0;
+    size_t end = 0;
+  };
+
+  // Sets the bits to flip in mask (of size bytes, all zeros on entry) drawing
+  // random numbers from gen. Returns the range of mask containing all set bits
+  // (only this range is XORed into the code and cleared afterwards).
+  virtual MaskRange FillMask(char *mask, size_t size, Random &gen) = 0;
+
+  // Random number generator.
+  Random &gen_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_MASK_H_
@@ -0,0 +1,41 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_mask_burst.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+namespace viaevo {
+
+MutatorMaskBurst::MutatorMaskBurst(Random &gen, int max_burst_bits)
+    : MutatorMask(gen), max_burst_bits_(max_burst_bits) {
+  assert(max_burst_bits_ >= 1 && "max_burst_bits should be positive");
+}
+
+MutatorMask::MaskRange MutatorMaskBurst::FillMask(char *mask, size_t size,
+                                                  Random &gen) {
+  auto element_size = 8 * sizeof(char);
+  size_t num_positions = size * element_size;
+
+  mt_type::result_type random_numbers[2];
+  gen.Fill(random_numbers, 2);
+
+  size_t burst_bits =
+      1 + random_numbers[0] % std::min<size_t>(max_burst_bits_, num_positions);
+  size_t start = random_numbers[1] % (num_positions - burst_bits + 1);
+
+  for (size_t pos = start; pos < start + burst_bits; ++pos) {
+    mask[pos / element_size] |= (1 << (pos % element_size));
+  }
+
+  MaskRange range;
+  range.begin = start / element_size;
+  range.end = (start + burst_bits - 1) / element_size + 1;
+  return range;
+}
+
+} // namespace viaevo
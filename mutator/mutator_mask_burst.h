@@ -0,0 +1,29 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_MASK_BURST_H_
+#define VIAEVO_MUTATOR_MUTATOR_MASK_BURST_H_
+
+#include "mutator_mask.h"
+
+namespace viaevo {
+
+// MutatorMaskBurst creates new code for target based on parent1 (parent2 is
+// ignored). Target's code will have all bits of a random contiguous range of
+// 1 to max_burst_bits bits flipped compared to parent1's code (ranges are
+// "bit-aligned" and can span several bytes).
+class MutatorMaskBurst : public MutatorMask {
+public:
+  explicit MutatorMaskBurst(Random &gen, int max_burst_bits = 16);
+
+protected:
+  virtual MaskRange FillMask(char *mask, size_t size, Random &gen) override;
+
+  int max_burst_bits_ = 16;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_MASK_BURST_H_
@@ -0,0 +1,65 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_mask_burst.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// TODO: Remove relative path.
+#include "../util/random_mock.h"
+
+namespace {
+
+TEST(MutatorMaskBurstTest, Mutate) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // A burst of 1 + 5 % 16 = 6 bits starting at bit 6 (bits 6 and 7 of byte 0
+  // and bits 0 to 3 of byte 1).
+  viaevo::RandomMock gen({5, 6});
+
+  std::vector<char> old_parent_code = parent->GetElfCode();
+
+  viaevo::MutatorMaskBurst mutator(gen);
+  // The third argument is ignored by MutatorMaskBurst.
+  mutator.Mutate(target, parent, parent);
+
+  std::vector<char> new_target_code = target->GetElfCode();
+  std::vector<char> new_parent_code = parent->GetElfCode();
+
+  // Parent code should be unaltered.
+  EXPECT_EQ(old_parent_code, new_parent_code);
+
+  std::vector<char> expected_code = old_parent_code;
+  expected_code[0] ^= (char)0xc0;
+  expected_code[1] ^= 0x0f;
+  EXPECT_EQ(new_target_code, expected_code);
+}
+
+TEST(MutatorMaskBurstTest, MutateGenomeEnd) {
+  std::vector<char> code(4, 0);
+  viaevo::Genome parent;
+  parent.code = code.data();
+  parent.size = code.size();
+
+  // A burst of 16 bits at the last possible start (16 = 16 % (32 - 16 + 1)).
+  viaevo::RandomMock gen({15, 16});
+  viaevo::MutatorMaskBurst mutator(gen, 100);
+
+  std::vector<char> target = code;
+  mutator.MutateGenome(target.data(), parent, parent, gen);
+  EXPECT_EQ(target, std::vector<char>({0, 0, (char)0xff, (char)0xff}));
+
+  // Large random numbers stay within the code.
+  gen.set_values({5'000'000, 10'000'000});
+  mutator.MutateGenome(target.data(), parent, parent, gen);
+}
+
+} // namespace
@@ -0,0 +1,63 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_mask_poisson.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace viaevo {
+
+MutatorMaskPoisson::MutatorMaskPoisson(Random &gen, double mean_bits,
+                                       int max_bits)
+    : MutatorMask(gen), mean_bits_(mean_bits), max_bits_(max_bits) {
+  assert(mean_bits_ >= 1.0 && "mean_bits should be at least 1.0");
+  assert(max_bits_ >= 1 && "max_bits should be positive");
+}
+
+int MutatorMaskPoisson::NumBits(mt_type::result_type random_number,
+                                double mean_bits, int max_bits) {
+  double lambda = mean_bits - 1.0;
+  // Uniform in [0, 1) (the generator produces 32-bit numbers).
+  double u = (random_number & 0xffffffffu) / 4294967296.0;
+  double p = std::exp(-lambda);
+  double cdf = p;
+  int k = 0;
+  while (u >= cdf && k + 1 < max_bits && p > 0.0) {
+    ++k;
+    p *= lambda / k;
+    cdf += p;
+  }
+  return 1 + k;
+}
+
+MutatorMask::MaskRange MutatorMaskPoisson::FillMask(char *mask, size_t size,
+                                                    Random &gen) {
+  auto element_size = 8 * sizeof(char);
+  size_t num_positions = size * element_size;
+  int num_bits = std::min<size_t>(NumBits(gen(), mean_bits_, max_bits_),
+                                  num_positions);
+
+  std::vector<mt_type::result_type> random_numbers(num_bits);
+  gen.Fill(random_numbers.data(), num_bits);
+
+  MaskRange range;
+  range.begin = size;
+  for (auto random_number : random_numbers) {
+    auto pos = random_number % num_positions;
+    auto index = pos / element_size;
+    auto bit_pos = pos % element_size;
+    // OR rather than XOR: a position drawn twice is flipped once.
+    mask[index] |= (1 << bit_pos);
+    range.begin = std::min(range.begin, (size_t)index);
+    range.end = std::max(range.end, (size_t)index + 1);
+  }
+  return range;
+}
+
+} // namespace viaevo
@@ -0,0 +1,40 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_MASK_POISSON_H_
+#define VIAEVO_MUTATOR_MUTATOR_MASK_POISSON_H_
+
+#include "mutator_mask.h"
+
+namespace viaevo {
+
+// MutatorMaskPoisson creates new code for target based on parent1 (parent2 is
+// ignored). Target's code will have 1 + k distinct bits flipped in random
+// locations compared to parent1's code where k is drawn from the Poisson
+// distribution with mean mean_bits - 1 (i.e. mean_bits bits are flipped on
+// average and at least one bit is flipped). With mean_bits 1.0 the mutator is
+// equivalent to MutatorPointRandom. The number of flipped bits is capped at
+// max_bits.
+class MutatorMaskPoisson : public MutatorMask {
+public:
+  explicit MutatorMaskPoisson(Random &gen, double mean_bits = 3.0,
+                              int max_bits = 64);
+
+  // Returns 1 + k for k drawn from the Poisson distribution with mean
+  // mean_bits - 1 by inverse transform sampling of the uniform random number
+  // random_number (capped at max_bits).
+  static int NumBits(mt_type::result_type random_number, double mean_bits,
+                     int max_bits);
+
+protected:
+  virtual MaskRange FillMask(char *mask, size_t size, Random &gen) override;
+
+  double mean_bits_ = 3.0;
+  int max_bits_ = 64;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_MASK_POISSON_H_
@@ -0,0 +1,95 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_mask_poisson.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// TODO: Remove relative path.
+#include "../util/random_mock.h"
+
+namespace {
+
+TEST(MutatorMaskPoissonTest, NumBits) {
+  // Uniform 0 is below the probability of k == 0.
+  EXPECT_EQ(viaevo::MutatorMaskPoisson::NumBits(0, 3.0, 64), 1);
+  // Mean 1.0 always flips a single bit.
+  EXPECT_EQ(viaevo::MutatorMaskPoisson::NumBits(0xffffffff, 1.0, 64), 1);
+  // Capped at max_bits.
+  EXPECT_EQ(viaevo::MutatorMaskPoisson::NumBits(0xffffffff, 3.0, 5), 5);
+  // Poisson with mean 2.0: P(0) = 0.135, P(<= 1) = 0.406, P(<= 2) = 0.677.
+  EXPECT_EQ(viaevo::MutatorMaskPoisson::NumBits(0x40000000, 3.0, 64), 2);
+  EXPECT_EQ(viaevo::MutatorMaskPoisson::NumBits(0x80000000, 3.0, 64), 3);
+
+  // The mean of the number of flipped bits is mean_bits.
+  double sum = 0.0;
+  int n = 10000;
+  for (int i = 0; i < n; ++i) {
+    sum += viaevo::MutatorMaskPoisson::NumBits(
+        (viaevo::mt_type::result_type)(i * 4294967296.0 / n), 3.0, 64);
+  }
+  EXPECT_NEAR(sum / n, 3.0, 0.01);
+}
+
+TEST(MutatorMaskPoissonTest, Mutate) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // A single bit flip (the first random number) at position 42.
+  viaevo::RandomMock gen({0, 42});
+
+  std::vector<char> old_parent_code = parent->GetElfCode();
+
+  viaevo::MutatorMaskPoisson mutator(gen);
+  // The third argument is ignored by MutatorMaskPoisson.
+  mutator.Mutate(target, parent, parent);
+
+  std::vector<char> new_target_code = target->GetElfCode();
+  std::vector<char> new_parent_code = parent->GetElfCode();
+
+  // Parent code should be unaltered.
+  EXPECT_EQ(old_parent_code, new_parent_code);
+
+  std::vector<char> expected_code = old_parent_code;
+  expected_code[5] ^= 4;
+  EXPECT_EQ(new_target_code, expected_code);
+}
+
+TEST(MutatorMaskPoissonTest, MutateGenomeMultipleBits) {
+  std::vector<char> code(16, 0);
+  viaevo::Genome parent;
+  parent.code = code.data();
+  parent.size = code.size();
+
+  // The first number gives 3 bits (capped), the following ones the positions
+  // 3, 17 and 127 (0xffffffff % 128).
+  viaevo::RandomMock gen({0xffffffff, 3, 17});
+  viaevo::MutatorMaskPoisson mutator(gen, 3.0, 3);
+
+  std::vector<char> target = code;
+  mutator.MutateGenome(target.data(), parent, parent, gen);
+
+  std::vector<char> expected(16, 0);
+  expected[0] = 0x08;
+  expected[2] = 0x02;
+  expected[15] = (char)0x80;
+  EXPECT_EQ(target, expected);
+
+  // The mask is cleared after use: a single bit flip at position 0 follows.
+  gen.set_values({0, 0});
+  target = code;
+  mutator.MutateGenome(target.data(), parent, parent, gen);
+  expected.assign(16, 0);
+  expected[0] = 0x01;
+  EXPECT_EQ(target, expected);
+}
+
+} // namespace
@@ -0,0 +1,43 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_mask_window.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace viaevo {
+
+MutatorMaskWindow::MutatorMaskWindow(Random &gen, int max_window_bytes)
+    : MutatorMask(gen), max_window_bytes_(max_window_bytes) {
+  assert(max_window_bytes_ >= 1 && "max_window_bytes should be positive");
+}
+
+MutatorMask::MaskRange MutatorMaskWindow::FillMask(char *mask, size_t size,
+                                                   Random &gen) {
+  mt_type::result_type random_numbers[2];
+  gen.Fill(random_numbers, 2);
+
+  size_t window_size =
+      1 + random_numbers[0] % std::min<size_t>(max_window_bytes_, size);
+  size_t start = random_numbers[1] % (size - window_size + 1);
+
+  // Each random number provides 4 bytes (the generator produces 32-bit
+  // numbers).
+  std::vector<mt_type::result_type> random_bytes((window_size + 3) / 4);
+  gen.Fill(random_bytes.data(), random_bytes.size());
+  for (size_t i = 0; i < window_size; ++i) {
+    mask[start + i] = (char)(random_bytes[i / 4] >> (8 * (i % 4)));
+  }
+
+  MaskRange range;
+  range.begin = start;
+  range.end = start + window_size;
+  return range;
+}
+
+} // namespace viaevo
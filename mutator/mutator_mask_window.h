@@ -0,0 +1,29 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_MASK_WINDOW_H_
+#define VIAEVO_MUTATOR_MUTATOR_MASK_WINDOW_H_
+
+#include "mutator_mask.h"
+
+namespace viaevo {
+
+// MutatorMaskWindow creates new code for target based on parent1 (parent2 is
+// ignored). Target's code will have a random window of 1 to max_window_bytes
+// bytes replaced with random bytes (XORing uniformly random bytes into the
+// window) compared to parent1's code.
+class MutatorMaskWindow : public MutatorMask {
+public:
+  explicit MutatorMaskWindow(Random &gen, int max_window_bytes = 8);
+
+protected:
+  virtual MaskRange FillMask(char *mask, size_t size, Random &gen) override;
+
+  int max_window_bytes_ = 8;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_MASK_WINDOW_H_
@@ -0,0 +1,62 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_mask_window.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// TODO: Remove relative path.
+#include "../util/random_mock.h"
+
+namespace {
+
+TEST(MutatorMaskWindowTest, Mutate) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // A window of 1 + 2 % 8 = 3 bytes starting at byte 4 XORed with bytes 0x01,
+  // 0x02 and 0x03 of the third random number.
+  viaevo::RandomMock gen({2, 4, 0x04030201});
+
+  std::vector<char> old_parent_code = parent->GetElfCode();
+
+  viaevo::MutatorMaskWindow mutator(gen);
+  // The third argument is ignored by MutatorMaskWindow.
+  mutator.Mutate(target, parent, parent);
+
+  std::vector<char> new_target_code = target->GetElfCode();
+  std::vector<char> new_parent_code = parent->GetElfCode();
+
+  // Parent code should be unaltered.
+  EXPECT_EQ(old_parent_code, new_parent_code);
+
+  std::vector<char> expected_code = old_parent_code;
+  expected_code[4] ^= 0x01;
+  expected_code[5] ^= 0x02;
+  expected_code[6] ^= 0x03;
+  EXPECT_EQ(new_target_code, expected_code);
+}
+
+TEST(MutatorMaskWindowTest, MutateGenomeLargeWindow) {
+  std::vector<char> code(6, 0);
+  viaevo::Genome parent;
+  parent.code = code.data();
+  parent.size = code.size();
+
+  // The window is limited to the code size: 1 + 5 % 6 = 6 bytes at 0.
+  viaevo::RandomMock gen({5, 0, 0x44332211, 0x66554433});
+  viaevo::MutatorMaskWindow mutator(gen, 100);
+
+  std::vector<char> target = code;
+  mutator.MutateGenome(target.data(), parent, parent, gen);
+  EXPECT_EQ(target, std::vector<char>({0x11, 0x22, 0x33, 0x44, 0x33, 0x44}));
+}
+
+} // namespace
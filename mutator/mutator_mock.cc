@@ -0,0 +1,20 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_mock.h"
+
+namespace viaevo {
+
+void MutatorMock::Mutate(std::shared_ptr<Program> target,
+                         std::shared_ptr<Program> parent1,
+                         std::shared_ptr<Program> parent2) {
+  ++mutate_calls_;
+}
+
+void MutatorMock::Update(const std::vector<MutationOutcome> &outcomes) {
+  ++update_calls_;
+}
+
+} // namespace viaevo
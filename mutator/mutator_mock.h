@@ -0,0 +1,35 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_MOCK_H_
+#define VIAEVO_MUTATOR_MUTATOR_MOCK_H_
+
+#include <memory>
+#include <vector>
+
+#include "mutator.h"
+
+namespace viaevo {
+
+// MutatorMock is intended to be used for unit tests. The mutator counts the
+// calls of Mutate and Update and leaves the code of the target unchanged.
+class MutatorMock : public Mutator {
+public:
+  virtual void Mutate(std::shared_ptr<Program> target,
+                      std::shared_ptr<Program> parent1,
+                      std::shared_ptr<Program> parent2) override;
+  virtual void Update(const std::vector<MutationOutcome> &outcomes) override;
+
+  int mutate_calls() const { return mutate_calls_; }
+  int update_calls() const { return update_calls_; }
+
+protected:
+  int mutate_calls_ = 0;
+  int update_calls_ = 0;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_MOCK_H_
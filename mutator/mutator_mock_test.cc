@@ -0,0 +1,27 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_mock.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace {
+
+TEST(MutatorMockTest, CountsCalls) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::vector<char> code = target->GetElfCode();
+
+  viaevo::MutatorMock mutator;
+  mutator.Mutate(target, target, target);
+  mutator.Mutate(target, target, target);
+  mutator.Update({});
+  EXPECT_EQ(mutator.mutate_calls(), 2);
+  EXPECT_EQ(mutator.update_calls(), 1);
+  EXPECT_EQ(target->GetElfCode(), code);
+}
+
+} // namespace
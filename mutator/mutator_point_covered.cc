@@ -0,0 +1,65 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_point_covered.h"
+
+#include <algorithm>
+
+// TODO: Remove relative path.
+#include "../x86/instruction_decoder.h"
+
+namespace viaevo {
+
+MutatorPointCovered::MutatorPointCovered(Random &gen)
+    : MutatorPointRandom(gen) {}
+
+std::vector<size_t> MutatorPointCovered::LiveOffsets(const Genome &genome) {
+  std::vector<size_t> offsets;
+  if (!genome.coverage)
+    return offsets;
+
+  // Offsets below end are already in offsets.
+  size_t end = 0;
+  DecodedInstruction instruction;
+  for (size_t offset = 0; offset < genome.size; ++offset) {
+    if (!genome.IsCovered(offset))
+      continue;
+    // The executed instruction and the one following it.
+    size_t live_end = offset;
+    for (int i = 0; i < 2 && live_end < genome.size; ++i) {
+      InstructionDecoder::Decode(genome.code + live_end,
+                                 genome.size - live_end, instruction);
+      live_end += instruction.valid ? instruction.length : 1;
+    }
+    for (size_t live = std::max(offset, end); live < live_end; ++live)
+      offsets.push_back(live);
+    end = std::max(end, live_end);
+  }
+  return offsets;
+}
+
+void MutatorPointCovered::Mutate(std::shared_ptr<Program> target,
+                                 std::shared_ptr<Program> parent1,
+                                 std::shared_ptr<Program> parent2) {
+  MutateViaGenome(target, parent1, parent2, gen_, false);
+}
+
+void MutatorPointCovered::MutateGenome(char *target, const Genome &parent1,
+                                       const Genome &parent2, Random &gen) {
+  std::vector<size_t> offsets = LiveOffsets(parent1);
+  if (offsets.empty()) {
+    MutatorPointRandom::MutateGenome(target, parent1, parent2, gen);
+    return;
+  }
+
+  auto random_number = gen();
+  auto element_size = 8 * sizeof(char);
+  auto pos = random_number % (offsets.size() * element_size);
+  auto index = offsets[pos / element_size];
+  auto bit_pos = pos % element_size;
+  target[index] ^= (1 << bit_pos);
+}
+
+} // namespace viaevo
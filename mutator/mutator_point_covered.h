@@ -0,0 +1,44 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_POINT_COVERED_H_
+#define VIAEVO_MUTATOR_MUTATOR_POINT_COVERED_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "mutator_point_random.h"
+
+namespace viaevo {
+
+// MutatorPointCovered creates new code for target based on parent1 (parent2 is
+// ignored). Target's code will have a single bit flip compared to parent1's
+// code. The location of the bit flip is random within the instructions
+// executed by parent1 and the instructions following them (see
+// Program::coverage), i.e. mutations in code that is never executed (and are
+// thus neutral) are avoided. Without parent1's coverage, reverts to
+// MutatorPointRandom behavior. The code of parent1 is not changed.
+class MutatorPointCovered : public MutatorPointRandom {
+public:
+  explicit MutatorPointCovered(Random &gen);
+  // Creates new code for target based on the description above.
+  virtual void Mutate(std::shared_ptr<Program> target,
+                      std::shared_ptr<Program> parent1,
+                      std::shared_ptr<Program> parent2) override;
+  // Same as Mutate, drawing random numbers from gen.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
+
+  // Returns the (sorted) offsets of the bytes of the executed instructions in
+  // genome's code and of the instructions directly following them (e.g. the
+  // instructions not reached due to a fault or a not taken jump). Empty if
+  // genome has no coverage.
+  static std::vector<size_t> LiveOffsets(const Genome &genome);
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_POINT_COVERED_H_
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_point_covered.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+// TODO: Remove relative paths.
+#include "../util/random.h"
+#include "../util/random_mock.h"
+
+namespace {
+
+TEST(MutatorPointCoveredTest, LiveOffsets) {
+  // mov eax, imm32 followed by nops.
+  std::vector<char> code(32, '\x90');
+  code[0] = '\xb8';
+  std::vector<uint8_t> coverage(4, 0);
+
+  viaevo::Genome genome;
+  genome.code = code.data();
+  genome.size = code.size();
+  EXPECT_TRUE(viaevo::MutatorPointCovered::LiveOffsets(genome).empty())
+      << "There should be no live offsets without coverage";
+
+  // The executed mov and the nop following it.
+  coverage[0] = 1;
+  genome.coverage = coverage.data();
+  EXPECT_EQ(viaevo::MutatorPointCovered::LiveOffsets(genome),
+            (std::vector<size_t>{0, 1, 2, 3, 4, 5}));
+
+  // Overlapping ranges and the last instruction of the code.
+  coverage[0] = 1 | 1 << 5;
+  coverage[3] = 1 << 7;
+  EXPECT_EQ(viaevo::MutatorPointCovered::LiveOffsets(genome),
+            (std::vector<size_t>{0, 1, 2, 3, 4, 5, 6, 31}));
+}
+
+TEST(MutatorPointCoveredTest, MutateGenome) {
+  std::vector<char> code(64, '\x90');
+  std::vector<uint8_t> coverage(8, 0);
+  // Offsets 10 and 11 executed, i.e. offsets 10, 11 and 12 are live.
+  coverage[1] = 1 << 2 | 1 << 3;
+
+  viaevo::Genome genome;
+  genome.code = code.data();
+  genome.size = code.size();
+  genome.coverage = coverage.data();
+
+  viaevo::RandomMock gen({0, 2 * 8 + 3, 3 * 8 + 1});
+  viaevo::MutatorPointCovered mutator(gen);
+
+  std::vector<char> target = code;
+  mutator.MutateGenome(target.data(), genome, genome, gen);
+  EXPECT_EQ(target[10], '\x91');
+  target = code;
+  mutator.MutateGenome(target.data(), genome, genome, gen);
+  EXPECT_EQ(target[12], '\x98');
+  // Wraps around the live offsets.
+  target = code;
+  mutator.MutateGenome(target.data(), genome, genome, gen);
+  EXPECT_EQ(target[10], '\x92');
+
+  // Without coverage, reverts to a random bit flip in the whole code.
+  genome.coverage = nullptr;
+  gen.set_values({40 * 8 + 1});
+  target = code;
+  mutator.MutateGenome(target.data(), genome, genome, gen);
+  EXPECT_EQ(target[40], '\x92');
+}
+
+TEST(MutatorPointCoveredTest, Mutate) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // A jump over 100 bytes of nops at offset 10.
+  std::vector<char> code(parent->elf_code_size(), '\x90');
+  code[10] = '\xeb';
+  code[11] = 100;
+  parent->SetElfCode(code);
+  parent->set_coverage_executions(1);
+  parent->Execute();
+  ASSERT_TRUE(parent->has_coverage());
+
+  viaevo::Random gen;
+  gen.Seed(1);
+  viaevo::MutatorPointCovered mutator(gen);
+  for (int i = 0; i < 100; ++i) {
+    mutator.Mutate(target, parent, parent);
+    std::vector<char> target_code = target->GetElfCode();
+    auto mismatch =
+        std::mismatch(code.begin(), code.end(), target_code.begin());
+    ASSERT_NE(mismatch.first, code.end());
+    size_t offset = mismatch.first - code.begin();
+    EXPECT_FALSE(offset > 12 && offset < 112)
+        << "Bit flip at offset " << offset << " in the skipped nops";
+  }
+}
+
+} // namespace
@@ -23,6 +23,9 @@ public:
   virtual void Mutate(std::shared_ptr<Program> target,
                       std::shared_ptr<Program> parent1,
                       std::shared_ptr<Program> parent2) override;
+  // Same as Mutate, drawing random numbers from gen.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
 
 protected:
   // Maximum instruction size for x86-64 should be 15 bytes.
@@ -12,16 +12,17 @@ MutatorPointRandom::MutatorPointRandom(Random &gen) : gen_(gen) {}
 void MutatorPointRandom::Mutate(std::shared_ptr<Program> target,
                                 std::shared_ptr<Program> parent1,
                                 std::shared_ptr<Program> parent2) {
-  std::vector<char> code = parent1->GetElfCode();
+  MutateViaGenome(target, parent1, parent2, gen_, false);
+}
 
-  auto random_number = gen_();
-  auto element_size = 8 * sizeof(decltype(code)::value_type);
-  auto pos = random_number % (code.size() * element_size);
+void MutatorPointRandom::MutateGenome(char *target, const Genome &parent1,
+                                      const Genome &parent2, Random &gen) {
+  auto random_number = gen();
+  auto element_size = 8 * sizeof(char);
+  auto pos = random_number % (parent1.size * element_size);
   auto index = pos / element_size;
   auto bit_pos = pos % element_size;
-  code[index] ^= (1 << bit_pos);
-
-  target->SetElfCode(code);
+  target[index] ^= (1 << bit_pos);
 }
 
 } // namespace viaevo
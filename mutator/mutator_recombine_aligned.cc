@@ -0,0 +1,90 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_recombine_aligned.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include "mutator_instruction_replace.h"
+
+// TODO: Remove relative path.
+#include "../x86/instruction_decoder.h"
+
+namespace viaevo {
+
+MutatorRecombineAligned::MutatorRecombineAligned(Random &gen, bool homologous)
+    : gen_(gen), homologous_(homologous) {}
+
+std::vector<size_t>
+MutatorRecombineAligned::InstructionBoundaries(const Genome &genome) {
+  std::vector<size_t> boundaries;
+  for (auto &instruction :
+       InstructionDecoder::DecodeAll(genome.code, genome.size))
+    boundaries.push_back(instruction.offset);
+  boundaries.push_back(genome.size);
+  return boundaries;
+}
+
+void MutatorRecombineAligned::Mutate(std::shared_ptr<Program> target,
+                                     std::shared_ptr<Program> parent1,
+                                     std::shared_ptr<Program> parent2) {
+  MutateViaGenome(target, parent1, parent2, gen_);
+}
+
+void MutatorRecombineAligned::MutateGenome(char *target, const Genome &parent1,
+                                           const Genome &parent2,
+                                           Random &gen) {
+  std::vector<size_t> boundaries1 = InstructionBoundaries(parent1);
+  std::vector<size_t> boundaries2 = InstructionBoundaries(parent2);
+
+  mt_type::result_type random_numbers[3];
+  gen.Fill(random_numbers, 3);
+
+  if (homologous_) {
+    // Boundaries common to both codes (both start with 0).
+    std::vector<size_t> common;
+    std::set_intersection(boundaries1.begin(), boundaries1.end(),
+                          boundaries2.begin(), boundaries2.end(),
+                          std::back_inserter(common));
+    if (parent1.size != parent2.size || common.size() < 2)
+      return;
+    size_t start_index = random_numbers[0] % (common.size() - 1);
+    size_t end_index = start_index + 1 +
+                       random_numbers[1] % (common.size() - 1 - start_index);
+    std::copy(parent2.code + common[start_index],
+              parent2.code + common[end_index], target + common[start_index]);
+    return;
+  }
+
+  size_t num_instructions2 = boundaries2.size() - 1;
+  size_t num_instructions1 = boundaries1.size() - 1;
+  if (num_instructions1 == 0 || num_instructions2 == 0)
+    return;
+  size_t start_index = random_numbers[0] % num_instructions2;
+  size_t end_index =
+      start_index + 1 + random_numbers[1] % (num_instructions2 - start_index);
+  size_t position = boundaries1[random_numbers[2] % num_instructions1];
+
+  // Truncate the insert to whole instructions within parent1's code.
+  size_t start = boundaries2[start_index];
+  while (end_index > start_index &&
+         boundaries2[end_index] - start > parent1.size - position)
+    --end_index;
+  size_t size = boundaries2[end_index] - start;
+  std::copy(parent2.code + start, parent2.code + start + size,
+            target + position);
+
+  // Pad the rest of the overwritten instruction of code1 with a nop.
+  size_t end = position + size;
+  size_t next_boundary =
+      *std::lower_bound(boundaries1.begin(), boundaries1.end(), end);
+  if (next_boundary > end)
+    MutatorInstructionReplace::WriteNop(target + end, next_boundary - end);
+}
+
+} // namespace viaevo
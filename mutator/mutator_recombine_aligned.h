@@ -0,0 +1,58 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_RECOMBINE_ALIGNED_H_
+#define VIAEVO_MUTATOR_MUTATOR_RECOMBINE_ALIGNED_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "mutator.h"
+
+// TODO: Remove relative path.
+#include "../util/random.h"
+
+namespace viaevo {
+
+// MutatorRecombineAligned creates new code for target based on parent1 and
+// parent2 like MutatorRecombineRandom, but the cut points are placed on the
+// boundaries of decoded x86-64 instructions (see InstructionDecoder) so that
+// no instruction is cut in half. Parent1 and parent2 are not modified.
+//
+// By default, a random run of whole instructions of parent2's code is placed at
+// a random instruction boundary of parent1's code. If the insert ends within an
+// instruction of parent1's code, the remaining bytes of that instruction are
+// overwritten with a nop (i.e. the boundaries of the following instructions
+// are preserved). The insert is truncated to whole instructions not to exceed
+// the code size limit.
+//
+// In the homologous mode, the range of code is the same in both parents (the
+// same position in the template program) and both of its ends are boundaries
+// of instructions in both parents' codes, i.e. the boundaries of all
+// instructions outside of the range are preserved.
+class MutatorRecombineAligned : public Mutator {
+public:
+  explicit MutatorRecombineAligned(Random &gen, bool homologous = false);
+  // Creates new code for target based on the description above.
+  virtual void Mutate(std::shared_ptr<Program> target,
+                      std::shared_ptr<Program> parent1,
+                      std::shared_ptr<Program> parent2) override;
+  // Same as Mutate, drawing random numbers from gen.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
+
+protected:
+  // Returns the offsets of instructions in genome's code followed by its size.
+  static std::vector<size_t> InstructionBoundaries(const Genome &genome);
+
+  // Random number generator.
+  Random &gen_;
+  bool homologous_ = false;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_RECOMBINE_ALIGNED_H_
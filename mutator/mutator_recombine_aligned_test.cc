@@ -0,0 +1,139 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_recombine_aligned.h"
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+// TODO: Remove relative path.
+#include "../util/random.h"
+#include "../util/random_mock.h"
+#include "../x86/instruction_decoder.h"
+
+namespace {
+
+// Returns code of size bytes with repeated mov eax, imm32 (5 bytes) followed
+// by nops.
+std::vector<char> Movs(size_t size) {
+  std::vector<char> code(size, (char)0x90);
+  for (size_t i = 0; i + 5 <= size; i += 5) {
+    code[i] = (char)0xb8;
+    code[i + 1] = (char)(i / 5);
+    code[i + 2] = code[i + 3] = code[i + 4] = 0;
+  }
+  return code;
+}
+
+TEST(MutatorRecombineAlignedTest, Mutate) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent1 =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent2 =
+      viaevo::Program::Create("elfs/simple_small");
+  size_t size = parent1->GetElfCode().size();
+  std::vector<char> code1 = Movs(size);
+  std::vector<char> code2(size, (char)0x90);
+  parent1->SetElfCode(code1);
+  parent2->SetElfCode(code2);
+
+  // Places nops [0..3) of parent2's code at the second instruction (offset 5)
+  // of parent1's code and pads the rest of the instruction with a 2 byte nop.
+  viaevo::RandomMock gen({0, 2, 1});
+  viaevo::MutatorRecombineAligned mutator(gen);
+  mutator.Mutate(target, parent1, parent2);
+
+  std::vector<char> expected = code1;
+  expected[5] = expected[6] = expected[7] = (char)0x90;
+  expected[8] = 0x66;
+  expected[9] = (char)0x90;
+  EXPECT_EQ(target->GetElfCode(), expected);
+  EXPECT_EQ(parent1->GetElfCode(), code1);
+  EXPECT_EQ(parent2->GetElfCode(), code2);
+
+  // Places the first two movs of parent1's code at the last nop of parent2's
+  // code (truncated to no instructions).
+  gen.set_values({0, 1, (unsigned)size - 1});
+  mutator.Mutate(target, parent2, parent1);
+  EXPECT_EQ(target->GetElfCode(), code2);
+
+  // Places the first two movs at the fifth to last nop (truncated to one mov).
+  gen.set_values({0, 1, (unsigned)size - 5});
+  mutator.Mutate(target, parent2, parent1);
+  expected = code2;
+  std::copy(code1.begin(), code1.begin() + 5, expected.end() - 5);
+  EXPECT_EQ(target->GetElfCode(), expected);
+}
+
+TEST(MutatorRecombineAlignedTest, Homologous) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent1 =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent2 =
+      viaevo::Program::Create("elfs/simple_small");
+  size_t size = parent1->GetElfCode().size();
+  std::vector<char> code1 = Movs(size);
+  std::vector<char> code2(size, (char)0x90);
+  parent1->SetElfCode(code1);
+  parent2->SetElfCode(code2);
+
+  // The common boundaries are the offsets of the movs in parent1's code, i.e.
+  // the range [10..20) of parent2's code is placed at the same offset.
+  viaevo::RandomMock gen({2, 1, 0});
+  viaevo::MutatorRecombineAligned mutator(gen, true);
+  mutator.Mutate(target, parent1, parent2);
+
+  std::vector<char> expected = code1;
+  std::fill(expected.begin() + 10, expected.begin() + 20, (char)0x90);
+  EXPECT_EQ(target->GetElfCode(), expected);
+}
+
+TEST(MutatorRecombineAlignedTest, PreservesInstructionBoundaries) {
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent1 =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> parent2 =
+      viaevo::Program::Create("elfs/simple_small");
+  parent2->SetElfCode(Movs(parent2->GetElfCode().size()));
+
+  std::vector<viaevo::DecodedInstruction> parent_instructions =
+      viaevo::InstructionDecoder::DecodeAll(parent1->GetElfCode());
+
+  viaevo::Random gen;
+  gen.Seed(1);
+  for (bool homologous : {false, true}) {
+    viaevo::MutatorRecombineAligned mutator(gen, homologous);
+    for (int i = 0; i < 100; ++i) {
+      mutator.Mutate(target, parent1, parent2);
+      std::vector<char> target_code = target->GetElfCode();
+      // Instructions of parent1's code that were not overwritten are decoded
+      // at the same offsets.
+      std::vector<char> parent_code = parent1->GetElfCode();
+      size_t last_difference = target_code.size();
+      while (last_difference > 0 &&
+             target_code[last_difference - 1] ==
+                 parent_code[last_difference - 1])
+        --last_difference;
+      std::vector<viaevo::DecodedInstruction> target_instructions =
+          viaevo::InstructionDecoder::DecodeAll(target_code);
+      std::vector<size_t> target_offsets;
+      for (auto &instruction : target_instructions)
+        target_offsets.push_back(instruction.offset);
+      for (auto &instruction : parent_instructions) {
+        if (instruction.offset >= last_difference) {
+          EXPECT_TRUE(std::binary_search(target_offsets.begin(),
+                                         target_offsets.end(),
+                                         instruction.offset));
+        }
+      }
+    }
+  }
+}
+
+} // namespace
@@ -0,0 +1,47 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_recombine_covered.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mutator_point_covered.h"
+
+namespace viaevo {
+
+MutatorRecombineCovered::MutatorRecombineCovered(Random &gen) : gen_(gen) {}
+
+void MutatorRecombineCovered::Mutate(std::shared_ptr<Program> target,
+                                     std::shared_ptr<Program> parent1,
+                                     std::shared_ptr<Program> parent2) {
+  MutateViaGenome(target, parent1, parent2, gen_);
+}
+
+void MutatorRecombineCovered::MutateGenome(char *target, const Genome &parent1,
+                                           const Genome &parent2,
+                                           Random &gen) {
+  mt_type::result_type random_numbers[3];
+  gen.Fill(random_numbers, 3);
+
+  std::vector<size_t> offsets2 = MutatorPointCovered::LiveOffsets(parent2);
+  auto code2_start = offsets2.empty()
+                         ? random_numbers[0] % parent2.size
+                         : offsets2[random_numbers[0] % offsets2.size()];
+  auto code2_size = random_numbers[1] % (parent2.size - code2_start);
+
+  std::vector<size_t> offsets1 = MutatorPointCovered::LiveOffsets(parent1);
+  auto code1_position = offsets1.empty()
+                            ? random_numbers[2] % parent1.size
+                            : offsets1[random_numbers[2] % offsets1.size()];
+
+  code2_size = std::min(code2_size, parent1.size - code1_position);
+
+  for (unsigned long i = 0; i < code2_size; ++i) {
+    target[code1_position + i] = parent2.code[code2_start + i];
+  }
+}
+
+} // namespace viaevo
@@ -0,0 +1,41 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_MUTATOR_MUTATOR_RECOMBINE_COVERED_H_
+#define VIAEVO_MUTATOR_MUTATOR_RECOMBINE_COVERED_H_
+
+#include "mutator.h"
+
+// TODO: Remove relative path.
+#include "../util/random.h"
+
+namespace viaevo {
+
+// MutatorRecombineCovered creates new code for target based on parent1 and
+// parent2 like MutatorRecombineRandom, but the insert is placed at a random
+// position within the instructions executed by parent1 (and the instructions
+// following them, see MutatorPointCovered::LiveOffsets) and starts at a random
+// position within the instructions executed by parent2. Without the coverage of
+// a parent, the corresponding position is random within the whole code.
+// Parent1 and parent2 are not modified.
+class MutatorRecombineCovered : public Mutator {
+public:
+  explicit MutatorRecombineCovered(Random &gen);
+  // Creates new code for target based on the description above.
+  virtual void Mutate(std::shared_ptr<Program> target,
+                      std::shared_ptr<Program> parent1,
+                      std::shared_ptr<Program> parent2) override;
+  // Same as Mutate, drawing random numbers from gen.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
+
+protected:
+  // Random number generator.
+  Random &gen_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_MUTATOR_MUTATOR_RECOMBINE_COVERED_H_
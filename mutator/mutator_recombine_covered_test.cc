@@ -0,0 +1,63 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator_recombine_covered.h"
+
+#include <gtest/gtest.h>
+
+// TODO: Remove relative path.
+#include "../util/random_mock.h"
+
+namespace {
+
+TEST(MutatorRecombineCoveredTest, MutateGenome) {
+  std::vector<char> code1(64, '\x90');
+  std::vector<char> code2(64);
+  for (int i = 0; i < 64; ++i)
+    code2[i] = i;
+  // Offset 40 executed in parent1 (offsets 40 and 41 live), offset 20 in
+  // parent2 (offsets 20 and 21 live).
+  std::vector<uint8_t> coverage1(8, 0), coverage2(8, 0);
+  coverage1[5] = 1;
+  coverage2[2] = 1 << 4;
+
+  viaevo::Genome parent1, parent2;
+  parent1.code = code1.data();
+  parent1.size = code1.size();
+  parent1.coverage = coverage1.data();
+  parent2.code = code2.data();
+  parent2.size = code2.size();
+  parent2.coverage = coverage2.data();
+
+  // Insert 3 bytes of parent2's code from offset 21 at offset 40.
+  viaevo::RandomMock gen({1, 3, 0});
+  viaevo::MutatorRecombineCovered mutator(gen);
+  std::vector<char> target = code1;
+  mutator.MutateGenome(target.data(), parent1, parent2, gen);
+  std::vector<char> expected = code1;
+  expected[40] = 21;
+  expected[41] = 22;
+  expected[42] = 23;
+  EXPECT_EQ(target, expected);
+
+  // Without coverage, the positions are random within the whole code.
+  parent1.coverage = nullptr;
+  parent2.coverage = nullptr;
+  gen.set_values({5, 2, 60});
+  target = code1;
+  mutator.MutateGenome(target.data(), parent1, parent2, gen);
+  expected = code1;
+  expected[60] = 5;
+  expected[61] = 6;
+  EXPECT_EQ(target, expected);
+
+  // Large random numbers do not cause out of bounds accesses.
+  parent1.coverage = coverage1.data();
+  parent2.coverage = coverage2.data();
+  gen.set_values({5'000'000, 10'000'000, 15'000'000});
+  mutator.MutateGenome(target.data(), parent1, parent2, gen);
+}
+
+} // namespace
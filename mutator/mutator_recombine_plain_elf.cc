@@ -5,6 +5,8 @@
 
 #include "mutator_recombine_plain_elf.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <memory>
 
@@ -12,30 +14,32 @@ namespace viaevo {
 
 MutatorRecombinePlainElf::MutatorRecombinePlainElf(
     Random &gen, std::string elf_filename, bool initialize_program_to_all_nops)
-    : gen_(gen), standard_program_(Program::Create(elf_filename)) {
-  if (initialize_program_to_all_nops) {
-    standard_program_->SetElfCodeToAllNops();
-  }
-}
+    : gen_(gen), template_genome_(TemplateGenome::Get(
+                     elf_filename, initialize_program_to_all_nops)) {}
 
 void MutatorRecombinePlainElf::Mutate(std::shared_ptr<Program> target,
                                       std::shared_ptr<Program> parent1,
                                       std::shared_ptr<Program> parent2) {
-  std::vector<char> code1 = parent1->GetElfCode();
-  std::vector<char> code2 = standard_program_->GetElfCode();
+  MutateViaGenome(target, parent1, parent2, gen_, false);
+}
+
+void MutatorRecombinePlainElf::MutateGenome(char *target, const Genome &parent1,
+                                            const Genome &parent2,
+                                            Random &gen) {
+  const char *code2 = template_genome_->code();
+  size_t code2_total_size = template_genome_->code_size();
 
-  auto code2_start = gen_() % code2.size();
-  auto code2_size = gen_() % (code2.size() - code2_start);
+  mt_type::result_type random_numbers[3];
+  gen.Fill(random_numbers, 3);
 
-  auto code1_position = gen_() % code1.size();
+  auto code2_start = random_numbers[0] % code2_total_size;
+  auto code2_size = random_numbers[1] % (code2_total_size - code2_start);
 
-  code2_size = std::min(code2_size, code1.size() - code1_position);
+  auto code1_position = random_numbers[2] % parent1.size;
 
-  for (unsigned long i = 0; i < code2_size; ++i) {
-    code1[code1_position + i] = code2[code2_start + i];
-  }
+  code2_size = std::min(code2_size, parent1.size - code1_position);
 
-  target->SetElfCode(code1);
+  memcpy(target + code1_position, code2 + code2_start, code2_size);
 }
 
 } // namespace viaevo
@@ -8,18 +8,20 @@
 
 #include "mutator.h"
 
-// TODO: Remove relative path.
+// TODO: Remove relative paths.
+#include "../program/template_genome.h"
 #include "../util/random.h"
 #include <memory>
 
 namespace viaevo {
 
 // MutatorRecombinePlainElf creates new code for target based on parent1 and
-// and a standard program held by the mutator. The standard program serves as
-// parent2 and the parent2 passed to Mutate member function is ignored. Target's
-// code is based on parent1's code with a random subarray of standard program's
-// code placed in a random position of parent1' code overwriting the
-// corresponding part of parent1's code. The insert can be truncated not to
+// and a standard program's code (a TemplateGenome shared by all mutators for
+// the same ELF). The standard program serves as parent2 and the parent2 passed
+// to Mutate member function is ignored. Target's code is based on parent1's
+// code with a random subarray of standard program's code placed in a random
+// position of parent1' code overwriting the corresponding part of parent1's
+// code. The insert can be truncated not to
 // exceed the code size limit. All positions are "byte-aligned". Parent1 and
 // parent2 are not modified.
 //
@@ -35,16 +37,19 @@ public:
   virtual void Mutate(std::shared_ptr<Program> target,
                       std::shared_ptr<Program> parent1,
                       std::shared_ptr<Program> parent2) override;
+  // Same as Mutate, drawing random numbers from gen.
+  virtual void MutateGenome(char *target, const Genome &parent1,
+                            const Genome &parent2, Random &gen) override;
 
-  const std::shared_ptr<Program> standard_program() {
-    return standard_program_;
+  const std::shared_ptr<const TemplateGenome> template_genome() {
+    return template_genome_;
   }
 
 protected:
   // Random number generator.
   Random &gen_;
-  // Standard program to serve as parent2.
-  std::shared_ptr<Program> standard_program_;
+  // Standard program's code (immutable and shared) to serve as parent2.
+  std::shared_ptr<const TemplateGenome> template_genome_;
 };
 
 } // namespace viaevo
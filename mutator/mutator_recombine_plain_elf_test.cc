@@ -39,8 +39,10 @@ TEST(MutatorRecombinePlainElfTest, Mutate) {
   viaevo::MutatorRecombinePlainElf mutator(gen, "elfs/simple_small");
 
   std::vector<char> old_parent1_code = parent1->GetElfCode();
-  std::vector<char> old_standard_elf_code =
-      mutator.standard_program()->GetElfCode();
+  std::vector<char> old_standard_elf_code(
+      mutator.template_genome()->code(),
+      mutator.template_genome()->code() +
+          mutator.template_genome()->code_size());
 
   EXPECT_FALSE(std::all_of(old_standard_elf_code.begin(),
                            old_standard_elf_code.end(),
@@ -50,8 +52,10 @@ TEST(MutatorRecombinePlainElfTest, Mutate) {
 
   std::vector<char> new_target_code = target->GetElfCode();
   std::vector<char> new_parent1_code = parent1->GetElfCode();
-  std::vector<char> new_standard_elf_code =
-      mutator.standard_program()->GetElfCode();
+  std::vector<char> new_standard_elf_code(
+      mutator.template_genome()->code(),
+      mutator.template_genome()->code() +
+          mutator.template_genome()->code_size());
 
   // Parent code should be unaltered.
   EXPECT_EQ(old_parent1_code, new_parent1_code);
@@ -96,7 +100,9 @@ TEST(MutatorRecombinePlainElfTest, InitializeProgramToAllNops) {
 
   viaevo::MutatorRecombinePlainElf mutator(gen, "elfs/simple_small", true);
 
-  std::vector<char> code = mutator.standard_program()->GetElfCode();
+  std::vector<char> code(mutator.template_genome()->code(),
+                         mutator.template_genome()->code() +
+                             mutator.template_genome()->code_size());
   EXPECT_TRUE(code.size() > 0);
   EXPECT_TRUE(std::all_of(code.begin(), code.end(),
                           [](char value) { return value == '\x90'; }));
@@ -14,21 +14,24 @@ MutatorRecombineRandom::MutatorRecombineRandom(Random &gen) : gen_(gen) {}
 void MutatorRecombineRandom::Mutate(std::shared_ptr<Program> target,
                                     std::shared_ptr<Program> parent1,
                                     std::shared_ptr<Program> parent2) {
-  std::vector<char> code1 = parent1->GetElfCode();
-  std::vector<char> code2 = parent2->GetElfCode();
+  MutateViaGenome(target, parent1, parent2, gen_);
+}
+
+void MutatorRecombineRandom::MutateGenome(char *target, const Genome &parent1,
+                                          const Genome &parent2, Random &gen) {
+  mt_type::result_type random_numbers[3];
+  gen.Fill(random_numbers, 3);
 
-  auto code2_start = gen_() % code2.size();
-  auto code2_size = gen_() % (code2.size() - code2_start);
+  auto code2_start = random_numbers[0] % parent2.size;
+  auto code2_size = random_numbers[1] % (parent2.size - code2_start);
 
-  auto code1_position = gen_() % code1.size();
+  auto code1_position = random_numbers[2] % parent1.size;
 
-  code2_size = std::min(code2_size, code1.size() - code1_position);
+  code2_size = std::min(code2_size, parent1.size - code1_position);
 
   for (unsigned long i = 0; i < code2_size; ++i) {
-    code1[code1_position + i] = code2[code2_start + i];
+    target[code1_position + i] = parent2.code[code2_start + i];
   }
-
-  target->SetElfCode(code1);
 }
 
 } // namespace viaevo
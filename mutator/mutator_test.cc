@@ -0,0 +1,139 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "mutator.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "genome_arena.h"
+#include "mutator_composite_weighted.h"
+#include "mutator_instruction_field.h"
+#include "mutator_instruction_replace.h"
+#include "mutator_mock.h"
+#include "mutator_point_last_instruction.h"
+#include "mutator_point_random.h"
+#include "mutator_recombine_aligned.h"
+#include "mutator_recombine_plain_elf.h"
+#include "mutator_recombine_random.h"
+
+// TODO: Remove relative paths.
+#include "../util/random_stream.h"
+#include "../util/worker_pool.h"
+
+namespace {
+
+// Returns a composite of all mutators drawing random numbers from gen.
+std::unique_ptr<viaevo::MutatorCompositeWeighted>
+CreateMutator(viaevo::Random &gen) {
+  std::unique_ptr<viaevo::MutatorCompositeWeighted> mutator(
+      new viaevo::MutatorCompositeWeighted(gen));
+  mutator->AppendMutator(std::make_shared<viaevo::MutatorPointRandom>(gen));
+  mutator->AppendMutator(
+      std::make_shared<viaevo::MutatorPointLastInstruction>(gen));
+  mutator->AppendMutator(std::make_shared<viaevo::MutatorRecombineRandom>(gen));
+  mutator->AppendMutator(std::make_shared<viaevo::MutatorRecombinePlainElf>(
+      gen, "elfs/simple_small"));
+  mutator->AppendMutator(
+      std::make_shared<viaevo::MutatorRecombineAligned>(gen, false));
+  mutator->AppendMutator(
+      std::make_shared<viaevo::MutatorRecombineAligned>(gen, true));
+  for (auto field : {viaevo::MutatorInstructionField::kOpcode,
+                     viaevo::MutatorInstructionField::kOperands,
+                     viaevo::MutatorInstructionField::kImmediate}) {
+    mutator->AppendMutator(
+        std::make_shared<viaevo::MutatorInstructionField>(gen, field));
+  }
+  mutator->AppendMutator(
+      std::make_shared<viaevo::MutatorInstructionReplace>(gen));
+  return mutator;
+}
+
+TEST(MutatorTest, MutateBatch) {
+  constexpr int kNumParents = 3;
+  constexpr int kNumOffspring = 40;
+  std::vector<std::shared_ptr<viaevo::Program>> parents;
+  for (int i = 0; i < kNumParents; ++i)
+    parents.push_back(viaevo::Program::Create("elfs/simple_small"));
+  // Diverse parents (and last rip offsets).
+  viaevo::Random parent_gen;
+  viaevo::MutatorPointRandom parent_mutator(parent_gen);
+  for (int i = 1; i < kNumParents; ++i) {
+    for (int j = 0; j < 50 * i; ++j)
+      parent_mutator.Mutate(parents[i], parents[i], parents[i]);
+  }
+  size_t size = parents[0]->elf_code_size();
+
+  viaevo::GenomeArena parents_arena;
+  parents_arena.Reset(kNumParents, size);
+  for (int i = 0; i < kNumParents; ++i)
+    parents_arena.Load(i, *parents[i]);
+  parents_arena.set_last_rip_offset(1, 10);
+
+  std::vector<viaevo::MutationSlot> slots(kNumOffspring);
+  for (int i = 0; i < kNumOffspring; ++i) {
+    slots[i].target = kNumOffspring - 1 - i;
+    slots[i].parent1 = i % kNumParents;
+    slots[i].parent2 = (i / kNumParents) % kNumParents;
+  }
+
+  viaevo::RandomStream streams(42);
+  viaevo::RandomStream unused_gen;
+  std::unique_ptr<viaevo::MutatorCompositeWeighted> mutator =
+      CreateMutator(unused_gen);
+  viaevo::GenomeArena offspring;
+  offspring.Reset(kNumOffspring, size);
+  mutator->MutateBatch(parents_arena, slots, offspring, streams, 7);
+
+  // The same offspring with a WorkerPool.
+  viaevo::WorkerPool pool(3);
+  viaevo::GenomeArena offspring_pooled;
+  offspring_pooled.Reset(kNumOffspring, size);
+  mutator->MutateBatch(parents_arena, slots, offspring_pooled, streams, 7,
+                       &pool);
+  EXPECT_EQ(std::vector<char>(offspring.code(0),
+                              offspring.code(0) + kNumOffspring * size),
+            std::vector<char>(offspring_pooled.code(0),
+                              offspring_pooled.code(0) + kNumOffspring * size));
+
+  // Mutate creates the same offspring with the slots' random streams.
+  std::shared_ptr<viaevo::Program> target =
+      viaevo::Program::Create("elfs/simple_small");
+  int changed = 0;
+  for (int i = 0; i < kNumOffspring; ++i) {
+    viaevo::RandomStream gen =
+        streams.Derive(7, i, viaevo::Mutator::kMutationPurpose);
+    std::unique_ptr<viaevo::MutatorCompositeWeighted> slot_mutator =
+        CreateMutator(gen);
+    // Mutate reads the last rip offset from the program.
+    if (slots[i].parent1 == 1)
+      continue;
+    slot_mutator->Mutate(target, parents[slots[i].parent1],
+                         parents[slots[i].parent2]);
+    std::vector<char> code = target->GetElfCode();
+    const char *batch_code = offspring.code(slots[i].target);
+    EXPECT_EQ(code, std::vector<char>(batch_code, batch_code + size))
+        << "slot " << i;
+    if (code != parents[slots[i].parent1]->GetElfCode())
+      ++changed;
+  }
+  EXPECT_GT(changed, 0);
+}
+
+TEST(MutatorTest, MutateGenomeNotImplemented) {
+  viaevo::MutatorMock mutator;
+  std::vector<char> code(16, '\x90');
+  viaevo::Genome genome;
+  genome.code = code.data();
+  genome.size = code.size();
+  viaevo::Random gen;
+  // Fails also with NDEBUG.
+  EXPECT_DEATH(mutator.MutateGenome(code.data(), genome, genome, gen),
+               "MutateGenome is not implemented by the mutator");
+}
+
+} // namespace
@@ -0,0 +1,63 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+// Prints a C++ source file registering Program manifest entries for the given
+// ELFs (see Program::ManifestEntry and //elfs:elf_manifest). Each argument is
+// <name>=<path> where name is the filename later passed to Program::Create
+// (e.g. elfs/simple_small) and path is the ELF to parse and execute.
+
+#include <iostream>
+#include <string>
+
+#include "program.h"
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <name>=<path>...\n";
+    return 1;
+  }
+
+  std::cout << "// Generated by //program:elf_manifest_gen. Do not edit.\n\n"
+            << "#include \"program/program.h\"\n\n"
+            << "namespace {\n\n"
+            << "constexpr viaevo::Program::ManifestEntry kElfManifest[] = {\n";
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    size_t separator = arg.find('=');
+    if (separator == std::string::npos) {
+      std::cerr << "Expected <name>=<path>: " << arg << "\n";
+      return 1;
+    }
+    std::string name = arg.substr(0, separator);
+    std::string path = arg.substr(separator + 1);
+
+    viaevo::Program::ManifestEntry entry =
+        viaevo::Program::CreateManifestEntry(path);
+    std::cout << "    {\"" << name << "\", " << entry.main_offset_in_elf
+              << "u, " << entry.main_offset_in_text << "u, " << entry.main_size
+              << "u, " << entry.inputs_offset_in_elf << "u, "
+              << entry.inputs_size << "u, " << entry.results_offset_in_data
+              << "u, " << entry.results_size << "u, "
+              << entry.data_offset_in_elf << "u, " << entry.data_size << "u, "
+              << entry.expected_ptrace_stops << ", "
+              << entry.batch_size_offset_in_data << "u, "
+              << entry.batch_slot_offset_in_data << "u, "
+              << entry.batch_inputs_offset_in_data << "u, "
+              << entry.batch_inputs_size << "u, "
+              << entry.batch_results_offset_in_data << "u, "
+              << entry.batch_results_size << "u},\n";
+  }
+
+  std::cout << "};\n\n"
+            << "const bool kElfManifestRegistered __attribute__((unused)) =\n"
+            << "    [] {\n"
+            << "      for (const auto &entry : kElfManifest)\n"
+            << "        viaevo::Program::RegisterManifestEntry(entry);\n"
+            << "      return true;\n"
+            << "    }();\n\n"
+            << "} // namespace\n";
+  return 0;
+}
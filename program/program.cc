@@ -9,9 +9,12 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <seccomp.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <sys/personality.h>
+#include <sys/prctl.h>
 #include <sys/ptrace.h>
 #include <sys/time.h>
 #include <sys/uio.h>
@@ -19,9 +22,11 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 namespace viaevo {
 
@@ -32,12 +37,89 @@ void myfail(const char *s) {
   exit(EXIT_FAILURE);
 }
 
+// Reads the string table described by shdr. The returned table is terminated
+// by '\0' (even if the section is not) so that the strings can be read safely.
+std::vector<char> ReadElfStringTable(int fd, const Elf64_Shdr &shdr) {
+  std::vector<char> table(shdr.sh_size + 1, '\0');
+  ssize_t nread = pread(fd, table.data(), shdr.sh_size, shdr.sh_offset);
+  if (nread != (ssize_t)shdr.sh_size)
+    myfail("string table read failed");
+  return table;
+}
+
+// Reads the addresses of the code and data segments of the process pid from
+// /proc/[pid]/stat.
+void ReadProcStat(pid_t pid, unsigned long *start_code,
+                  unsigned long *start_data) {
+  std::string proc_file_name =
+      std::string("/proc/") + std::to_string(pid) + std::string("/stat");
+
+  int proc_pid;
+  std::string proc_comm;
+  char proc_state;
+  unsigned long dummy_ul;
+  unsigned long end_code, kstkeip, end_data;
+
+  std::ifstream ifs(proc_file_name);
+  ifs >> proc_pid >> proc_comm >> proc_state;
+  // Skip to start_data.
+  // NOTE: some of the fields are not unsigned, using the unsigned long dummy_ul
+  // variable may not be appropriate.
+  for (int i = 0; i < 22; ++i)
+    ifs >> dummy_ul;
+  ifs >> *start_code >> end_code;
+  for (int i = 0; i < 2; ++i)
+    ifs >> dummy_ul;
+  ifs >> kstkeip;
+  for (int i = 0; i < 14; ++i)
+    ifs >> dummy_ul;
+  ifs >> *start_data >> end_data;
+
+  if (*start_data > end_data)
+    myfail("start_data > end_data");
+
+  // printf("start_data: %lx, end_data %lx, diff: %lx\n", *start_data,
+  //        end_data, end_data - *start_data);
+}
+
 } // namespace
 
+struct Program::Batch {
+  // Inputs of the slots (rows of the size of the ELF's inputs).
+  const int *inputs = nullptr;
+  size_t num_slots = 0;
+  // batch_slot of the process at its last ptrace stop, i.e. the slot that
+  // stopped the process or num_slots if all slots completed. -1 if unknown
+  // (e.g. the process was killed before).
+  size_t stopped_slot = -1;
+  // Results of the completed slots [0, stopped_slot) (rows of the size of the
+  // ELF's results).
+  std::vector<int> results;
+};
+
+struct Program::CoverageTrace {
+  enum State {
+    kInactive,
+    // Waiting for the last ptrace stop before main.
+    kPending,
+    // Waiting for the breakpoint at the beginning of main.
+    kBreakpoint,
+    // Single-stepping main.
+    kStepping,
+  };
+  State state = kInactive;
+  unsigned long long main_address = 0;
+  // Original word at main_address (overwritten by the breakpoint).
+  long main_word = 0;
+  int steps = 0;
+};
+
 std::unordered_map<std::string, Program::SymbolData> Program::symbol_data_map_;
 
 std::unordered_map<std::string, int> Program::expected_ptrace_stops_map_;
 
+std::mutex Program::create_mutex_;
+
 Program::Program(const char *filename) { SetupElfInMemory(filename); }
 
 Program::Program(const char *filename, SymbolData symbol_data,
@@ -61,15 +143,94 @@ bool Program::IsInitialized() const {
 }
 
 std::shared_ptr<Program> Program::Create(const std::string filename) {
-  if (symbol_data_map_.count(filename) == 0 ||
-      expected_ptrace_stops_map_.count(filename) == 0) {
-    Program p(filename.c_str());
-    p.InitializeElfSymbolData();
-    symbol_data_map_[filename] = p.symbol_data_;
-    expected_ptrace_stops_map_[filename] = p.Execute();
+  SymbolData symbol_data;
+  int expected_ptrace_stops;
+  {
+    std::lock_guard<std::mutex> lock(create_mutex_);
+    if (symbol_data_map_.count(filename) == 0 ||
+        expected_ptrace_stops_map_.count(filename) == 0) {
+      auto it = manifest_entries().find(filename);
+      if (it != manifest_entries().end()) {
+        const ManifestEntry &entry = it->second;
+        SymbolData &data = symbol_data_map_[filename];
+        data.main_offset_in_elf_ = entry.main_offset_in_elf;
+        data.main_offset_in_text_ = entry.main_offset_in_text;
+        data.main_st_size_ = entry.main_size;
+        data.inputs_offset_in_elf_ = entry.inputs_offset_in_elf;
+        data.inputs_st_size_ = entry.inputs_size;
+        data.results_offset_in_data_ = entry.results_offset_in_data;
+        data.results_st_size_ = entry.results_size;
+        data.data_offset_in_elf_ = entry.data_offset_in_elf;
+        data.data_st_size_ = entry.data_size;
+        data.batch_size_offset_in_data_ = entry.batch_size_offset_in_data;
+        data.batch_slot_offset_in_data_ = entry.batch_slot_offset_in_data;
+        data.batch_inputs_offset_in_data_ = entry.batch_inputs_offset_in_data;
+        data.batch_inputs_st_size_ = entry.batch_inputs_size;
+        data.batch_results_offset_in_data_ =
+            entry.batch_results_offset_in_data;
+        data.batch_results_st_size_ = entry.batch_results_size;
+        expected_ptrace_stops_map_[filename] = entry.expected_ptrace_stops;
+      } else {
+        Program p(filename.c_str());
+        p.InitializeElfSymbolData();
+        symbol_data_map_[filename] = p.symbol_data_;
+        expected_ptrace_stops_map_[filename] = p.Execute();
+      }
+    }
+    symbol_data = symbol_data_map_[filename];
+    expected_ptrace_stops = expected_ptrace_stops_map_[filename];
   }
-  return std::make_shared<Program>(filename.c_str(), symbol_data_map_[filename],
-                                   expected_ptrace_stops_map_[filename]);
+  return std::make_shared<Program>(filename.c_str(), symbol_data,
+                                   expected_ptrace_stops);
+}
+
+std::unordered_map<std::string, Program::ManifestEntry> &
+Program::manifest_entries() {
+  static std::unordered_map<std::string, ManifestEntry> entries;
+  return entries;
+}
+
+void Program::RegisterManifestEntry(const ManifestEntry &entry) {
+  std::lock_guard<std::mutex> lock(create_mutex_);
+  manifest_entries().emplace(entry.filename, entry);
+}
+
+bool Program::FindManifestEntry(const std::string &filename,
+                                ManifestEntry *entry) {
+  std::lock_guard<std::mutex> lock(create_mutex_);
+  auto it = manifest_entries().find(filename);
+  if (it == manifest_entries().end())
+    return false;
+  *entry = it->second;
+  return true;
+}
+
+Program::ManifestEntry
+Program::CreateManifestEntry(const std::string &filename) {
+  Program p(filename.c_str());
+  p.InitializeElfSymbolData();
+  int expected_ptrace_stops = p.Execute();
+
+  const SymbolData &data = p.symbol_data_;
+  ManifestEntry entry;
+  entry.filename = nullptr;
+  entry.main_offset_in_elf = data.main_offset_in_elf_;
+  entry.main_offset_in_text = data.main_offset_in_text_;
+  entry.main_size = data.main_st_size_;
+  entry.inputs_offset_in_elf = data.inputs_offset_in_elf_;
+  entry.inputs_size = data.inputs_st_size_;
+  entry.results_offset_in_data = data.results_offset_in_data_;
+  entry.results_size = data.results_st_size_;
+  entry.data_offset_in_elf = data.data_offset_in_elf_;
+  entry.data_size = data.data_st_size_;
+  entry.expected_ptrace_stops = expected_ptrace_stops;
+  entry.batch_size_offset_in_data = data.batch_size_offset_in_data_;
+  entry.batch_slot_offset_in_data = data.batch_slot_offset_in_data_;
+  entry.batch_inputs_offset_in_data = data.batch_inputs_offset_in_data_;
+  entry.batch_inputs_size = data.batch_inputs_st_size_;
+  entry.batch_results_offset_in_data = data.batch_results_offset_in_data_;
+  entry.batch_results_size = data.batch_results_st_size_;
+  return entry;
 }
 
 void Program::SetupElfInMemory(const char *filename) {
@@ -134,7 +295,13 @@ void Program::SaveElf(const char *filename) {
   close(fd_to);
 }
 
-void Program::ClearResultsHistory() { results_history_.clear(); }
+void Program::ClearResultsHistory() { results_history_.Clear(); }
+
+void Program::ReserveResultsHistory(int executions) {
+  size_t results_size = symbol_data_.results_st_size_ /
+                        sizeof(decltype(last_results_)::value_type);
+  results_history_.Reserve(executions, results_size);
+}
 
 void Program::InitializeElfSymbolData() {
   if (elf_mem_fd_ == -1)
@@ -171,22 +338,14 @@ void Program::InitializeElfSymbolData() {
   // }
 
   // Read the section header string table.
-#define SBUF_SIZE 512
-  char sbuf[SBUF_SIZE];
-  if (shdrs[ehdr.e_shstrndx].sh_size >= sizeof(sbuf))
-    myfail("sbuf too small for shstrtab");
-
-  offset = lseek(elf_mem_fd_, shdrs[ehdr.e_shstrndx].sh_offset, SEEK_SET);
-  if (offset != (off_t)shdrs[ehdr.e_shstrndx].sh_offset)
-    myfail("lseek to shdrs[ehdr.e_shstrndx].sh_offset failed");
-
-  nread = read(elf_mem_fd_, sbuf, shdrs[ehdr.e_shstrndx].sh_size);
-  if (nread != (off_t)shdrs[ehdr.e_shstrndx].sh_size)
-    myfail("section header string table read failed");
+  std::vector<char> shstrtab =
+      ReadElfStringTable(elf_mem_fd_, shdrs[ehdr.e_shstrndx]);
 
   std::unordered_map<std::string, int> name_to_shdrs_index;
   for (int i = 0; i < (int)shdrs.size(); ++i) {
-    std::string str(&sbuf[shdrs[i].sh_name]);
+    if (shdrs[i].sh_name >= shstrtab.size())
+      myfail("section name out of bounds of shstrtab");
+    std::string str(&shstrtab[shdrs[i].sh_name]);
     name_to_shdrs_index[str] = i;
     // printf("%s: %d\n", str.c_str(), i);
   }
@@ -219,20 +378,14 @@ void Program::InitializeElfSymbolData() {
     myfail(".strtab not found");
   int strtab_index = name_to_shdrs_index[".strtab"];
 
-  if (shdrs[strtab_index].sh_size >= sizeof(sbuf))
-    myfail("sbuf too small for strtab");
-
-  offset = lseek(elf_mem_fd_, shdrs[strtab_index].sh_offset, SEEK_SET);
-  if (offset != (off_t)shdrs[strtab_index].sh_offset)
-    myfail("lseek to shdrs[ehdr.e_shstrndx].sh_offset failed");
-
-  nread = read(elf_mem_fd_, sbuf, shdrs[strtab_index].sh_size);
-  if (nread != (ssize_t)shdrs[strtab_index].sh_size)
-    myfail("symbol table string table read failed");
+  std::vector<char> strtab =
+      ReadElfStringTable(elf_mem_fd_, shdrs[strtab_index]);
 
   std::unordered_map<std::string, int> name_to_syms_index;
   for (int i = 0; i < (int)syms.size(); ++i) {
-    std::string str(&sbuf[syms[i].st_name]);
+    if (syms[i].st_name >= strtab.size())
+      myfail("symbol name out of bounds of strtab");
+    std::string str(&strtab[syms[i].st_name]);
     name_to_syms_index[str] = i;
     // printf("%s: %d\n", str.c_str(), i);
   }
@@ -266,6 +419,9 @@ void Program::InitializeElfSymbolData() {
       (shdrs[data_index].sh_addr - shdrs[data_index].sh_offset);
   symbol_data_.inputs_st_size_ = syms[inputs_index].st_size;
 
+  symbol_data_.data_offset_in_elf_ = shdrs[data_index].sh_offset;
+  symbol_data_.data_st_size_ = shdrs[data_index].sh_size;
+
   if (name_to_syms_index.count("data_start") < 1)
     myfail("symbol data_start not found");
   int data_start_index = name_to_syms_index["data_start"];
@@ -276,11 +432,136 @@ void Program::InitializeElfSymbolData() {
   symbol_data_.results_offset_in_data_ =
       syms[results_index].st_value - syms[data_start_index].st_value;
   symbol_data_.results_st_size_ = syms[results_index].st_size;
+
+  // The batch variables are optional (ELFs without the batch harness are
+  // executed once per slot by ExecuteBatch).
+  struct {
+    const char *name;
+    Elf64_Addr *offset_in_data;
+    uint64_t *st_size;
+  } batch_symbols[] = {
+      {"batch_size", &symbol_data_.batch_size_offset_in_data_, nullptr},
+      {"batch_slot", &symbol_data_.batch_slot_offset_in_data_, nullptr},
+      {"batch_inputs", &symbol_data_.batch_inputs_offset_in_data_,
+       &symbol_data_.batch_inputs_st_size_},
+      {"batch_results", &symbol_data_.batch_results_offset_in_data_,
+       &symbol_data_.batch_results_st_size_},
+  };
+  for (const auto &symbol : batch_symbols) {
+    if (name_to_syms_index.count(symbol.name) < 1)
+      continue;
+    int index = name_to_syms_index[symbol.name];
+    *symbol.offset_in_data =
+        syms[index].st_value - syms[data_start_index].st_value;
+    if (symbol.st_size != nullptr)
+      *symbol.st_size = syms[index].st_size;
+  }
 }
 
 int Program::Execute(int max_ptrace_stops) {
   ClearLastState();
+  return ForkAndMonitorElfProcess(max_ptrace_stops, nullptr);
+}
+
+bool Program::HasBatchHarness() const {
+  return symbol_data_.batch_size_offset_in_data_ != (Elf64_Addr)-1 &&
+         symbol_data_.batch_slot_offset_in_data_ != (Elf64_Addr)-1 &&
+         symbol_data_.batch_inputs_offset_in_data_ != (Elf64_Addr)-1 &&
+         symbol_data_.batch_inputs_st_size_ != (uint64_t)-1 &&
+         symbol_data_.batch_results_offset_in_data_ != (Elf64_Addr)-1 &&
+         symbol_data_.batch_results_st_size_ != (uint64_t)-1;
+}
+
+int Program::ExecuteBatch(const int *inputs_batch, size_t inputs_size,
+                          size_t num_slots,
+                          std::vector<std::vector<int>> *slot_results) {
+  last_batch_stopped_slots_.clear();
+  slot_results->resize(num_slots);
+
+  if (!HasBatchHarness()) {
+    std::vector<int> elf_inputs = GetElfInputs();
+    for (size_t slot = 0; slot < num_slots; ++slot) {
+      SetElfInputs(inputs_batch + slot * inputs_size, inputs_size);
+      Execute();
+      (*slot_results)[slot] = last_results_;
+    }
+    SetElfInputs(elf_inputs);
+    return num_slots;
+  }
+
+  if (inputs_size * sizeof(*inputs_batch) > symbol_data_.inputs_st_size_)
+    myfail("batch inputs are too large");
+
+  // The slots are padded to the size of the ELF's inputs with the ELF's inputs
+  // (as SetElfInputs keeps the inputs past the inputs set).
+  std::vector<int> elf_inputs = GetElfInputs();
+  size_t row_size = elf_inputs.size();
+  size_t results_size = symbol_data_.results_st_size_ /
+                        sizeof(decltype(last_results_)::value_type);
+  size_t max_slots =
+      symbol_data_.batch_inputs_st_size_ / symbol_data_.inputs_st_size_;
+  std::vector<int> rows;
+
+  int processes = 0;
+  size_t slot = 0;
+  while (slot < num_slots) {
+    Batch batch;
+    batch.num_slots = std::min(max_slots, num_slots - slot);
+    rows.resize(batch.num_slots * row_size);
+    for (size_t j = 0; j < batch.num_slots; ++j) {
+      int *row = rows.data() + j * row_size;
+      std::copy(elf_inputs.begin(), elf_inputs.end(), row);
+      const int *inputs = inputs_batch + (slot + j) * inputs_size;
+      std::copy(inputs, inputs + inputs_size, row);
+    }
+    batch.inputs = rows.data();
+
+    ClearLastState();
+    ForkAndMonitorElfProcess(-1, &batch);
+    ++processes;
+
+    // The slot that stopped the process is executed on its own if the progress
+    // of the process is unknown or if the process ran out of time after
+    // completing other slots (the time limit of the process covers all its
+    // slots, i.e. the slot may not have run out of time on its own).
+    bool execute_alone = false;
+    if (batch.stopped_slot > batch.num_slots) {
+      batch.stopped_slot = 0;
+      execute_alone = true;
+    } else if (batch.stopped_slot > 0 &&
+               batch.stopped_slot < batch.num_slots &&
+               last_stop_signal_ == SIGALRM) {
+      execute_alone = true;
+    }
+
+    for (size_t j = 0; j < batch.stopped_slot; ++j, ++slot) {
+      std::vector<int> &results = (*slot_results)[slot];
+      results.assign(batch.results.begin() + j * results_size,
+                     batch.results.begin() + (j + 1) * results_size);
+      if (track_results_history_)
+        results_history_.Append(results);
+    }
+    if (batch.stopped_slot < batch.num_slots) {
+      if (execute_alone) {
+        // Execute appends the results history.
+        SetElfInputs(inputs_batch + slot * inputs_size, inputs_size);
+        Execute();
+        SetElfInputs(elf_inputs);
+        ++processes;
+      } else if (track_results_history_) {
+        // The results of the slot that stopped the process are read at the
+        // stop (as for Execute).
+        results_history_.Append(last_results_);
+      }
+      (*slot_results)[slot] = last_results_;
+      last_batch_stopped_slots_.push_back(slot);
+      ++slot;
+    }
+  }
+  return processes;
+}
 
+int Program::ForkAndMonitorElfProcess(int max_ptrace_stops, Batch *batch) {
   pid_t pid;
 
   pid = fork();
@@ -290,7 +571,7 @@ int Program::Execute(int max_ptrace_stops) {
     myfail("fork failed");
 
   if (pid > 0) {
-    return MonitorElfProcess(pid, max_ptrace_stops);
+    return MonitorElfProcess(pid, max_ptrace_stops, batch);
   } else {
     RunElfProcess();
   }
@@ -300,7 +581,8 @@ int Program::Execute(int max_ptrace_stops) {
   return -1; // Keep the linter happy.
 }
 
-int Program::MonitorElfProcess(pid_t elf_pid, int max_ptrace_stops) {
+int Program::MonitorElfProcess(pid_t elf_pid, int max_ptrace_stops,
+                               Batch *batch) {
   int status, ptrace_stops_count = 0;
   pid_t w;
   struct user_regs_struct regs;
@@ -308,6 +590,13 @@ int Program::MonitorElfProcess(pid_t elf_pid, int max_ptrace_stops) {
   if (max_ptrace_stops == -1)
     max_ptrace_stops = expected_ptrace_stops_;
 
+  CoverageTrace trace;
+  if (coverage_executions_ > 0 && expected_ptrace_stops_ > 0) {
+    --coverage_executions_;
+    trace.state = CoverageTrace::kPending;
+  }
+  unsigned long long time_stamp_counter = 0;
+
   // printf("In parent, child pid: %d\n", elf_pid);
   // printf("In parent, parent pid: %d\n", getpid());
 
@@ -324,8 +613,18 @@ int Program::MonitorElfProcess(pid_t elf_pid, int max_ptrace_stops) {
       last_term_signal_ = WTERMSIG(status);
       // printf("killed by signal %d\n", last_term_signal_);
     } else if (WIFSTOPPED(status)) {
+      if (ContinueCoverageTrace(elf_pid, status, trace))
+        continue;
+      // Emulated rdtsc instructions are not counted as ptrace stops (the
+      // number of ptrace stops before main does not depend on the mode).
+      if (deterministic_execution_ &&
+          EmulateTimeStampCounter(elf_pid, status, time_stamp_counter))
+        continue;
+
       ++ptrace_stops_count;
-      last_stop_signal_ = WSTOPSIG(status);
+      // Syscall stops are reported as SIGTRAP | 0x80 after a coverage trace
+      // (PTRACE_O_TRACESYSGOOD).
+      last_stop_signal_ = WSTOPSIG(status) & 0x7f;
       // printf("%4d stopped by signal %d", ptrace_stops_count,
       // last_stop_signal_);
 
@@ -363,6 +662,10 @@ int Program::MonitorElfProcess(pid_t elf_pid, int max_ptrace_stops) {
         // program's (evolved) code and ends the process. The (result) data are
         // explored at this point. The child process is killed.
         ReadLastResultsAndLastRipOffsetFromElfProcess(elf_pid, regs.rip);
+        if (batch != nullptr)
+          ReadBatchResultsFromElfProcess(elf_pid, *batch);
+        else if (track_results_history_)
+          results_history_.Append(last_results_);
         if (kill(elf_pid, SIGKILL) == -1)
           myfail("kill failed");
       } else {
@@ -379,6 +682,14 @@ int Program::MonitorElfProcess(pid_t elf_pid, int max_ptrace_stops) {
           //   if (ptrace(PTRACE_SINGLESTEP, elf_pid, NULL, NULL) == -1)
           //     myfail("PTRACE_SINGLESTEP failed");
           // } else {
+          if (trace.state == CoverageTrace::kPending &&
+              ptrace_stops_count == expected_ptrace_stops_ - 1)
+            BeginCoverageTrace(elf_pid, trace);
+          if (batch != nullptr &&
+              ptrace_stops_count == expected_ptrace_stops_ - 1)
+            WriteBatchToElfProcess(elf_pid, *batch);
+          if (deterministic_execution_ && ptrace_stops_count == 1)
+            PinRandomBytesOfElfProcess(elf_pid);
           if (ptrace(PTRACE_SYSCALL, elf_pid, 0, 0) == -1)
             myfail("PTRACE_SYSCALL failed");
           // }
@@ -394,6 +705,168 @@ int Program::MonitorElfProcess(pid_t elf_pid, int max_ptrace_stops) {
   return ptrace_stops_count;
 }
 
+void Program::BeginCoverageTrace(pid_t elf_pid, CoverageTrace &trace) {
+  trace.state = CoverageTrace::kInactive;
+  trace.main_address = ReadMainAddressFromElfProcess(elf_pid);
+  if (trace.main_address == 0)
+    return;
+
+  errno = 0;
+  trace.main_word =
+      ptrace(PTRACE_PEEKTEXT, elf_pid, trace.main_address, NULL);
+  if (errno != 0)
+    myfail("PTRACE_PEEKTEXT failed");
+  // Replace the first byte of main with int3.
+  long breakpoint = (trace.main_word & ~0xffL) | 0xcc;
+  if (ptrace(PTRACE_POKETEXT, elf_pid, trace.main_address, breakpoint) == -1)
+    myfail("PTRACE_POKETEXT failed");
+  trace.state = CoverageTrace::kBreakpoint;
+}
+
+bool Program::ContinueCoverageTrace(pid_t elf_pid, int status,
+                                    CoverageTrace &trace) {
+  if (trace.state != CoverageTrace::kBreakpoint &&
+      trace.state != CoverageTrace::kStepping)
+    return false;
+
+  struct user_regs_struct regs;
+  if (ptrace(PTRACE_GETREGS, elf_pid, 0, &regs) == -1) {
+    trace.state = CoverageTrace::kInactive;
+    return false;
+  }
+
+  if (trace.state == CoverageTrace::kBreakpoint) {
+    if (ptrace(PTRACE_POKETEXT, elf_pid, trace.main_address,
+               trace.main_word) == -1)
+      myfail("PTRACE_POKETEXT failed");
+    // Any other stop (e.g. an unexpected syscall before main) ends the trace.
+    if (WSTOPSIG(status) != SIGTRAP || regs.rip != trace.main_address + 1) {
+      trace.state = CoverageTrace::kInactive;
+      return false;
+    }
+    // Execute the restored instruction.
+    regs.rip = trace.main_address;
+    if (ptrace(PTRACE_SETREGS, elf_pid, 0, &regs) == -1)
+      myfail("PTRACE_SETREGS failed");
+    // Report syscall stops as SIGTRAP | 0x80 to tell them apart from single
+    // steps.
+    if (ptrace(PTRACE_SETOPTIONS, elf_pid, 0, PTRACE_O_TRACESYSGOOD) == -1)
+      myfail("PTRACE_SETOPTIONS failed");
+    if (coverage_.empty())
+      coverage_.assign((symbol_data_.main_st_size_ + 7) / 8, 0);
+    has_coverage_ = true;
+    trace.state = CoverageTrace::kStepping;
+  } else {
+    // Syscalls (not executed with PTRACE_SYSEMU_SINGLESTEP), signals and
+    // breakpoints (e.g. int3 in the evolved code) end the trace and are handled
+    // as without tracing.
+    siginfo_t siginfo;
+    if (WSTOPSIG(status) != SIGTRAP ||
+        ptrace(PTRACE_GETSIGINFO, elf_pid, 0, &siginfo) == -1 ||
+        siginfo.si_code != TRAP_TRACE) {
+      trace.state = CoverageTrace::kInactive;
+      return false;
+    }
+  }
+
+  // The trace ends when the execution leaves main (e.g. returns to libc).
+  unsigned long long offset = regs.rip - trace.main_address;
+  if (offset < symbol_data_.main_st_size_)
+    coverage_[offset / 8] |= 1 << (offset % 8);
+
+  if (offset >= symbol_data_.main_st_size_ ||
+      ++trace.steps >= kMaxCoverageSteps) {
+    trace.state = CoverageTrace::kInactive;
+    if (ptrace(PTRACE_SYSCALL, elf_pid, 0, 0) == -1)
+      myfail("PTRACE_SYSCALL failed");
+    return true;
+  }
+  if (ptrace(PTRACE_SYSEMU_SINGLESTEP, elf_pid, 0, 0) == -1)
+    myfail("PTRACE_SYSEMU_SINGLESTEP failed");
+  return true;
+}
+
+unsigned long long Program::ReadMainAddressFromElfProcess(pid_t elf_pid) {
+  std::string proc_file_name =
+      std::string("/proc/") + std::to_string(elf_pid) + std::string("/maps");
+
+  // Find the executable mapping of the ELF's memory file containing main.
+  std::ifstream ifs(proc_file_name);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    unsigned long long start, end, offset;
+    char perms[5];
+    if (sscanf(line.c_str(), "%llx-%llx %4s %llx", &start, &end, perms,
+               &offset) != 4)
+      continue;
+    if (perms[2] != 'x' || line.find("/memfd:viaevo_program") == line.npos)
+      continue;
+    if (symbol_data_.main_offset_in_elf_ >= offset &&
+        symbol_data_.main_offset_in_elf_ < offset + (end - start))
+      return start + (symbol_data_.main_offset_in_elf_ - offset);
+  }
+  return 0;
+}
+
+void Program::PinRandomBytesOfElfProcess(pid_t elf_pid) {
+  std::string proc_file_name =
+      std::string("/proc/") + std::to_string(elf_pid) + std::string("/auxv");
+
+  std::ifstream ifs(proc_file_name, std::ios::binary);
+  Elf64_auxv_t auxv;
+  while (ifs.read((char *)&auxv, sizeof(auxv)) && auxv.a_type != AT_NULL) {
+    if (auxv.a_type != AT_RANDOM)
+      continue;
+    // AT_RANDOM points to 16 bytes.
+    static const char kRandomBytes[16] = {};
+    struct iovec local[1];
+    struct iovec remote[1];
+    local[0].iov_base = (void *)kRandomBytes;
+    local[0].iov_len = sizeof(kRandomBytes);
+    remote[0].iov_base = (void *)auxv.a_un.a_val;
+    remote[0].iov_len = sizeof(kRandomBytes);
+    if (process_vm_writev(elf_pid, local, 1, remote, 1, 0) !=
+        sizeof(kRandomBytes))
+      myfail("process_vm_writev failed");
+    return;
+  }
+}
+
+bool Program::EmulateTimeStampCounter(pid_t elf_pid, int status,
+                                      unsigned long long &time_stamp_counter) {
+  if (WSTOPSIG(status) != SIGSEGV)
+    return false;
+
+  struct user_regs_struct regs;
+  if (ptrace(PTRACE_GETREGS, elf_pid, 0, &regs) == -1)
+    return false;
+  errno = 0;
+  long word = ptrace(PTRACE_PEEKTEXT, elf_pid, regs.rip, NULL);
+  if (errno != 0)
+    return false;
+
+  // rdtsc (0f 31) and rdtscp (0f 01 f9, also sets ecx to IA32_TSC_AUX).
+  unsigned long long length;
+  if ((word & 0xffff) == 0x310f) {
+    length = 2;
+  } else if ((word & 0xffffff) == 0xf9010f) {
+    length = 3;
+    regs.rcx = 0;
+  } else {
+    return false;
+  }
+  time_stamp_counter += kTimeStampCounterIncrement;
+  regs.rax = time_stamp_counter & 0xffffffff;
+  regs.rdx = time_stamp_counter >> 32;
+  regs.rip += length;
+  if (ptrace(PTRACE_SETREGS, elf_pid, 0, &regs) == -1)
+    myfail("PTRACE_SETREGS failed");
+  // The SIGSEGV is not delivered.
+  if (ptrace(PTRACE_SYSCALL, elf_pid, 0, 0) == -1)
+    myfail("PTRACE_SYSCALL failed");
+  return true;
+}
+
 void Program::RunElfProcess() {
   // "Ask for a SIGALRM" to be delivered to the child process. This should cause
   // a termination of the process if e.g. an infinite loop is present.
@@ -412,6 +885,19 @@ void Program::RunElfProcess() {
   const char *const av[] = {"memprogram", NULL};
   const char *const ep[] = {NULL};
 
+  int elf_fd = elf_mem_fd_;
+  if (deterministic_execution_) {
+    // See set_deterministic_execution. The ELF's file descriptor is a part of
+    // the auxiliary vector (AT_EXECFN is /dev/fd/<elf_fd>).
+    if (personality(ADDR_NO_RANDOMIZE) == -1)
+      myfail("personality failed");
+    if (prctl(PR_SET_TSC, PR_TSC_SIGSEGV, 0, 0, 0) == -1)
+      myfail("PR_SET_TSC failed");
+    if (dup2(elf_mem_fd_, kDeterministicElfFd) == -1)
+      myfail("dup2 failed");
+    elf_fd = kDeterministicElfFd;
+  }
+
   // Limit the allowed syscalls for the elf_process to the necessary minimum.
   // The parent process is only intended to run in a sandbox anyway, but let's
   // try to be cautious here as well.
@@ -449,7 +935,10 @@ void Program::RunElfProcess() {
   seccomp_rule_add(ctx, SCMP_ACT_ALLOW, SCMP_SYS(mprotect), 0);
   seccomp_rule_add(ctx, SCMP_ACT_ALLOW, SCMP_SYS(prlimit64), 0);
   seccomp_rule_add(ctx, SCMP_ACT_ALLOW, SCMP_SYS(munmap), 0);
-  seccomp_rule_add(ctx, SCMP_ACT_ALLOW, SCMP_SYS(getrandom), 0);
+  seccomp_rule_add(ctx,
+                   deterministic_execution_ ? SCMP_ACT_ERRNO(ENOSYS)
+                                            : SCMP_ACT_ALLOW,
+                   SCMP_SYS(getrandom), 0);
 
   // The system call below is required for ptrace.
   seccomp_rule_add(ctx, SCMP_ACT_ALLOW, SCMP_SYS(ptrace), 0);
@@ -459,49 +948,17 @@ void Program::RunElfProcess() {
   if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) == -1)
     myfail("PTRACE_TRACEME failed");
 
-  if (fexecve(elf_mem_fd_, (char *const *)av, (char *const *)ep) == -1)
+  if (fexecve(elf_fd, (char *const *)av, (char *const *)ep) == -1)
     myfail("fexecve failed");
 }
 
 void Program::ReadLastResultsAndLastRipOffsetFromElfProcess(
     pid_t elf_pid, unsigned long long rip) {
-  std::string proc_file_name =
-      std::string("/proc/") + std::to_string(elf_pid) + std::string("/stat");
-
-  int proc_pid;
-  std::string proc_comm;
-  char proc_state;
-  unsigned long dummy_ul;
-  unsigned long start_code, end_code, kstkeip, start_data, end_data;
-
-  std::ifstream ifs(proc_file_name);
-  ifs >> proc_pid >> proc_comm >> proc_state;
-  // Skip to start_data.
-  // NOTE: some of the fields are not unsigned, using the unsigned long dummy_ul
-  // variable may not be appropriate.
-  for (int i = 0; i < 22; ++i)
-    ifs >> dummy_ul;
-  ifs >> start_code >> end_code;
-  for (int i = 0; i < 2; ++i)
-    ifs >> dummy_ul;
-  ifs >> kstkeip;
-  for (int i = 0; i < 14; ++i)
-    ifs >> dummy_ul;
-  ifs >> start_data >> end_data;
-
-  if (start_data > end_data)
-    myfail("start_data > end_data");
+  unsigned long start_code, start_data;
+  ReadProcStat(elf_pid, &start_code, &start_data);
 
   last_rip_offset_ = rip - start_code - symbol_data_.main_offset_in_text_;
 
-  // printf("pid: %d, comm: %s, state: %c\n", proc_pid, proc_comm.c_str(),
-  //        proc_state);
-  // printf("proc_comm: %s\n", proc_comm.c_str());
-  // printf("start_data: %ld, end_data %ld, diff: %ld\n", start_data, end_data,
-  //        end_data - start_data);
-  // printf("start_data: %lx, end_data %lx, diff: %lx\n", start_data, end_data,
-  //        end_data - start_data);
-
   struct iovec local[1];
   struct iovec remote[1];
   ssize_t nread;
@@ -524,10 +981,119 @@ void Program::ReadLastResultsAndLastRipOffsetFromElfProcess(
   nread = process_vm_readv(elf_pid, local, 1, remote, 1, 0);
   if (nread != (ssize_t)symbol_data_.results_st_size_)
     myfail("process_vm_readv failed");
+}
+
+void Program::WriteBatchToElfProcess(pid_t elf_pid, const Batch &batch) {
+  unsigned long start_code, start_data;
+  ReadProcStat(elf_pid, &start_code, &start_data);
+
+  int batch_size = batch.num_slots;
+  int batch_slot = 0;
+  size_t inputs_size = batch.num_slots * symbol_data_.inputs_st_size_;
+
+  struct iovec local[3];
+  struct iovec remote[3];
+  local[0].iov_base = &batch_size;
+  local[0].iov_len = sizeof(batch_size);
+  remote[0].iov_base =
+      (void *)(start_data + symbol_data_.batch_size_offset_in_data_);
+  remote[0].iov_len = sizeof(batch_size);
+  local[1].iov_base = &batch_slot;
+  local[1].iov_len = sizeof(batch_slot);
+  remote[1].iov_base =
+      (void *)(start_data + symbol_data_.batch_slot_offset_in_data_);
+  remote[1].iov_len = sizeof(batch_slot);
+  local[2].iov_base = (void *)batch.inputs;
+  local[2].iov_len = inputs_size;
+  remote[2].iov_base =
+      (void *)(start_data + symbol_data_.batch_inputs_offset_in_data_);
+  remote[2].iov_len = inputs_size;
+
+  ssize_t nwritten = process_vm_writev(elf_pid, local, 3, remote, 3, 0);
+  if (nwritten != (ssize_t)(sizeof(batch_size) + sizeof(batch_slot) +
+                            inputs_size))
+    myfail("process_vm_writev failed");
+}
+
+void Program::ReadBatchResultsFromElfProcess(pid_t elf_pid, Batch &batch) {
+  unsigned long start_code, start_data;
+  ReadProcStat(elf_pid, &start_code, &start_data);
+
+  int batch_slot;
+  struct iovec local[1];
+  struct iovec remote[1];
+  local[0].iov_base = &batch_slot;
+  local[0].iov_len = sizeof(batch_slot);
+  remote[0].iov_base =
+      (void *)(start_data + symbol_data_.batch_slot_offset_in_data_);
+  remote[0].iov_len = sizeof(batch_slot);
+  if (process_vm_readv(elf_pid, local, 1, remote, 1, 0) != sizeof(batch_slot))
+    myfail("process_vm_readv failed");
+  // The evolved code may overwrite batch_slot, the progress is then unknown.
+  if (batch_slot < 0 || (size_t)batch_slot > batch.num_slots)
+    return;
+  batch.stopped_slot = batch_slot;
+
+  size_t results_size = batch.stopped_slot * symbol_data_.results_st_size_;
+  batch.results.resize(results_size /
+                       sizeof(decltype(batch.results)::value_type));
+  if (results_size == 0)
+    return;
+  local[0].iov_base = batch.results.data();
+  local[0].iov_len = results_size;
+  remote[0].iov_base =
+      (void *)(start_data + symbol_data_.batch_results_offset_in_data_);
+  remote[0].iov_len = results_size;
+  if (process_vm_readv(elf_pid, local, 1, remote, 1, 0) !=
+      (ssize_t)results_size)
+    myfail("process_vm_readv failed");
+}
 
-  if (track_results_history_) {
-    results_history_.push_back(last_results_);
+bool Program::CheckDeterminism(int executions) {
+  // The state of the last execution is restored after the check.
+  unsigned long long last_syscall = last_syscall_;
+  unsigned long long last_rip_offset = last_rip_offset_;
+  int last_exit_status = last_exit_status_;
+  int last_term_signal = last_term_signal_;
+  int last_stop_signal = last_stop_signal_;
+  std::vector<int> last_results = last_results_;
+  bool track_results_history = track_results_history_;
+  int coverage_executions = coverage_executions_;
+  track_results_history_ = false;
+  coverage_executions_ = 0;
+
+  bool deterministic = true;
+  Execute();
+  unsigned long long first_syscall = last_syscall_;
+  unsigned long long first_rip_offset = last_rip_offset_;
+  int first_exit_status = last_exit_status_;
+  int first_term_signal = last_term_signal_;
+  int first_stop_signal = last_stop_signal_;
+  std::vector<int> first_results = last_results_;
+  for (int i = 1; i < executions && deterministic; ++i) {
+    Execute();
+    // Outside of main (e.g. in libc), the rip offset depends on ASLR.
+    bool rip_in_main = first_rip_offset < elf_code_size() ||
+                       last_rip_offset_ < elf_code_size();
+    deterministic = last_syscall_ == first_syscall &&
+                    (!rip_in_main || last_rip_offset_ == first_rip_offset) &&
+                    last_exit_status_ == first_exit_status &&
+                    last_term_signal_ == first_term_signal &&
+                    last_stop_signal_ == first_stop_signal &&
+                    last_results_ == first_results;
   }
+  if (!deterministic)
+    nondeterministic_ = true;
+
+  last_syscall_ = last_syscall;
+  last_rip_offset_ = last_rip_offset;
+  last_exit_status_ = last_exit_status;
+  last_term_signal_ = last_term_signal;
+  last_stop_signal_ = last_stop_signal;
+  last_results_ = std::move(last_results);
+  track_results_history_ = track_results_history;
+  coverage_executions_ = coverage_executions;
+  return deterministic;
 }
 
 void Program::ClearLastState() {
@@ -540,19 +1106,8 @@ void Program::ClearLastState() {
 }
 
 std::vector<char> Program::GetElfCode() const {
-  if (symbol_data_.main_offset_in_elf_ == (Elf64_Addr)-1)
-    myfail("location to get main unknown");
-
-  off_t offset = lseek(elf_mem_fd_, symbol_data_.main_offset_in_elf_, SEEK_SET);
-  if (offset != (off_t)symbol_data_.main_offset_in_elf_)
-    myfail("get elf code lseek failed");
-
   std::vector<char> elf_code(symbol_data_.main_st_size_);
-  ssize_t nread =
-      read(elf_mem_fd_, elf_code.data(), symbol_data_.main_st_size_);
-  if (nread != (ssize_t)symbol_data_.main_st_size_)
-    myfail("getting elf code failed");
-
+  ReadElfCode(elf_code.data());
   return elf_code;
 }
 
@@ -560,16 +1115,45 @@ void Program::SetElfCode(const std::vector<char> &elf_code) {
   if (elf_code.size() != symbol_data_.main_st_size_)
     myfail("elf code to set has incorrect size");
 
+  WriteElfCode(elf_code.data());
+}
+
+void Program::ReadElfCode(char *elf_code) const {
+  if (symbol_data_.main_offset_in_elf_ == (Elf64_Addr)-1)
+    myfail("location to get main unknown");
+
+  ssize_t nread = pread(elf_mem_fd_, elf_code, symbol_data_.main_st_size_,
+                        symbol_data_.main_offset_in_elf_);
+  if (nread != (ssize_t)symbol_data_.main_st_size_)
+    myfail("reading elf code failed");
+}
+
+void Program::WriteElfCode(const char *elf_code) {
   if (symbol_data_.main_offset_in_elf_ == (Elf64_Addr)-1)
     myfail("location to set main unknown");
 
-  off_t offset = lseek(elf_mem_fd_, symbol_data_.main_offset_in_elf_, SEEK_SET);
-  if (offset != (off_t)symbol_data_.main_offset_in_elf_)
-    myfail("set elf code lseek failed");
+  ssize_t nwritten = pwrite(elf_mem_fd_, elf_code, symbol_data_.main_st_size_,
+                            symbol_data_.main_offset_in_elf_);
+  if (nwritten != (ssize_t)symbol_data_.main_st_size_)
+    myfail("writing elf code failed");
+
+  ClearCoverage();
+  nondeterministic_ = false;
+}
+
+void Program::ReadElfData(char *elf_data) const {
+  if (symbol_data_.data_offset_in_elf_ == (Elf64_Addr)-1)
+    myfail("location to get data unknown");
 
-  ssize_t nwritten = write(elf_mem_fd_, elf_code.data(), elf_code.size());
-  if (nwritten != (off_t)elf_code.size())
-    myfail("setting elf code failed");
+  ssize_t nread = pread(elf_mem_fd_, elf_data, symbol_data_.data_st_size_,
+                        symbol_data_.data_offset_in_elf_);
+  if (nread != (ssize_t)symbol_data_.data_st_size_)
+    myfail("reading elf data failed");
+}
+
+void Program::ClearCoverage() {
+  has_coverage_ = false;
+  coverage_.clear();
 }
 
 void Program::SetElfCodeToAllNops() {
@@ -590,13 +1174,10 @@ std::vector<int> Program::GetElfInputs() const {
   elf_inputs.resize(symbol_data_.inputs_st_size_ /
                     sizeof(decltype(elf_inputs)::value_type));
 
-  off_t offset =
-      lseek(elf_mem_fd_, symbol_data_.inputs_offset_in_elf_, SEEK_SET);
-  if (offset != (off_t)symbol_data_.inputs_offset_in_elf_)
-    myfail("get elf inputs lseek failed");
-
-  ssize_t nread =
-      read(elf_mem_fd_, elf_inputs.data(), symbol_data_.inputs_st_size_);
+  // pread does not move the file offset (see SetElfInputs).
+  ssize_t nread = pread(elf_mem_fd_, elf_inputs.data(),
+                        symbol_data_.inputs_st_size_,
+                        symbol_data_.inputs_offset_in_elf_);
   if (nread != (ssize_t)symbol_data_.inputs_st_size_)
     myfail("getting elf inputs failed");
 
@@ -604,31 +1185,47 @@ std::vector<int> Program::GetElfInputs() const {
 }
 
 void Program::SetElfInputs(const std::vector<int> &elf_inputs) {
+  SetElfInputs(elf_inputs.data(), elf_inputs.size());
+}
+
+void Program::SetElfInputs(const int *elf_inputs, size_t size) {
   if (symbol_data_.inputs_offset_in_elf_ == (Elf64_Addr)-1)
     myfail("location to set inputs unknown");
 
-  auto element_size =
-      sizeof(std::remove_reference_t<decltype(elf_inputs)>::value_type);
+  auto element_size = sizeof(*elf_inputs);
 
   if (symbol_data_.inputs_st_size_ % element_size != 0)
     myfail("inputs_st_size_ mismatch");
 
-  if (elf_inputs.size() * element_size > symbol_data_.inputs_st_size_)
+  if (size * element_size > symbol_data_.inputs_st_size_)
     myfail("elf inputs to set are too large");
 
-  off_t offset =
-      lseek(elf_mem_fd_, symbol_data_.inputs_offset_in_elf_, SEEK_SET);
-  if (offset != (off_t)symbol_data_.inputs_offset_in_elf_)
-    myfail("set elf inputs lseek failed");
-
-  ssize_t nwritten =
-      write(elf_mem_fd_, elf_inputs.data(), elf_inputs.size() * element_size);
-  if (nwritten != (off_t)(elf_inputs.size() * element_size))
+  // pwrite does not move the file offset, i.e. the inputs may be set while
+  // another thread reads the code of the program (e.g. a mutator reading a
+  // parent). The code and the inputs are only accessed via pread and pwrite
+  // after the ELF is parsed.
+  ssize_t nwritten = pwrite(elf_mem_fd_, elf_inputs, size * element_size,
+                            symbol_data_.inputs_offset_in_elf_);
+  if (nwritten != (ssize_t)(size * element_size))
     myfail("setting elf inputs failed");
 }
 
 void Program::ResetCurrentScore() { current_score_ = 0; }
 
+void Program::CopyEvaluationStateFrom(const Program &other) {
+  last_syscall_ = other.last_syscall_;
+  last_rip_offset_ = other.last_rip_offset_;
+  last_exit_status_ = other.last_exit_status_;
+  last_term_signal_ = other.last_term_signal_;
+  last_stop_signal_ = other.last_stop_signal_;
+  last_results_ = other.last_results_;
+  if (track_results_history_)
+    results_history_ = other.results_history_;
+  has_coverage_ = other.has_coverage_;
+  coverage_ = other.coverage_;
+  current_score_ = other.current_score_;
+}
+
 void Program::IncrementCurrentScoreBy(long long increment) {
   current_score_ += increment;
 }
@@ -8,11 +8,16 @@
 
 #include <elf.h>
 #include <fcntl.h>
+#include <stdint.h>
 
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "results_history.h"
+
 namespace viaevo {
 
 // Program reads ELFs and manages their modifications, execution and reading of
@@ -41,18 +46,144 @@ public:
   bool IsInitialized() const;
 
   // Factory method to create Program instances based on one of the //elfs.
+  // Safe to call from multiple threads (e.g. for concurrent evolutions). Each
+  // Program instance should only be used (executed) by one thread at a time.
   static std::shared_ptr<Program> Create(const std::string filename);
 
+  // ManifestEntry holds what Create otherwise computes on the first call for
+  // an ELF: the offsets and sizes of main, inputs, results and the .data
+  // section and the number of ptrace stops before main. The manifest of the
+  // //elfs templates is generated at build time (see //elfs:elf_manifest).
+  struct ManifestEntry {
+    const char *filename;
+    uint64_t main_offset_in_elf;
+    uint64_t main_offset_in_text;
+    uint64_t main_size;
+    uint64_t inputs_offset_in_elf;
+    uint64_t inputs_size;
+    uint64_t results_offset_in_data;
+    uint64_t results_size;
+    uint64_t data_offset_in_elf;
+    uint64_t data_size;
+    int expected_ptrace_stops;
+    // Batch execution symbols (see ExecuteBatch), -1 if the ELF has none.
+    uint64_t batch_size_offset_in_data;
+    uint64_t batch_slot_offset_in_data;
+    uint64_t batch_inputs_offset_in_data;
+    uint64_t batch_inputs_size;
+    uint64_t batch_results_offset_in_data;
+    uint64_t batch_results_size;
+  };
+  // Registers entry so that Create for entry.filename neither parses the ELF
+  // nor executes it to count the ptrace stops. Registering an ELF again or
+  // after it was created has no effect. Thread-safe.
+  static void RegisterManifestEntry(const ManifestEntry &entry);
+  // Returns true and sets entry if a manifest entry for filename is
+  // registered. Thread-safe.
+  static bool FindManifestEntry(const std::string &filename,
+                                ManifestEntry *entry);
+  // Parses the ELF filename and executes it once to create its manifest entry
+  // (with filename set to nullptr). Does not register the entry.
+  static ManifestEntry CreateManifestEntry(const std::string &filename);
+
   // Execute the program and populate last_results_. At most max_ptrace_stops
   // will be allowed for the elf process before the elf process is terminated.
   // If max_ptrace_stops is -1, at most expected_ptrace_stops_ will be allowed.
   // Returns the number of ptrace stops during the process lifetime.
   int Execute(int max_ptrace_stops = -1);
 
-  // Get and set the ELF's evolvable code (main).
+  // Executes the program on num_slots rows of inputs_size ints of
+  // inputs_batch (e.g. the rows of an InputBatch) and sets (*slot_results)[j]
+  // to the results of the execution on row j. The results of each row are the
+  // same as from SetElfInputs for the row followed by Execute, but the ELFs in
+  // //elfs run main for many rows in a single process (see
+  // elfs/batch_harness.h): a process runs main for the rows until a row stops
+  // it (a syscall or signal of the evolved code, e.g. SIGSEGV) and the
+  // remaining rows continue in a new process. The rows that stopped a process
+  // are listed in last_batch_stopped_slots(). The time limit of a process
+  // (SIGALRM) covers all its rows, so a row that runs out of time after other
+  // rows of its process is executed again on its own (with the time limit of a
+  // single execution), as is a row that overwrote the progress of the harness.
+  // ELFs without the batch harness are executed once per row. The results
+  // history is appended once per row in the order of the rows and the last_*
+  // members are set by the last process. The inputs of the ELF are left
+  // unchanged. Returns the number of processes executed.
+  int ExecuteBatch(const int *inputs_batch, size_t inputs_size,
+                   size_t num_slots,
+                   std::vector<std::vector<int>> *slot_results);
+  // Rows that stopped a process during the last ExecuteBatch (excluding the
+  // last row, which always ends the last process).
+  const std::vector<size_t> &last_batch_stopped_slots() const {
+    return last_batch_stopped_slots_;
+  }
+  // True if the ELF has the batch harness (i.e. ExecuteBatch does not execute
+  // the rows one by one).
+  bool HasBatchHarness() const;
+
+  // Deterministic execution pins what otherwise differs between executions of
+  // the same code on the same inputs: the addresses (no ASLR via
+  // personality(ADDR_NO_RANDOMIZE)), the stack and the auxiliary vector (the
+  // ELF is executed from the same file descriptor and the AT_RANDOM bytes are
+  // fixed), the time stamp counter (rdtsc and rdtscp are trapped via PR_SET_TSC
+  // and emulated with a counter starting at 0 for each execution) and
+  // getrandom (denied with ENOSYS). The time limit of an execution is still
+  // measured in real time, i.e. programs running close to the limit may remain
+  // nondeterministic (see CheckDeterminism).
+  void set_deterministic_execution(bool deterministic_execution) {
+    deterministic_execution_ = deterministic_execution;
+  }
+  bool deterministic_execution() const { return deterministic_execution_; }
+
+  // Executes the program executions times on the current inputs and returns
+  // true if all executions ended identically (same results, syscall, signals,
+  // exit status and rip offset if in main, as elsewhere, e.g. in libc, it
+  // depends on ASLR). Otherwise, the program is flagged as nondeterministic
+  // (until its code changes), e.g. so that its results are not reused for
+  // other programs with the same code. The last_* members and the results
+  // history are kept from before the call.
+  bool CheckDeterminism(int executions = 2);
+  // True if CheckDeterminism found the program nondeterministic since its code
+  // last changed.
+  bool nondeterministic() const { return nondeterministic_; }
+
+  // Coverage of the evolvable code (main). The next coverage_executions
+  // executions single-step main and mark the offsets (relative to main) of the
+  // executed instructions in coverage(). Each such execution is much slower
+  // than a regular execution. The trace ends when the execution leaves main or
+  // after kMaxCoverageSteps instructions (the remaining instructions run
+  // untraced). Coverage accumulates over the traced executions and is cleared
+  // when the code changes.
+  void set_coverage_executions(int coverage_executions) {
+    coverage_executions_ = coverage_executions;
+  }
+  int coverage_executions() const { return coverage_executions_; }
+  // True if at least one execution was traced since the code changed.
+  bool has_coverage() const { return has_coverage_; }
+  // Bitmap with one bit per byte of main (bit offset % 8 of byte offset / 8),
+  // empty without coverage.
+  const std::vector<uint8_t> &coverage() const { return coverage_; }
+  bool IsCovered(size_t offset) const {
+    return offset / 8 < coverage_.size() &&
+           (coverage_[offset / 8] >> (offset % 8) & 1);
+  }
+  void ClearCoverage();
+
+  // Get and set the ELF's evolvable code (main). The code and the inputs are
+  // read and written without moving the file offset, i.e. the code and the
+  // inputs of a Program may be accessed concurrently (e.g. a mutator reading a
+  // parent while the parent is executed on a worker thread).
   std::vector<char> GetElfCode() const;
   // Size of elf_code must match the size of the ELF's evolvable code (main).
   void SetElfCode(const std::vector<char> &elf_code);
+  // Read and write the ELF's evolvable code from/to a buffer of
+  // elf_code_size() bytes. Unlike GetElfCode, ReadElfCode does not allocate.
+  void ReadElfCode(char *elf_code) const;
+  void WriteElfCode(const char *elf_code);
+  size_t elf_code_size() const { return symbol_data_.main_st_size_; }
+  // Read the ELF's .data section (including inputs and results) to a buffer of
+  // elf_data_size() bytes.
+  void ReadElfData(char *elf_data) const;
+  size_t elf_data_size() const { return symbol_data_.data_st_size_; }
   // Replace all instruction in ELF's evolvable code (main) with nop
   // instructions.
   void SetElfCodeToAllNops();
@@ -62,6 +193,9 @@ public:
   // Size of elf_inputs must be smaller or equal to the size of the ELF's inputs
   // variable.
   void SetElfInputs(const std::vector<int> &elf_inputs);
+  // Sets the first size ints of the ELF's inputs variable (e.g. a row of an
+  // InputBatch).
+  void SetElfInputs(const int *elf_inputs, size_t size);
 
   // Resets current_score_ to 0. E.g. at the beginning of (multiple) round(s) of
   // evaluation of the program on different inputs.
@@ -70,11 +204,20 @@ public:
   // evaluation of the Program on a single set of inputs.
   void IncrementCurrentScoreBy(long long increment);
 
+  // Copies the state resulting from executions and scoring (last_* members,
+  // results_history_, coverage and current_score_) from other. Used to "fan out" the
+  // evaluation of a program to other programs with identical code and inputs.
+  void CopyEvaluationStateFrom(const Program &other);
+
   // Save the current elf in the memory file referenced by the elf_mem_fd_ file
   // descriptor into filename.
   void SaveElf(const char *filename);
   // Clear results_history_.
   void ClearResultsHistory();
+  // Reserves memory in results_history_ for the results of executions
+  // executions (e.g. the evaluations of a generation), so that tracking the
+  // results history does not allocate memory on every execution.
+  void ReserveResultsHistory(int executions);
 
   long long current_score() { return current_score_; }
   unsigned long long last_syscall() const { return last_syscall_; }
@@ -86,9 +229,7 @@ public:
   int expected_ptrace_stops() const { return expected_ptrace_stops_; }
   bool track_results_history() const { return track_results_history_; };
   void set_track_results_history(bool t) { track_results_history_ = t; };
-  const std::vector<std::vector<int>> &results_history() {
-    return results_history_;
-  };
+  const ResultsHistory &results_history() const { return results_history_; };
 
 private:
   // Copies the ELF from filename to an in memory file referenced by the
@@ -102,16 +243,58 @@ private:
   // Find main() address (and length) and results address and lenght in the ELF.
   void InitializeElfSymbolData();
 
+  // Rows of an ExecuteBatch executed by a single process (defined in
+  // program.cc).
+  struct Batch;
+
   // Monitors the separate ELF process via ptrace stops. Also populates
   // last_results_. The value of max_ptrace_stops is passed from the Execute
   // method and has the same meaning here as there. Returns the number of ptrace
   // stops during the lifetime of the ELF process.
-  int MonitorElfProcess(pid_t elf_pid, int max_ptrace_stops);
+  //
+  // With batch set, the batch is written into the ELF process at the last
+  // ptrace stop before main and the batch results are read at the last ptrace
+  // stop (instead of updating results_history_).
+  int MonitorElfProcess(pid_t elf_pid, int max_ptrace_stops,
+                        Batch *batch = nullptr);
+
+  // State of the coverage tracing of an execution (defined in program.cc).
+  struct CoverageTrace;
+  // Called by MonitorElfProcess for the last ptrace stop before main (with
+  // coverage_executions_ > 0). Places a breakpoint at the beginning of main.
+  void BeginCoverageTrace(pid_t elf_pid, CoverageTrace &trace);
+  // Called by MonitorElfProcess for each ptrace stop while tracing. Returns
+  // true if the stop was caused by the tracing (the breakpoint or a single
+  // step) and the ELF process was resumed, false if the stop should be
+  // handled as usual (tracing ends).
+  bool ContinueCoverageTrace(pid_t elf_pid, int status, CoverageTrace &trace);
+  // Returns the address of main in the ELF process (from /proc/[elf_pid]/maps).
+  unsigned long long ReadMainAddressFromElfProcess(pid_t elf_pid);
+
+  // Called by MonitorElfProcess for the first ptrace stop (after exec) with
+  // deterministic_execution_. Overwrites the AT_RANDOM bytes of the auxiliary
+  // vector (e.g. the seed of the stack protector) with fixed bytes.
+  void PinRandomBytesOfElfProcess(pid_t elf_pid);
+  // Called by MonitorElfProcess for each ptrace stop with
+  // deterministic_execution_. Returns true if the stop was caused by a trapped
+  // rdtsc or rdtscp (SIGSEGV), which is then emulated with time_stamp_counter
+  // and the ELF process resumed, false if the stop should be handled as usual.
+  bool EmulateTimeStampCounter(pid_t elf_pid, int status,
+                               unsigned long long &time_stamp_counter);
+
+  // Forks the ELF process and monitors it (see MonitorElfProcess).
+  int ForkAndMonitorElfProcess(int max_ptrace_stops, Batch *batch);
 
   // Runs the ELF in a new process (created via fork prior to calling this
   // function).
   void RunElfProcess();
 
+  // Writes the batch variables of the batch harness into the ELF process.
+  void WriteBatchToElfProcess(pid_t elf_pid, const Batch &batch);
+  // Reads batch_slot and the results of the completed slots from the ELF
+  // process.
+  void ReadBatchResultsFromElfProcess(pid_t elf_pid, Batch &batch);
+
   // Reads last_results_ from the ELF process. Also updates last_rip_offset_ -
   // as /proc/[elf_pid]/stat is parsed here and also provides codestart address.
   void ReadLastResultsAndLastRipOffsetFromElfProcess(pid_t elf_pid,
@@ -143,6 +326,9 @@ protected:
   // Results from the last completed execution of the program.
   std::vector<int> last_results_;
 
+  // See last_batch_stopped_slots.
+  std::vector<size_t> last_batch_stopped_slots_;
+
   // Results over consecutive executions can be stored in results_history_ (if
   // track_results_history_ is set to true). This is intended for multiple
   // executions of the same program on different inputs. The intention is to
@@ -150,13 +336,29 @@ protected:
   // them apart from programs producing the same result on different input (try
   // to steer away from the "broken clock is right twice a day" phenomenon).
   bool track_results_history_ = false;
-  std::vector<std::vector<int>> results_history_;
+  ResultsHistory results_history_;
+
+  // See set_deterministic_execution and CheckDeterminism. With deterministic
+  // execution, the ELF is executed from kDeterministicElfFd (a duplicate of
+  // elf_mem_fd_) and the emulated time stamp counter advances by
+  // kTimeStampCounterIncrement on each read.
+  bool deterministic_execution_ = false;
+  bool nondeterministic_ = false;
+  static constexpr int kDeterministicElfFd = 1000;
+  static constexpr unsigned long long kTimeStampCounterIncrement = 1000;
+
+  // See set_coverage_executions.
+  static constexpr int kMaxCoverageSteps = 10000;
+  int coverage_executions_ = 0;
+  bool has_coverage_ = false;
+  std::vector<uint8_t> coverage_;
 
   // Current score set by e.g. a Scorer reflects an accumulated performance of
   // the program on recent (sets of) inputs.
   long long current_score_ = 0;
 
-  // ELF symbol table values and sizes for main and results.
+  // ELF symbol table values and sizes for main, inputs, results, the .data
+  // section and the batch variables of the batch harness.
   struct SymbolData {
     Elf64_Addr main_offset_in_elf_ = -1;  // offset from elf beginning
     Elf64_Addr main_offset_in_text_ = -1; // offset from .text beginning
@@ -165,6 +367,14 @@ protected:
     uint64_t inputs_st_size_ = -1;
     Elf64_Addr results_offset_in_data_ = -1;
     uint64_t results_st_size_ = -1;
+    Elf64_Addr data_offset_in_elf_ = -1; // offset from elf beginning
+    uint64_t data_st_size_ = -1;
+    Elf64_Addr batch_size_offset_in_data_ = -1;
+    Elf64_Addr batch_slot_offset_in_data_ = -1;
+    Elf64_Addr batch_inputs_offset_in_data_ = -1;
+    uint64_t batch_inputs_st_size_ = -1;
+    Elf64_Addr batch_results_offset_in_data_ = -1;
+    uint64_t batch_results_st_size_ = -1;
   };
 
   SymbolData symbol_data_;
@@ -182,6 +392,14 @@ protected:
   // Memoize expected ptrace stops for different elfs to avoid computing them
   // for every instance.
   static std::unordered_map<std::string, int> expected_ptrace_stops_map_;
+
+  // Registered manifest entries consulted by Create before parsing an ELF.
+  // Function-local static as entries are registered during static
+  // initialization of other translation units.
+  static std::unordered_map<std::string, ManifestEntry> &manifest_entries();
+
+  // Guards symbol_data_map_, expected_ptrace_stops_map_ and manifest_entries().
+  static std::mutex create_mutex_;
 };
 
 } // namespace viaevo
@@ -719,6 +719,34 @@ TEST(ProgramTest, SaveElfSimpleSmall) {
   EXPECT_EQ(saved_program->GetElfCode(), nops);
 }
 
+TEST(ProgramTest, ManifestEntry) {
+  viaevo::Program::ManifestEntry entry =
+      viaevo::Program::CreateManifestEntry("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> program =
+      viaevo::Program::Create("elfs/simple_small");
+
+  EXPECT_EQ(entry.filename, nullptr);
+  EXPECT_EQ(entry.main_size, program->elf_code_size());
+  EXPECT_EQ(entry.inputs_size,
+            program->GetElfInputs().size() * sizeof(int));
+  EXPECT_EQ(entry.data_size, program->elf_data_size());
+  EXPECT_GT(entry.expected_ptrace_stops, 0);
+
+  // Create for a registered ELF uses the entry instead of parsing the ELF
+  // (the entry is altered to tell the difference).
+  std::string filename = testing::TempDir() + "unit_test_manifest_entry.elf";
+  program->SaveElf(filename.c_str());
+  entry.filename = filename.c_str();
+  entry.inputs_size = sizeof(int);
+  viaevo::Program::RegisterManifestEntry(entry);
+
+  std::shared_ptr<viaevo::Program> registered_program =
+      viaevo::Program::Create(filename);
+  EXPECT_TRUE(registered_program->IsInitialized());
+  EXPECT_EQ(registered_program->GetElfCode(), program->GetElfCode());
+  EXPECT_EQ(registered_program->GetElfInputs().size(), 1);
+}
+
 TEST(ProgramTest, ResultsHistorySimpleSmall) {
   std::shared_ptr<viaevo::Program> program =
       viaevo::Program::Create("elfs/simple_small");
@@ -797,6 +825,85 @@ TEST(ProgramTest, ResultsHistorySimpleSmall) {
       << "Results history should be empty (cleared) after ClearResultsHistory.";
 }
 
+TEST(ProgramTest, CopyEvaluationStateFrom) {
+  std::shared_ptr<viaevo::Program> program =
+      viaevo::Program::Create("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> copy =
+      viaevo::Program::Create("elfs/simple_small");
+
+  program->set_track_results_history(true);
+  copy->set_track_results_history(true);
+
+  program->Execute();
+  program->IncrementCurrentScoreBy(42);
+
+  EXPECT_TRUE(copy->last_results().empty());
+  EXPECT_EQ(copy->results_history().size(), 0);
+
+  copy->CopyEvaluationStateFrom(*program);
+
+  EXPECT_EQ(copy->last_syscall(), program->last_syscall());
+  EXPECT_EQ(copy->last_rip_offset(), program->last_rip_offset());
+  EXPECT_EQ(copy->last_exit_status(), program->last_exit_status());
+  EXPECT_EQ(copy->last_term_signal(), program->last_term_signal());
+  EXPECT_EQ(copy->last_stop_signal(), program->last_stop_signal());
+  EXPECT_EQ(copy->last_results(), program->last_results());
+  EXPECT_EQ(copy->results_history(), program->results_history());
+  EXPECT_EQ(copy->current_score(), 42);
+
+  // Results history is not copied into programs not tracking it.
+  std::shared_ptr<viaevo::Program> copy_without_history =
+      viaevo::Program::Create("elfs/simple_small");
+  copy_without_history->CopyEvaluationStateFrom(*program);
+  EXPECT_EQ(copy_without_history->last_results(), program->last_results());
+  EXPECT_EQ(copy_without_history->results_history().size(), 0);
+}
+
+TEST(ProgramTest, Coverage) {
+  std::shared_ptr<viaevo::Program> program =
+      viaevo::Program::Create("elfs/simple_small");
+
+  // All nops with a jump over 14 bytes at offset 0 and an illegal instruction
+  // at offset 30.
+  std::vector<char> elf_code(program->GetElfCode().size(), '\x90');
+  elf_code[0] = '\xeb';
+  elf_code[1] = '\x0e';
+  elf_code[30] = '\x06';
+  program->SetElfCode(elf_code);
+
+  program->Execute();
+  EXPECT_FALSE(program->has_coverage())
+      << "There should be no coverage without coverage executions";
+  unsigned long long last_syscall = program->last_syscall();
+  int last_stop_signal = program->last_stop_signal();
+  unsigned long long last_rip_offset = program->last_rip_offset();
+
+  program->set_coverage_executions(1);
+  program->Execute();
+  EXPECT_EQ(program->coverage_executions(), 0);
+  ASSERT_TRUE(program->has_coverage());
+  EXPECT_TRUE(program->IsCovered(0));
+  for (int i = 1; i < 16; ++i)
+    EXPECT_FALSE(program->IsCovered(i)) << "Offset " << i << " jumped over";
+  for (int i = 16; i <= 30; ++i)
+    EXPECT_TRUE(program->IsCovered(i)) << "Offset " << i << " executed";
+  for (size_t i = 31; i < elf_code.size(); ++i)
+    EXPECT_FALSE(program->IsCovered(i)) << "Offset " << i << " after SIGILL";
+  EXPECT_EQ(program->last_syscall(), last_syscall)
+      << "Tracing should not change the outcome of the execution";
+  EXPECT_EQ(program->last_stop_signal(), last_stop_signal)
+      << "Tracing should not change the outcome of the execution";
+  EXPECT_EQ(program->last_rip_offset(), last_rip_offset)
+      << "Tracing should not change the outcome of the execution";
+
+  // Coverage is kept by untraced executions and cleared by code changes.
+  program->Execute();
+  EXPECT_TRUE(program->has_coverage());
+  program->SetElfCode(elf_code);
+  EXPECT_FALSE(program->has_coverage());
+  EXPECT_FALSE(program->IsCovered(0));
+}
+
 TEST(ProgramTest, CreateExecuteInfLoop) {
   std::shared_ptr<viaevo::Program> program =
       viaevo::Program::Create("elfs/inf_loop");
@@ -836,4 +943,159 @@ TEST(ProgramTest, CreateExecuteInfLoop) {
       << "Unexpected last results after a 'default' Execute (#1)";
 }
 
+TEST(ProgramTest, ExecuteBatch) {
+  std::shared_ptr<viaevo::Program> program =
+      viaevo::Program::Create("elfs/copy_input");
+  ASSERT_TRUE(program->HasBatchHarness());
+  program->set_track_results_history(true);
+
+  // Rows of 2 ints (the remaining inputs of the ELF are kept).
+  std::vector<int> inputs_batch;
+  for (int slot = 0; slot < 300; ++slot) {
+    inputs_batch.push_back(slot);
+    inputs_batch.push_back(-7);
+  }
+
+  std::vector<std::vector<int>> slot_results;
+  // 300 slots run in 2 processes (of at most 256 slots).
+  EXPECT_EQ(program->ExecuteBatch(inputs_batch.data(), 2, 300, &slot_results),
+            2);
+  EXPECT_TRUE(program->last_batch_stopped_slots().empty());
+  ASSERT_EQ(slot_results.size(), 300);
+  for (int slot = 0; slot < 300; ++slot) {
+    std::vector<int> expected_results{20, slot, 10, 0,  -1, -1,
+                                      -1, -1,   -1, -1, -1};
+    EXPECT_EQ(slot_results[slot], expected_results) << "slot " << slot;
+  }
+  EXPECT_EQ(program->results_history().size(), 300);
+  EXPECT_EQ(program->GetElfInputs()[0], 1)
+      << "ExecuteBatch should not change the inputs of the ELF";
+
+  // Slots 3 and 4 stop their processes (SIGILL), the remaining slots are
+  // resumed in new processes. The results of the stopped slots are read at the
+  // stop as for Execute.
+  inputs_batch[2 * 3] = -1;
+  inputs_batch[2 * 4] = -1;
+  EXPECT_EQ(program->ExecuteBatch(inputs_batch.data(), 2, 6, &slot_results),
+            3);
+  EXPECT_EQ(program->last_batch_stopped_slots(),
+            (std::vector<size_t>{3, 4}));
+  ASSERT_EQ(slot_results.size(), 6);
+  for (int slot : {0, 1, 2, 5})
+    EXPECT_EQ(slot_results[slot][1], slot) << "slot " << slot;
+  for (int slot : {3, 4}) {
+    std::vector<int> expected_results{20, -1, -1, -1, -1, -1,
+                                      -1, -1, -1, -1, -1};
+    EXPECT_EQ(slot_results[slot], expected_results) << "slot " << slot;
+  }
+
+  // Same results as from executions one by one.
+  for (int slot = 0; slot < 6; ++slot) {
+    program->SetElfInputs(inputs_batch.data() + 2 * slot, 2);
+    program->Execute();
+    EXPECT_EQ(program->last_results(), slot_results[slot]) << "slot " << slot;
+  }
+}
+
+TEST(ProgramTest, ExecuteBatchUnknownProgressAndTimeLimit) {
+  std::shared_ptr<viaevo::Program> program =
+      viaevo::Program::Create("elfs/copy_input");
+  program->set_track_results_history(true);
+  std::vector<int> stopped_results{20, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+  // Slot 2 overwrites batch_slot. The progress of its process is unknown, so
+  // the first slot of the process is executed on its own and the remaining
+  // slots continue in a new process (3 times until slot 2 is executed on its
+  // own).
+  std::vector<int> inputs_batch{0, 1, -2, 3};
+  std::vector<std::vector<int>> slot_results;
+  EXPECT_EQ(program->ExecuteBatch(inputs_batch.data(), 1, 4, &slot_results),
+            7);
+  EXPECT_EQ(program->last_batch_stopped_slots(),
+            (std::vector<size_t>{0, 1, 2}));
+  for (int slot : {0, 1, 3})
+    EXPECT_EQ(slot_results[slot][1], slot) << "slot " << slot;
+  EXPECT_EQ(slot_results[2], stopped_results);
+  // A single row of the results history per slot.
+  EXPECT_EQ(program->results_history().size(), 4);
+  EXPECT_EQ(program->GetElfInputs()[0], 1);
+
+  // Slot 2 runs out of time after slots 0 and 1 of its process and is executed
+  // again on its own (with the time limit of a single execution).
+  inputs_batch[2] = -3;
+  EXPECT_EQ(program->ExecuteBatch(inputs_batch.data(), 1, 4, &slot_results),
+            3);
+  EXPECT_EQ(program->last_batch_stopped_slots(), (std::vector<size_t>{2}));
+  EXPECT_EQ(slot_results[2], stopped_results);
+  EXPECT_EQ(program->results_history().size(), 8);
+
+  // Slot 0 runs out of time as the first slot of its process, i.e. as in a
+  // single execution, and is not executed again.
+  inputs_batch[0] = -3;
+  inputs_batch[2] = 2;
+  EXPECT_EQ(program->ExecuteBatch(inputs_batch.data(), 1, 4, &slot_results),
+            2);
+  EXPECT_EQ(program->last_batch_stopped_slots(), (std::vector<size_t>{0}));
+  EXPECT_EQ(slot_results[0], stopped_results);
+  EXPECT_EQ(program->results_history().size(), 12);
+  EXPECT_EQ(program->GetElfInputs()[0], 1);
+}
+
+TEST(ProgramTest, ExecuteBatchWithoutHarness) {
+  std::shared_ptr<viaevo::Program> program =
+      viaevo::Program::Create("elfs/inf_loop");
+  EXPECT_FALSE(program->HasBatchHarness());
+
+  std::vector<int> elf_inputs = program->GetElfInputs();
+  std::vector<int> inputs_batch{1, 2, 3};
+  std::vector<std::vector<int>> slot_results;
+  // Executed once per slot.
+  EXPECT_EQ(program->ExecuteBatch(inputs_batch.data(), 1, 3, &slot_results),
+            3);
+  std::vector<int> default_results{10, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3};
+  for (const std::vector<int> &results : slot_results)
+    EXPECT_EQ(results, default_results);
+  EXPECT_EQ(program->GetElfInputs(), elf_inputs)
+      << "ExecuteBatch should not change the inputs of the ELF";
+}
+
+TEST(ProgramTest, DeterministicExecution) {
+  std::shared_ptr<viaevo::Program> program =
+      viaevo::Program::Create("elfs/simple_small");
+  program->set_deterministic_execution(true);
+  EXPECT_TRUE(program->deterministic_execution());
+
+  // Same ptrace stops as without deterministic execution.
+  EXPECT_EQ(program->Execute(), program->expected_ptrace_stops());
+  EXPECT_EQ(program->last_syscall(), 231);
+  std::vector<int> last_results = program->last_results();
+  EXPECT_TRUE(program->CheckDeterminism());
+  EXPECT_EQ(program->last_results(), last_results)
+      << "CheckDeterminism should keep the state of the last execution";
+
+  // rdtsc; test eax, 0x100; jz . + 4; ud2; ud2 (i.e. SIGILL at offset 9 or 11
+  // after rdtsc depending on the time stamp counter).
+  int rdtsc_position = 16;
+  const char code[] = "\x0f\x31\xa9\x00\x01\x00\x00\x74\x02\x0f\x0b\x0f\x0b";
+  std::vector<char> elf_code(program->elf_code_size(), '\x90');
+  std::copy(code, code + sizeof(code) - 1, elf_code.begin() + rdtsc_position);
+  program->SetElfCode(elf_code);
+
+  // The emulated time stamp counter is 1000 (bit 8 set) for the first read.
+  EXPECT_TRUE(program->CheckDeterminism(20));
+  EXPECT_FALSE(program->nondeterministic());
+  program->Execute();
+  EXPECT_EQ(program->last_stop_signal(), 4);
+  EXPECT_EQ(program->last_rip_offset(), rdtsc_position + 9);
+
+  // Without deterministic execution, 20 executions end identically with a
+  // probability of about 2^-19.
+  program->set_deterministic_execution(false);
+  EXPECT_FALSE(program->CheckDeterminism(20));
+  EXPECT_TRUE(program->nondeterministic());
+  // The flag is cleared when the code changes.
+  program->SetElfCode(elf_code);
+  EXPECT_FALSE(program->nondeterministic());
+}
+
 } // namespace
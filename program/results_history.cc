@@ -0,0 +1,55 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "results_history.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+namespace viaevo {
+
+void ResultsHistory::Reserve(size_t rows, size_t results_size) {
+  values_.reserve(rows * results_size);
+}
+
+void ResultsHistory::Append(const std::vector<int> &results) {
+  if (values_.empty())
+    results_size_ = results.size();
+  assert(results.size() == results_size_ &&
+         "all rows in ResultsHistory should have the same size");
+  values_.insert(values_.end(), results.begin(), results.end());
+}
+
+void ResultsHistory::Clear() { values_.clear(); }
+
+bool ResultsHistory::operator==(const ResultsHistory &other) const {
+  return size() == other.size() && values_ == other.values_;
+}
+
+bool ResultsHistory::operator==(
+    const std::vector<std::vector<int>> &rows) const {
+  if (rows.size() != size())
+    return false;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    if (rows[i].size() != results_size_ ||
+        !std::equal(rows[i].begin(), rows[i].end(), (*this)[i]))
+      return false;
+  }
+  return true;
+}
+
+std::ostream &operator<<(std::ostream &out, const ResultsHistory &history) {
+  out << "{";
+  for (size_t i = 0; i < history.size(); ++i) {
+    out << (i ? ", {" : " {");
+    for (size_t j = 0; j < history.results_size(); ++j)
+      out << (j ? ", " : " ") << history[i][j];
+    out << " }";
+  }
+  return out << " }";
+}
+
+} // namespace viaevo
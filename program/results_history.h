@@ -0,0 +1,56 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_PROGRAM_RESULTS_HISTORY_H_
+#define VIAEVO_PROGRAM_RESULTS_HISTORY_H_
+
+#include <stddef.h>
+
+#include <ostream>
+#include <vector>
+
+namespace viaevo {
+
+// ResultsHistory stores the results of consecutive executions of a Program in
+// a single flat buffer (a row of results_size() elements per execution). Clear
+// keeps the allocated memory, i.e. once the buffer grew to (or was reserved
+// for) the number of executions in a generation, appending results does not
+// allocate.
+class ResultsHistory {
+public:
+  // Reserves memory for rows executions with results of results_size elements.
+  void Reserve(size_t rows, size_t results_size);
+  // Appends a row. All rows should have the same size.
+  void Append(const std::vector<int> &results);
+  // Removes all rows (keeps the allocated memory).
+  void Clear();
+
+  // Number of rows (executions).
+  size_t size() const {
+    return results_size_ ? values_.size() / results_size_ : 0;
+  }
+  bool empty() const { return values_.empty(); }
+  // Number of elements in each row.
+  size_t results_size() const { return results_size_; }
+  // Returns the results of the row-th execution (results_size() elements).
+  const int *operator[](size_t row) const {
+    return values_.data() + row * results_size_;
+  }
+
+  bool operator==(const ResultsHistory &other) const;
+  // Compares with rows stored as separate vectors (e.g. in tests).
+  bool operator==(const std::vector<std::vector<int>> &rows) const;
+
+private:
+  size_t results_size_ = 0;
+  std::vector<int> values_;
+};
+
+// Prints the rows (e.g. for test failure messages).
+std::ostream &operator<<(std::ostream &out, const ResultsHistory &history);
+
+} // namespace viaevo
+
+#endif // VIAEVO_PROGRAM_RESULTS_HISTORY_H_
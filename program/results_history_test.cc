@@ -0,0 +1,60 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "results_history.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(ResultsHistoryTest, AppendClear) {
+  viaevo::ResultsHistory history;
+  EXPECT_TRUE(history.empty());
+  EXPECT_EQ(history.size(), 0);
+  EXPECT_EQ(history, std::vector<std::vector<int>>{});
+
+  history.Reserve(3, 4);
+  EXPECT_EQ(history.size(), 0);
+
+  history.Append({1, 2, 3, 4});
+  history.Append({5, 6, 7, 8});
+  EXPECT_FALSE(history.empty());
+  EXPECT_EQ(history.size(), 2);
+  EXPECT_EQ(history.results_size(), 4);
+  EXPECT_EQ(history[0][0], 1);
+  EXPECT_EQ(history[1][1], 6);
+  EXPECT_EQ(history[1][3], 8);
+  EXPECT_EQ(history,
+            (std::vector<std::vector<int>>{{1, 2, 3, 4}, {5, 6, 7, 8}}));
+  EXPECT_FALSE(history ==
+               (std::vector<std::vector<int>>{{1, 2, 3, 4}, {5, 6, 7, 9}}));
+  EXPECT_FALSE(history == (std::vector<std::vector<int>>{{1, 2, 3, 4}}));
+
+  viaevo::ResultsHistory copy = history;
+  EXPECT_EQ(copy, history);
+
+  // Clear keeps the memory, appending up to the previous size does not
+  // reallocate the rows.
+  const int *row0 = history[0];
+  history.Clear();
+  EXPECT_TRUE(history.empty());
+  EXPECT_EQ(history.size(), 0);
+  EXPECT_FALSE(copy == history);
+  history.Append({9, 10});
+  history.Append({11, 12});
+  EXPECT_EQ(history[0], row0);
+  EXPECT_EQ(history.results_size(), 2);
+  EXPECT_EQ(history, (std::vector<std::vector<int>>{{9, 10}, {11, 12}}));
+}
+
+TEST(ResultsHistoryTest, RowsOfDifferentSize) {
+  viaevo::ResultsHistory history;
+  history.Append({1, 2, 3});
+  EXPECT_DEATH(history.Append({1, 2}), "should have the same size");
+}
+
+} // namespace
@@ -0,0 +1,69 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "template_genome.h"
+
+#include "program.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace viaevo {
+
+constexpr size_t TemplateGenome::kAlignment;
+
+void TemplateGenome::FreeDeleter::operator()(char *p) const { free(p); }
+
+std::unique_ptr<char[], TemplateGenome::FreeDeleter>
+TemplateGenome::AlignedBuffer(size_t size) {
+  // aligned_alloc requires the size to be a multiple of the alignment.
+  size_t rounded = (size / kAlignment + 1) * kAlignment;
+  char *p = static_cast<char *>(aligned_alloc(kAlignment, rounded));
+  assert(p != nullptr && "aligned_alloc failed");
+  memset(p, 0, rounded);
+  return std::unique_ptr<char[], FreeDeleter>(p);
+}
+
+TemplateGenome::TemplateGenome(const std::string &elf_filename,
+                               bool all_nops) {
+  std::shared_ptr<Program> program = Program::Create(elf_filename);
+  if (all_nops) {
+    program->SetElfCodeToAllNops();
+  }
+
+  code_size_ = program->elf_code_size();
+  code_ = AlignedBuffer(code_size_);
+  program->ReadElfCode(code_.get());
+
+  data_size_ = program->elf_data_size();
+  data_ = AlignedBuffer(data_size_);
+  program->ReadElfData(data_.get());
+}
+
+std::shared_ptr<const TemplateGenome>
+TemplateGenome::Get(const std::string &elf_filename, bool all_nops) {
+  static std::mutex registry_mutex;
+  static std::map<std::pair<std::string, bool>,
+                  std::shared_ptr<const TemplateGenome>>
+      registry;
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto key = std::make_pair(elf_filename, all_nops);
+  auto it = registry.find(key);
+  if (it != registry.end())
+    return it->second;
+
+  std::shared_ptr<const TemplateGenome> genome(
+      new TemplateGenome(elf_filename, all_nops));
+  registry.emplace(key, genome);
+  return genome;
+}
+
+} // namespace viaevo
@@ -0,0 +1,57 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_PROGRAM_TEMPLATE_GENOME_H_
+#define VIAEVO_PROGRAM_TEMPLATE_GENOME_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+
+namespace viaevo {
+
+// TemplateGenome is an immutable copy of an ELF's evolvable code (main) and
+// initial .data section. Instances are obtained via Get which reads each ELF
+// only once per process and shares the copy across all callers (mutators,
+// threads and trials). The buffers are aligned to kAlignment bytes and are
+// never modified after loading, so they can be read concurrently without
+// locking.
+class TemplateGenome {
+public:
+  static constexpr size_t kAlignment = 64;
+
+  // Returns the shared template genome for elf_filename. If all_nops is true,
+  // the code is replaced with nops (0x90) as done by
+  // Program::SetElfCodeToAllNops. Thread-safe.
+  static std::shared_ptr<const TemplateGenome>
+  Get(const std::string &elf_filename, bool all_nops = false);
+
+  TemplateGenome(const TemplateGenome &) = delete;
+  TemplateGenome &operator=(const TemplateGenome &) = delete;
+
+  const char *code() const { return code_.get(); }
+  size_t code_size() const { return code_size_; }
+  const char *data() const { return data_.get(); }
+  size_t data_size() const { return data_size_; }
+
+private:
+  TemplateGenome(const std::string &elf_filename, bool all_nops);
+
+  struct FreeDeleter {
+    void operator()(char *p) const;
+  };
+  // Allocates size bytes (at least 1) aligned to kAlignment.
+  static std::unique_ptr<char[], FreeDeleter> AlignedBuffer(size_t size);
+
+  std::unique_ptr<char[], FreeDeleter> code_;
+  size_t code_size_ = 0;
+  std::unique_ptr<char[], FreeDeleter> data_;
+  size_t data_size_ = 0;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_PROGRAM_TEMPLATE_GENOME_H_
@@ -0,0 +1,62 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "template_genome.h"
+
+#include "program.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(TemplateGenomeTest, MatchesProgram) {
+  std::shared_ptr<const viaevo::TemplateGenome> genome =
+      viaevo::TemplateGenome::Get("elfs/simple_small");
+  std::shared_ptr<viaevo::Program> program =
+      viaevo::Program::Create("elfs/simple_small");
+
+  std::vector<char> code = program->GetElfCode();
+  ASSERT_EQ(genome->code_size(), code.size());
+  EXPECT_EQ(std::vector<char>(genome->code(),
+                              genome->code() + genome->code_size()),
+            code);
+
+  std::vector<char> data(program->elf_data_size());
+  program->ReadElfData(data.data());
+  ASSERT_EQ(genome->data_size(), data.size());
+  EXPECT_GT(genome->data_size(), 0);
+  EXPECT_EQ(std::vector<char>(genome->data(),
+                              genome->data() + genome->data_size()),
+            data);
+
+  EXPECT_EQ((uintptr_t)genome->code() % viaevo::TemplateGenome::kAlignment, 0);
+  EXPECT_EQ((uintptr_t)genome->data() % viaevo::TemplateGenome::kAlignment, 0);
+}
+
+TEST(TemplateGenomeTest, Shared) {
+  auto genome1 = viaevo::TemplateGenome::Get("elfs/simple_small");
+  auto genome2 = viaevo::TemplateGenome::Get("elfs/simple_small");
+  auto genome3 = viaevo::TemplateGenome::Get("elfs/intermediate_small");
+  auto genome4 = viaevo::TemplateGenome::Get("elfs/simple_small", true);
+
+  EXPECT_EQ(genome1, genome2);
+  EXPECT_NE(genome1, genome3);
+  EXPECT_NE(genome1, genome4);
+}
+
+TEST(TemplateGenomeTest, AllNops) {
+  auto genome = viaevo::TemplateGenome::Get("elfs/simple_small", true);
+
+  EXPECT_GT(genome->code_size(), 0);
+  EXPECT_TRUE(std::all_of(genome->code(), genome->code() + genome->code_size(),
+                          [](char value) { return value == '\x90'; }));
+}
+
+} // namespace
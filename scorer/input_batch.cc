@@ -0,0 +1,36 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "input_batch.h"
+
+#include <assert.h>
+
+#include <utility>
+
+namespace viaevo {
+
+void InputBatch::Reserve(size_t num_evaluations) {
+  input_sets_.reserve(num_evaluations);
+}
+
+void InputBatch::Append(std::shared_ptr<const InputSet> input_set) {
+  if (input_sets_.empty()) {
+    inputs_size_ = input_set->inputs_size();
+    expected_size_ = input_set->expected_values.size();
+    inputs_.reserve(input_sets_.capacity() * inputs_size_);
+    expected_values_.reserve(input_sets_.capacity() * expected_size_);
+  }
+  assert(input_set->inputs_size() == inputs_size_ &&
+         input_set->expected_values.size() == expected_size_ &&
+         "all InputSets in InputBatch should have the same sizes");
+  inputs_.insert(inputs_.end(), input_set->inputs_data(),
+                 input_set->inputs_data() + inputs_size_);
+  expected_values_.insert(expected_values_.end(),
+                          input_set->expected_values.begin(),
+                          input_set->expected_values.end());
+  input_sets_.push_back(std::move(input_set));
+}
+
+} // namespace viaevo
@@ -0,0 +1,63 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_SCORER_INPUT_BATCH_H_
+#define VIAEVO_SCORER_INPUT_BATCH_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "input_set.h"
+
+namespace viaevo {
+
+// InputBatch holds the InputSets of all evaluations of a generation, produced
+// up front (see InputSource::NextInputBatch). Besides the InputSets (for
+// scoring), the inputs and the expected values are packed into contiguous
+// row-major matrices with a row per evaluation, so that an execution backend
+// can iterate the evaluations in any order (or pass many inputs to a single
+// execution). All InputSets of a batch should have the same sizes of inputs and
+// of expected values.
+class InputBatch {
+public:
+  // Reserves memory for num_evaluations InputSets.
+  void Reserve(size_t num_evaluations);
+  // Appends the InputSet of the next evaluation.
+  void Append(std::shared_ptr<const InputSet> input_set);
+
+  // Number of evaluations.
+  size_t size() const { return input_sets_.size(); }
+  bool empty() const { return input_sets_.empty(); }
+  // InputSet of the evaluation.
+  const std::shared_ptr<const InputSet> &input_set(size_t evaluation) const {
+    return input_sets_[evaluation];
+  }
+
+  // Number of ints of inputs in each row.
+  size_t inputs_size() const { return inputs_size_; }
+  // Inputs of the evaluation (inputs_size() ints).
+  const int *inputs(size_t evaluation) const {
+    return inputs_.data() + evaluation * inputs_size_;
+  }
+  // Number of expected values in each row.
+  size_t expected_size() const { return expected_size_; }
+  // Expected values of the evaluation (expected_size() ints).
+  const int *expected_values(size_t evaluation) const {
+    return expected_values_.data() + evaluation * expected_size_;
+  }
+
+private:
+  std::vector<std::shared_ptr<const InputSet>> input_sets_;
+  size_t inputs_size_ = 0;
+  std::vector<int> inputs_;
+  size_t expected_size_ = 0;
+  std::vector<int> expected_values_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_SCORER_INPUT_BATCH_H_
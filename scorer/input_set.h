@@ -0,0 +1,47 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_SCORER_INPUT_SET_H_
+#define VIAEVO_SCORER_INPUT_SET_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+namespace viaevo {
+
+// InputSet holds the inputs for one evaluation of Programs together with the
+// values a Scorer expects in the results for these inputs. InputSets are
+// produced by an InputSource and are not modified afterwards (they are shared
+// as std::shared_ptr<const InputSet>).
+struct InputSet {
+  // Consecutive number assigned by the InputSource (starting at 0).
+  long long number = 0;
+  // Inputs for Programs (see Program::SetElfInputs).
+  std::vector<int> inputs;
+  // Alternatively to inputs (which is empty then), inputs_view_size ints at
+  // inputs_view in memory kept alive by inputs_owner, e.g. a sample of a data
+  // set shared by the InputSets (see MnistDataset), so that the inputs are not
+  // copied for each InputSet.
+  const int *inputs_view = nullptr;
+  size_t inputs_view_size = 0;
+  std::shared_ptr<const void> inputs_owner;
+  // Values expected in the results (e.g. the value expected in results[1]).
+  // The meaning is specific to the Scorer.
+  std::vector<int> expected_values;
+
+  // The inputs (of either kind).
+  const int *inputs_data() const {
+    return inputs_view != nullptr ? inputs_view : inputs.data();
+  }
+  size_t inputs_size() const {
+    return inputs_view != nullptr ? inputs_view_size : inputs.size();
+  }
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_SCORER_INPUT_SET_H_
@@ -0,0 +1,53 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_SCORER_INPUT_SOURCE_H_
+#define VIAEVO_SCORER_INPUT_SOURCE_H_
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "input_batch.h"
+#include "input_set.h"
+
+namespace viaevo {
+
+// InputSource is an abstract base class for producers of numbered InputSets
+// (e.g. random values or samples from a dataset). InputSource is stateful and
+// is intended to be used by a single thread, the produced InputSets are
+// immutable and may be shared between threads.
+class InputSource {
+public:
+  virtual ~InputSource() = default;
+
+  // Returns the next InputSet (numbered consecutively from 0).
+  std::shared_ptr<const InputSet> NextInputSet() {
+    std::shared_ptr<InputSet> input_set = std::make_shared<InputSet>();
+    input_set->number = next_number_++;
+    GenerateInputSet(*input_set);
+    return input_set;
+  }
+  // Returns the InputSets for num_evaluations evaluations at once (the same
+  // InputSets as from num_evaluations calls of NextInputSet).
+  std::shared_ptr<const InputBatch> NextInputBatch(size_t num_evaluations) {
+    std::shared_ptr<InputBatch> input_batch = std::make_shared<InputBatch>();
+    input_batch->Reserve(num_evaluations);
+    for (size_t i = 0; i < num_evaluations; ++i)
+      input_batch->Append(NextInputSet());
+    return input_batch;
+  }
+
+protected:
+  // Fills inputs and expected_values of input_set.
+  virtual void GenerateInputSet(InputSet &input_set) = 0;
+
+private:
+  long long next_number_ = 0;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_SCORER_INPUT_SOURCE_H_
@@ -0,0 +1,62 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "input_source.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Produces inputs {number * 10} expecting {number * 20}.
+class InputSourceCounting : public viaevo::InputSource {
+protected:
+  void GenerateInputSet(viaevo::InputSet &input_set) override {
+    input_set.inputs = {(int)input_set.number * 10};
+    input_set.expected_values = {(int)input_set.number * 20};
+  }
+};
+
+TEST(InputSourceTest, NextInputSet) {
+  InputSourceCounting source;
+  std::shared_ptr<const viaevo::InputSet> first = source.NextInputSet();
+  std::shared_ptr<const viaevo::InputSet> second = source.NextInputSet();
+  std::shared_ptr<const viaevo::InputSet> third = source.NextInputSet();
+
+  EXPECT_EQ(first->number, 0);
+  EXPECT_EQ(second->number, 1);
+  EXPECT_EQ(third->number, 2);
+
+  // Previously produced input sets are not affected by the next ones.
+  EXPECT_EQ(first->inputs, std::vector<int>{0});
+  EXPECT_EQ(second->inputs, std::vector<int>{10});
+  EXPECT_EQ(second->expected_values, std::vector<int>{20});
+  EXPECT_EQ(third->inputs, std::vector<int>{20});
+  EXPECT_EQ(third->expected_values, std::vector<int>{40});
+}
+
+TEST(InputSourceTest, NextInputBatch) {
+  InputSourceCounting source;
+  source.NextInputSet();
+  std::shared_ptr<const viaevo::InputBatch> batch = source.NextInputBatch(3);
+
+  ASSERT_EQ(batch->size(), 3);
+  EXPECT_EQ(batch->inputs_size(), 1);
+  EXPECT_EQ(batch->expected_size(), 1);
+  for (int i = 0; i < 3; ++i) {
+    // The batch continues the numbering of the input sets.
+    EXPECT_EQ(batch->input_set(i)->number, i + 1);
+    EXPECT_EQ(batch->input_set(i)->inputs, std::vector<int>{(i + 1) * 10});
+    // The contiguous rows match the input sets.
+    EXPECT_EQ(batch->inputs(i)[0], (i + 1) * 10);
+    EXPECT_EQ(batch->expected_values(i)[0], (i + 1) * 20);
+  }
+  // Rows are contiguous.
+  EXPECT_EQ(batch->inputs(2), batch->inputs(0) + 2);
+
+  EXPECT_EQ(source.NextInputSet()->number, 4);
+  EXPECT_TRUE(source.NextInputBatch(0)->empty());
+}
+
+} // namespace
@@ -0,0 +1,41 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_SCORER_SCORE_KERNELS_H_
+#define VIAEVO_SCORER_SCORE_KERNELS_H_
+
+#include <stddef.h>
+
+namespace viaevo {
+
+// Building blocks for scoring results (see Scorer::ScoreBatch). The loops are
+// branch-free so that the compiler can vectorize them (compares and
+// reductions over whole vector registers).
+
+// Returns the number of bits of value equal to the corresponding bits of
+// expected (0-32).
+inline int MatchingBits(int value, int expected) {
+  return __builtin_popcount(~(unsigned int)(value ^ expected));
+}
+
+// Returns true if any of values[0..size) equals value.
+inline bool AnyEquals(const int *values, size_t size, int value) {
+  int any = 0;
+  for (size_t i = 0; i < size; ++i)
+    any |= values[i] == value;
+  return any != 0;
+}
+
+// Returns the number of values[0..size) different from value.
+inline int CountNotEqual(const int *values, size_t size, int value) {
+  int count = 0;
+  for (size_t i = 0; i < size; ++i)
+    count += values[i] != value;
+  return count;
+}
+
+} // namespace viaevo
+
+#endif // VIAEVO_SCORER_SCORE_KERNELS_H_
@@ -0,0 +1,38 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "score_kernels.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(ScoreKernelsTest, MatchingBits) {
+  EXPECT_EQ(viaevo::MatchingBits(42, 42), 32);
+  EXPECT_EQ(viaevo::MatchingBits(0, -1), 0);
+  EXPECT_EQ(viaevo::MatchingBits(-1, 0), 0);
+  EXPECT_EQ(viaevo::MatchingBits(0b1010, 0b0110), 30);
+  EXPECT_EQ(viaevo::MatchingBits(-1, 0x7fffffff), 31);
+}
+
+TEST(ScoreKernelsTest, AnyEquals) {
+  std::vector<int> values{20, -1, -1, 3, 42, -1, 7, -1, -1, -1, 5};
+  EXPECT_TRUE(viaevo::AnyEquals(values.data(), values.size(), 42));
+  EXPECT_TRUE(viaevo::AnyEquals(values.data(), values.size(), 5));
+  EXPECT_FALSE(viaevo::AnyEquals(values.data(), values.size(), 43));
+  EXPECT_FALSE(viaevo::AnyEquals(values.data(), 4, 42));
+  EXPECT_FALSE(viaevo::AnyEquals(values.data(), 0, 20));
+}
+
+TEST(ScoreKernelsTest, CountNotEqual) {
+  std::vector<int> values{20, -1, -1, 3, 42, -1, 7, -1, -1, -1, 5};
+  EXPECT_EQ(viaevo::CountNotEqual(values.data(), values.size(), -1), 5);
+  EXPECT_EQ(viaevo::CountNotEqual(values.data() + 2, 9, -1), 4);
+  EXPECT_EQ(viaevo::CountNotEqual(values.data(), 0, -1), 0);
+}
+
+} // namespace
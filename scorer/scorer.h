@@ -6,42 +6,78 @@
 #ifndef VIAEVO_SCORER_SCORER_H_
 #define VIAEVO_SCORER_SCORER_H_
 
+#include <stddef.h>
+
+#include <memory>
 #include <vector>
 
+#include "input_set.h"
+#include "input_source.h"
+
 #include "../program/program.h"
 namespace viaevo {
 
 // Scorer is an abstract base class defining the interface to provide inputs and
 // score results for a Program. Scorer is intended to be subclassed for specific
 // applications (see examples in //examples).
-class Scorer {
+//
+// Inputs are provided as numbered InputSets via the InputSource interface
+// (NextInputSet, used by a single thread). The scoring member functions are
+// const and depend only on their arguments (the results and the InputSet the
+// results were computed for), i.e. they may be called concurrently from
+// multiple threads.
+class Scorer : public InputSource {
 public:
   virtual ~Scorer() = default;
-  // Returns score for a specific Program.
-  virtual long long Score(const Program &program) const = 0;
+  // Returns score for results[0..results_size) of a Program executed on
+  // input_set's inputs.
+  virtual long long ScoreResults(const int *results, size_t results_size,
+                                 const InputSet &input_set) const = 0;
+  // Scores the results of num_programs Programs executed on input_set's inputs
+  // at once. results is a contiguous row-major matrix (num_programs rows of
+  // results_size elements, i.e. one last_results per row) and scores[i]
+  // receives the score of row i (the same score as returned by ScoreResults).
+  virtual void ScoreBatch(const int *results, size_t num_programs,
+                          size_t results_size, const InputSet &input_set,
+                          long long *scores) const {
+    for (size_t i = 0; i < num_programs; ++i)
+      scores[i] = ScoreResults(results + i * results_size, results_size,
+                               input_set);
+  }
   // Optional additional scoring based on Program's results_history_ enables
   // e.g. "rewarding" Programs that compute different results on different
   // inputs for the same code.
-  virtual long long
-  ScoreResultsHistory(const std::vector<std::vector<int>> &) const {
+  virtual long long ScoreResultsHistory(const ResultsHistory &) const {
     return 0;
   }
   // Returns maximum possible score for "perfect" results. Should not depend on
-  // current_inputs_.
+  // the inputs.
   virtual long long MaxScore() const = 0;
   // Returns maximum possible score for "perfect" results history.
   virtual long long MaxScoreResultsHistory() const { return 0; }
 
-  // Generates new current_inputs_ for a new round of evaluation of Programs.
-  virtual void ResetInputs() = 0;
-
-  const std::vector<int> &current_inputs() { return current_inputs_; };
+  // Sequential interface (e.g. for validation tools): ResetInputs replaces the
+  // current InputSet with the next one and Score scores a Program executed on
+  // current_inputs.
+  void ResetInputs() { current_input_set_ = NextInputSet(); }
+  long long Score(const Program &program) const {
+    const std::vector<int> &results = program.last_results();
+    return ScoreResults(results.data(), results.size(), *current_input_set_);
+  }
+  // Returns a copy of the current inputs (see InputSet::inputs_data).
+  std::vector<int> current_inputs() const {
+    const InputSet &input_set = *current_input_set_;
+    return std::vector<int>(input_set.inputs_data(),
+                            input_set.inputs_data() + input_set.inputs_size());
+  };
+  const InputSet &current_input_set() const { return *current_input_set_; }
 
 protected:
-  // Inputs for Programs for the current iteration of evaluation.
-  std::vector<int> current_inputs_;
+  // InputSet for the current iteration of evaluation (see ResetInputs).
+  std::shared_ptr<const InputSet> current_input_set_ =
+      std::make_shared<InputSet>();
 };
 
 } // namespace viaevo
 
-#endif // VIAEVO_SCORER_SCORER_H_
\ No newline at end of file
+#endif // VIAEVO_SCORER_SCORER_H_
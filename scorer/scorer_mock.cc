@@ -11,39 +11,42 @@
 namespace viaevo {
 
 ScorerMock::ScorerMock(std::vector<long long> scores, long long max_score,
-                       std::vector<int> current_inputs)
-    : scores_(scores), max_score_(max_score), results_history_scores_({0}) {
-  current_inputs_ = current_inputs;
+                       std::vector<int> inputs)
+    : scores_(scores), max_score_(max_score), results_history_scores_({0}),
+      inputs_(inputs) {
   assert(max_score_ >= *std::max_element(scores_.begin(), scores_.end()) &&
          "max_score_ should not be smaller than any element in scores_");
+  ResetInputs();
 }
 
 ScorerMock::ScorerMock(std::vector<long long> scores, long long max_score,
-                       std::vector<int> current_inputs,
+                       std::vector<int> inputs,
                        std::vector<long long> results_history_scores)
     : scores_(scores), max_score_(max_score),
-      results_history_scores_(results_history_scores) {
-  current_inputs_ = current_inputs;
+      results_history_scores_(results_history_scores), inputs_(inputs) {
   assert(max_score_ >= *std::max_element(scores_.begin(), scores_.end()) +
                            *std::max_element(results_history_scores_.begin(),
                                              results_history_scores_.end()) &&
          "max_score_ should not be smaller than max element in scores_ + plus "
          "max element in results_history_scores_");
+  ResetInputs();
 }
 
-long long ScorerMock::Score(const Program &program) const {
-  current_scores_index_ = (current_scores_index_ + 1) % scores_.size();
-  return scores_[current_scores_index_];
-};
+long long ScorerMock::ScoreResults(const int *results, size_t results_size,
+                                   const InputSet &input_set) const {
+  return scores_[scores_calls_++ % scores_.size()];
+}
 
 long long ScorerMock::ScoreResultsHistory(
-    const std::vector<std::vector<int>> &results_history) const {
-  current_results_history_scores_index_ =
-      (current_results_history_scores_index_ + 1) %
-      results_history_scores_.size();
-  return results_history_scores_[current_results_history_scores_index_];
+    const ResultsHistory &results_history) const {
+  return results_history_scores_[results_history_scores_calls_++ %
+                                 results_history_scores_.size()];
 }
 
-long long ScorerMock::MaxScore() const { return max_score_; };
+long long ScorerMock::MaxScore() const { return max_score_; }
+
+void ScorerMock::GenerateInputSet(InputSet &input_set) {
+  input_set.inputs = inputs_;
+}
 
 } // namespace viaevo
@@ -6,37 +6,47 @@
 #ifndef VIAEVO_SCORER_SCORER_MOCK_H_
 #define VIAEVO_SCORER_SCORER_MOCK_H_
 
+#include <atomic>
+#include <vector>
+
 #include "scorer.h"
 
 namespace viaevo {
 
 // ScorerMock is intended to be used for unit tests. The scorer will assign
-// predefined scores and return a predefined max score.
+// predefined scores (in the order of the calls, also when called from multiple
+// threads) and return a predefined max score. All input sets have the
+// predefined inputs.
 class ScorerMock : public Scorer {
 public:
   ScorerMock(std::vector<long long> scores, long long max_score,
-             std::vector<int> current_inputs);
+             std::vector<int> inputs);
   ScorerMock(std::vector<long long> scores, long long max_score,
-             std::vector<int> current_inputs,
+             std::vector<int> inputs,
              std::vector<long long> results_history_scores);
-  // Returns score for specific results.
-  virtual long long Score(const Program &program) const override;
-  // Returns score for specific results history.
-  virtual long long ScoreResultsHistory(const std::vector<std::vector<int>> &results_history) const override;
+  // Returns the next predefined score (the results are disregarded).
+  virtual long long ScoreResults(const int *results, size_t results_size,
+                                 const InputSet &input_set) const override;
+  // Returns the next predefined results history score.
+  virtual long long
+  ScoreResultsHistory(const ResultsHistory &results_history) const override;
   // Returns predefined max_score_.
   virtual long long MaxScore() const override;
-  // Does nothing.
-  virtual void ResetInputs() override{};
 
 protected:
+  // Sets the predefined inputs.
+  virtual void GenerateInputSet(InputSet &input_set) override;
+
   // Predefined scores to be assigned in a circular fashion.
   std::vector<long long> scores_;
-  mutable int current_scores_index_ = -1;
+  mutable std::atomic<long long> scores_calls_{0};
   // Maximum score to be returned by MaxScore member function.
   long long max_score_;
   // Predefined scores for results history to be assigned in circular fashion.
   std::vector<long long> results_history_scores_;
-  mutable int current_results_history_scores_index_ = -1;
+  mutable std::atomic<long long> results_history_scores_calls_{0};
+  // Inputs in each input set.
+  std::vector<int> inputs_;
 };
 
 } // namespace viaevo
@@ -33,6 +33,33 @@ TEST(ScorerMockTest, Score) {
                "max_score_ should not be smaller");
 }
 
+TEST(ScorerMockTest, ScoreBatch) {
+  viaevo::ScorerMock scorer({7, 17, 0, 5}, 23, {1});
+
+  viaevo::Program program;
+  EXPECT_EQ(scorer.Score(program), 7);
+
+  // Continues with the next predefined score.
+  std::vector<int> results(3 * 2);
+  std::vector<long long> scores(3);
+  scorer.ScoreBatch(results.data(), 3, 2, scorer.current_input_set(),
+                    scores.data());
+  EXPECT_EQ(scores, (std::vector<long long>{17, 0, 5}));
+  EXPECT_EQ(scorer.Score(program), 7);
+}
+
+TEST(ScorerMockTest, InputSets) {
+  viaevo::ScorerMock scorer({1}, 23, {4, 2});
+  EXPECT_EQ(scorer.current_input_set().number, 0);
+  EXPECT_EQ(scorer.current_inputs(), (std::vector<int>{4, 2}));
+
+  std::shared_ptr<const viaevo::InputSet> input_set = scorer.NextInputSet();
+  EXPECT_EQ(input_set->number, 1);
+  EXPECT_EQ(input_set->inputs, (std::vector<int>{4, 2}));
+  scorer.ResetInputs();
+  EXPECT_EQ(scorer.current_input_set().number, 2);
+}
+
 TEST(ScorerMockTest, ScoreResultsHistory) {
   viaevo::ScorerMock scorer({1}, 23, {91}, {7, 17, 0, 5});
 
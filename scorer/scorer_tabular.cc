@@ -0,0 +1,98 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "scorer_tabular.h"
+
+#include "score_kernels.h"
+
+namespace viaevo {
+
+ScorerTabular::ScorerTabular(Random &gen, const std::string &filename,
+                             size_t block_rows, bool release_blocks)
+    : dataset_(TabularDataset::Load(filename)),
+      shuffler_(gen, dataset_->num_rows(), block_rows),
+      release_blocks_(release_blocks) {
+  ResetInputs();
+}
+
+long long ScorerTabular::ScoreResults(const int *results, size_t results_size,
+                                      const InputSet &input_set) const {
+  long long score = 0;
+  for (size_t i = 0; i < input_set.expected_values.size(); ++i)
+    score += ScoreValue(results, results_size, i, input_set.expected_values[i]);
+  return score;
+}
+
+long long ScorerTabular::ScoreValue(const int *results, size_t results_size,
+                                    size_t index, int expected) const {
+  // results[0] is disregarded as it is changed in main of the template elfs.
+  bool has_value = 1 + index < results_size;
+  int value = has_value ? results[1 + index] : 0;
+
+  switch (dataset_->scoring_mode()) {
+  case TabularDataset::kBitMatch: {
+    // The same scoring as e.g. ScorerSumTwo: +60 for the expected value in any
+    // of the results, +20 for the expected value in its place and +1 for each
+    // correctly set bit in its place.
+    long long score = AnyEquals(results, results_size, expected) ? 60 : 0;
+    if (has_value)
+      score += (value == expected ? 20 : 0) + MatchingBits(value, expected);
+    return score;
+  }
+  case TabularDataset::kExactMatch:
+    // +1 for the expected value in any of the results as a hint towards the
+    // exact match.
+    if (has_value && value == expected)
+      return 1'000;
+    return AnyEquals(results, results_size, expected) ? 1 : 0;
+  case TabularDataset::kRangeReward:
+    // "Reward" a value in the valid range (e.g. any class) similarly to
+    // ScorerMnistDigits.
+    if (has_value && value == expected)
+      return 1'000'000;
+    if (has_value && value >= dataset_->range_min() &&
+        value <= dataset_->range_max())
+      return 1'000;
+    return 0;
+  }
+  return 0;
+}
+
+long long ScorerTabular::MaxScore() const {
+  long long max_value_score = 0;
+  switch (dataset_->scoring_mode()) {
+  case TabularDataset::kBitMatch:
+    max_value_score = 112;
+    break;
+  case TabularDataset::kExactMatch:
+    max_value_score = 1'000;
+    break;
+  case TabularDataset::kRangeReward:
+    max_value_score = 1'000'000;
+    break;
+  }
+  return max_value_score * dataset_->expected_size();
+}
+
+void ScorerTabular::GenerateInputSet(InputSet &input_set) {
+  size_t row = shuffler_.Next();
+  if (shuffler_.entered_block()) {
+    if (release_blocks_ && previous_block_size_ > 0 &&
+        previous_block_begin_ != shuffler_.block_begin())
+      dataset_->DontNeed(previous_block_begin_, previous_block_size_);
+    dataset_->WillNeed(shuffler_.next_block_begin(),
+                       shuffler_.next_block_size());
+    previous_block_begin_ = shuffler_.block_begin();
+    previous_block_size_ = shuffler_.block_size();
+  }
+
+  const int *inputs = dataset_->inputs(row);
+  input_set.inputs.assign(inputs, inputs + dataset_->inputs_size());
+  const int *expected = dataset_->expected(row);
+  input_set.expected_values.assign(expected,
+                                   expected + dataset_->expected_size());
+}
+
+} // namespace viaevo
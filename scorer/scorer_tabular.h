@@ -0,0 +1,66 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_SCORER_SCORER_TABULAR_H_
+#define VIAEVO_SCORER_SCORER_TABULAR_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+
+#include "scorer.h"
+#include "tabular_dataset.h"
+
+// TODO: Remove relative path.
+#include "../util/block_shuffler.h"
+#include "../util/random.h"
+
+namespace viaevo {
+
+// ScorerTabular provides the inputs and scores the results of a task defined by
+// a tabular data set file (see TabularDataset) instead of a dedicated Scorer
+// subclass. Each InputSet is a row of the data set: the expected values are
+// expected in results[1], results[2], ... and scored according to the data
+// set's scoring mode.
+//
+// The rows are drawn in shuffled blocks of consecutive rows (see BlockShuffler)
+// so that only a few blocks of the memory-mapped file are accessed at a time.
+// The next block is prefetched when a block is entered and, with
+// release_blocks, the pages of the previous block are dropped (for data sets
+// larger than memory).
+class ScorerTabular : public Scorer {
+public:
+  ScorerTabular(Random &gen, const std::string &filename,
+                size_t block_rows = 4096, bool release_blocks = false);
+  // Returns score for results of a Program executed on input_set's inputs.
+  virtual long long ScoreResults(const int *results, size_t results_size,
+                                 const InputSet &input_set) const override;
+  // Returns maximum possible score for "perfect" results (depends on the
+  // scoring mode and the number of expected values).
+  virtual long long MaxScore() const override;
+
+  const TabularDataset &dataset() const { return *dataset_; }
+
+protected:
+  // Sets the inputs and the expected values to the next row.
+  virtual void GenerateInputSet(InputSet &input_set) override;
+
+  // Score of value in results[1 + index] for the expected value (results are
+  // the whole results of the Program).
+  long long ScoreValue(const int *results, size_t results_size, size_t index,
+                       int expected) const;
+
+  std::shared_ptr<const TabularDataset> dataset_;
+  BlockShuffler shuffler_;
+  bool release_blocks_ = false;
+  // Block of the previous row (released with release_blocks when left).
+  size_t previous_block_begin_ = 0;
+  size_t previous_block_size_ = 0;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_SCORER_SCORER_TABULAR_H_
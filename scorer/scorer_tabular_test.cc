@@ -0,0 +1,138 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "scorer_tabular.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Writes a data set with num_rows rows of inputs {i, -i} and expected values
+// {2 * i, 3 * i} and returns its filename.
+std::string WriteDataset(const std::string &name,
+                         viaevo::TabularDataset::ScoringMode scoring_mode,
+                         int num_rows) {
+  std::string filename = testing::TempDir() + name;
+  std::vector<int> inputs, expected;
+  for (int i = 0; i < num_rows; ++i) {
+    inputs.insert(inputs.end(), {i, -i});
+    expected.insert(expected.end(), {2 * i, 3 * i});
+  }
+  viaevo::TabularDataset::Write(
+      filename,
+      viaevo::TabularDataset::MakeHeader(scoring_mode, 2, 2, num_rows, 0, 99),
+      inputs.data(), expected.data());
+  return filename;
+}
+
+TEST(ScorerTabularTest, InputSets) {
+  viaevo::Random gen;
+  viaevo::ScorerTabular scorer(
+      gen, WriteDataset("scorer_tabular_rows", viaevo::TabularDataset::kBitMatch,
+                        10),
+      4, true);
+
+  // Each row is drawn once in 10 input sets.
+  std::set<int> rows;
+  for (int i = 0; i < 10; ++i) {
+    const viaevo::InputSet &input_set = scorer.current_input_set();
+    int row = input_set.inputs[0];
+    EXPECT_EQ(input_set.inputs, std::vector<int>({row, -row}));
+    EXPECT_EQ(input_set.expected_values, std::vector<int>({2 * row, 3 * row}));
+    rows.insert(row);
+    scorer.ResetInputs();
+  }
+  EXPECT_EQ(rows.size(), 10);
+}
+
+TEST(ScorerTabularTest, BitMatch) {
+  viaevo::Random gen;
+  viaevo::ScorerTabular scorer(
+      gen, WriteDataset("scorer_tabular_bit_match",
+                        viaevo::TabularDataset::kBitMatch, 1));
+  EXPECT_EQ(scorer.MaxScore(), 224);
+
+  viaevo::InputSet input_set;
+  input_set.expected_values = {42, 7};
+  std::vector<int> results{20, 42, 7, -1};
+  EXPECT_EQ(scorer.ScoreResults(results.data(), results.size(), input_set),
+            224);
+  // 42 ^ 43 differ in 1 bit, 7 is still in the results.
+  results[1] = 43;
+  EXPECT_EQ(scorer.ScoreResults(results.data(), results.size(), input_set),
+            31 + 112);
+  results[3] = 42;
+  EXPECT_EQ(scorer.ScoreResults(results.data(), results.size(), input_set),
+            60 + 31 + 112);
+  // No place for the second expected value.
+  EXPECT_EQ(scorer.ScoreResults(results.data(), 2, input_set), 31);
+}
+
+TEST(ScorerTabularTest, ExactMatch) {
+  viaevo::Random gen;
+  viaevo::ScorerTabular scorer(
+      gen, WriteDataset("scorer_tabular_exact_match",
+                        viaevo::TabularDataset::kExactMatch, 1));
+  EXPECT_EQ(scorer.MaxScore(), 2'000);
+
+  viaevo::InputSet input_set;
+  input_set.expected_values = {42, 7};
+  std::vector<int> results{20, 42, 8, 7};
+  EXPECT_EQ(scorer.ScoreResults(results.data(), results.size(), input_set),
+            1'001);
+  results[3] = 0;
+  EXPECT_EQ(scorer.ScoreResults(results.data(), results.size(), input_set),
+            1'000);
+  results[1] = 0;
+  EXPECT_EQ(scorer.ScoreResults(results.data(), results.size(), input_set), 0);
+}
+
+TEST(ScorerTabularTest, RangeReward) {
+  viaevo::Random gen;
+  viaevo::ScorerTabular scorer(
+      gen, WriteDataset("scorer_tabular_range_reward",
+                        viaevo::TabularDataset::kRangeReward, 1));
+  EXPECT_EQ(scorer.MaxScore(), 2'000'000);
+
+  // The data set's range is 0-99.
+  viaevo::InputSet input_set;
+  input_set.expected_values = {42, 7};
+  std::vector<int> results{20, 42, 8, 7};
+  EXPECT_EQ(scorer.ScoreResults(results.data(), results.size(), input_set),
+            1'001'000);
+  results[2] = 100;
+  EXPECT_EQ(scorer.ScoreResults(results.data(), results.size(), input_set),
+            1'000'000);
+  results[1] = 99;
+  EXPECT_EQ(scorer.ScoreResults(results.data(), results.size(), input_set),
+            1'000);
+}
+
+TEST(ScorerTabularTest, ScoreBatch) {
+  viaevo::Random gen;
+  viaevo::ScorerTabular scorer(
+      gen, WriteDataset("scorer_tabular_batch",
+                        viaevo::TabularDataset::kBitMatch, 20));
+
+  // The default Scorer::ScoreBatch scores the rows of a contiguous matrix of
+  // three programs' results as ScoreResults.
+  const viaevo::InputSet &input_set = scorer.current_input_set();
+  int first = input_set.expected_values[0];
+  int second = input_set.expected_values[1];
+  std::vector<int> results{20, first,  second, 20, first, -1,
+                           20, second, first};
+  std::vector<long long> scores(3);
+  scorer.ScoreBatch(results.data(), 3, 3, input_set, scores.data());
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(scores[i],
+              scorer.ScoreResults(results.data() + 3 * i, 3, input_set));
+  EXPECT_EQ(scores[0], scorer.MaxScore());
+}
+
+} // namespace
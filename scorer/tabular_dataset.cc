@@ -0,0 +1,163 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "tabular_dataset.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+namespace viaevo {
+
+namespace {
+
+void Fail(const std::string &filename, const char *message) {
+  fprintf(stderr, "%s: %s\n", filename.c_str(), message);
+  exit(EXIT_FAILURE);
+}
+
+} // namespace
+
+constexpr char TabularDataset::kMagic[8];
+constexpr uint32_t TabularDataset::kVersion;
+
+TabularDataset::Header
+TabularDataset::MakeHeader(ScoringMode scoring_mode, uint32_t inputs_size,
+                           uint32_t expected_size, uint64_t num_rows,
+                           int32_t range_min, int32_t range_max) {
+  Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.scoring_mode = scoring_mode;
+  header.inputs_size = inputs_size;
+  header.expected_size = expected_size;
+  header.num_rows = num_rows;
+  header.range_min = range_min;
+  header.range_max = range_max;
+  return header;
+}
+
+void TabularDataset::Write(const std::string &filename, const Header &header,
+                           const int *inputs, const int *expected) {
+  std::ofstream ofs(filename, std::ios::binary);
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  ofs.write(reinterpret_cast<const char *>(inputs),
+            header.num_rows * header.inputs_size * sizeof(int32_t));
+  ofs.write(reinterpret_cast<const char *>(expected),
+            header.num_rows * header.expected_size * sizeof(int32_t));
+  if (!ofs)
+    Fail(filename, "write failed");
+}
+
+TabularDataset::TabularDataset(const std::string &filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1)
+    Fail(filename, "open failed");
+  struct stat st;
+  if (fstat(fd, &st) == -1)
+    Fail(filename, "fstat failed");
+  size_ = st.st_size;
+  if (size_ < sizeof(Header))
+    Fail(filename, "file too small for the header");
+  void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED)
+    Fail(filename, "mmap failed");
+  close(fd);
+  data_ = static_cast<const uint8_t *>(data);
+
+  Header header;
+  memcpy(&header, data_, sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+    Fail(filename, "not a tabular data set file");
+  if (header.version != kVersion)
+    Fail(filename, "unsupported version");
+  if (header.scoring_mode > kRangeReward)
+    Fail(filename, "unknown scoring mode");
+  if (header.inputs_size == 0 || header.expected_size == 0)
+    Fail(filename, "rows should have at least one input and expected value");
+  if (header.num_rows == 0)
+    Fail(filename, "no rows");
+  if (header.scoring_mode == kRangeReward &&
+      header.range_min > header.range_max)
+    Fail(filename, "range_min is greater than range_max");
+  uint64_t row_size =
+      (uint64_t(header.inputs_size) + header.expected_size) * sizeof(int32_t);
+  if (header.num_rows > (size_ - sizeof(Header)) / row_size ||
+      size_ != sizeof(Header) + header.num_rows * row_size)
+    Fail(filename, "file size does not match the header");
+
+  num_rows_ = header.num_rows;
+  inputs_size_ = header.inputs_size;
+  expected_size_ = header.expected_size;
+  scoring_mode_ = static_cast<ScoringMode>(header.scoring_mode);
+  range_min_ = header.range_min;
+  range_max_ = header.range_max;
+  inputs_ = reinterpret_cast<const int *>(data_ + InputsOffset(header));
+  expected_ = reinterpret_cast<const int *>(data_ + ExpectedOffset(header));
+}
+
+TabularDataset::~TabularDataset() {
+  munmap(const_cast<uint8_t *>(data_), size_);
+}
+
+std::shared_ptr<const TabularDataset>
+TabularDataset::Load(const std::string &filename) {
+  static std::mutex cache_mutex;
+  static std::map<std::string, std::shared_ptr<const TabularDataset>> cache;
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto it = cache.find(filename);
+  if (it != cache.end())
+    return it->second;
+
+  std::shared_ptr<const TabularDataset> dataset(new TabularDataset(filename));
+  cache.emplace(filename, dataset);
+  return dataset;
+}
+
+void TabularDataset::WillNeed(size_t first_row, size_t count) const {
+  Advise(first_row, count, MADV_WILLNEED);
+}
+
+void TabularDataset::DontNeed(size_t first_row, size_t count) const {
+  Advise(first_row, count, MADV_DONTNEED);
+}
+
+void TabularDataset::Advise(size_t first_row, size_t count, int advice) const {
+  if (first_row >= num_rows_)
+    return;
+  count = std::min(count, num_rows_ - first_row);
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  const uint8_t *blocks[] = {
+      reinterpret_cast<const uint8_t *>(inputs(first_row)),
+      reinterpret_cast<const uint8_t *>(expected(first_row))};
+  size_t sizes[] = {count * inputs_size_ * sizeof(int),
+                    count * expected_size_ * sizeof(int)};
+  for (int i = 0; i < 2; ++i) {
+    size_t begin = blocks[i] - data_;
+    size_t end = begin + sizes[i];
+    if (advice == MADV_DONTNEED) {
+      // Pages shared with neighbouring rows are kept.
+      begin = (begin + page_size - 1) / page_size * page_size;
+      end = end / page_size * page_size;
+    } else {
+      begin = begin / page_size * page_size;
+    }
+    if (begin < end)
+      madvise(const_cast<uint8_t *>(data_) + begin, end - begin, advice);
+  }
+}
+
+} // namespace viaevo
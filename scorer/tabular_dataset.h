@@ -0,0 +1,123 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_SCORER_TABULAR_DATASET_H_
+#define VIAEVO_SCORER_TABULAR_DATASET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+namespace viaevo {
+
+// TabularDataset is a read-only memory mapping of a tabular data set file: rows
+// of inputs (inputs_size() ints each) and the expected values for the inputs
+// (expected_size() ints each) together with the way results should be scored
+// against the expected values (see ScorerTabular).
+//
+// The file consists of a 64-byte Header followed by two column blocks: the
+// inputs of all rows and the expected values of all rows (ints in host byte
+// order). The rows are not copied, so data sets larger than memory can be used
+// if they are accessed in blocks of consecutive rows (see WillNeed and
+// DontNeed). The header is validated once (failing the process on invalid files
+// also in optimized builds).
+class TabularDataset {
+public:
+  // How results are scored against the expected values.
+  enum ScoringMode : uint32_t {
+    // Matching bits of the results (e.g. regression of arbitrary values).
+    kBitMatch = 0,
+    // Exact matches only (e.g. values with no meaningful bit structure).
+    kExactMatch = 1,
+    // Exact matches with a smaller reward for results within [range_min,
+    // range_max] (e.g. classification into range_min..range_max).
+    kRangeReward = 2,
+  };
+
+  static constexpr char kMagic[8] = {'V', 'I', 'A', 'E', 'V', 'O', 'T', 'D'};
+  static constexpr uint32_t kVersion = 1;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t scoring_mode;
+    uint32_t inputs_size;
+    uint32_t expected_size;
+    uint64_t num_rows;
+    int32_t range_min;
+    int32_t range_max;
+    uint8_t reserved[24];
+  };
+  static_assert(sizeof(Header) == 64, "Header should have 64 bytes");
+
+  // Returns a Header with the magic and version set.
+  static Header MakeHeader(ScoringMode scoring_mode, uint32_t inputs_size,
+                           uint32_t expected_size, uint64_t num_rows,
+                           int32_t range_min = 0, int32_t range_max = 0);
+  // Offsets of the column blocks in a file with header.
+  static uint64_t InputsOffset(const Header &) { return sizeof(Header); }
+  static uint64_t ExpectedOffset(const Header &header) {
+    return InputsOffset(header) +
+           header.num_rows * header.inputs_size * sizeof(int32_t);
+  }
+  // Writes a data set held in memory (header.num_rows rows of inputs and
+  // expected values). See //examples/200_tabular_dataset:csv_to_tabular_tool
+  // for converting data sets larger than memory.
+  static void Write(const std::string &filename, const Header &header,
+                    const int *inputs, const int *expected);
+
+  // Returns the data set in filename, mapping it on the first call. Subsequent
+  // calls (e.g. by the scorers of concurrent trials) share the mapping.
+  // Thread-safe.
+  static std::shared_ptr<const TabularDataset>
+  Load(const std::string &filename);
+
+  TabularDataset(const TabularDataset &) = delete;
+  TabularDataset &operator=(const TabularDataset &) = delete;
+  ~TabularDataset();
+
+  size_t num_rows() const { return num_rows_; }
+  size_t inputs_size() const { return inputs_size_; }
+  size_t expected_size() const { return expected_size_; }
+  ScoringMode scoring_mode() const { return scoring_mode_; }
+  int range_min() const { return range_min_; }
+  int range_max() const { return range_max_; }
+
+  // Inputs (inputs_size() ints) of the row.
+  const int *inputs(size_t row) const { return inputs_ + row * inputs_size_; }
+  // Expected values (expected_size() ints) for the inputs of the row.
+  const int *expected(size_t row) const {
+    return expected_ + row * expected_size_;
+  }
+
+  // Hints the kernel to read ahead the rows [first_row, first_row + count).
+  void WillNeed(size_t first_row, size_t count) const;
+  // Hints the kernel that the rows [first_row, first_row + count) will not be
+  // accessed soon (their pages are dropped and read again on the next access).
+  void DontNeed(size_t first_row, size_t count) const;
+
+private:
+  explicit TabularDataset(const std::string &filename);
+
+  // Applies madvise advice to the pages of the rows in both column blocks.
+  void Advise(size_t first_row, size_t count, int advice) const;
+
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+  size_t num_rows_ = 0;
+  size_t inputs_size_ = 0;
+  size_t expected_size_ = 0;
+  ScoringMode scoring_mode_ = kBitMatch;
+  int range_min_ = 0;
+  int range_max_ = 0;
+  const int *inputs_ = nullptr;
+  const int *expected_ = nullptr;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_SCORER_TABULAR_DATASET_H_
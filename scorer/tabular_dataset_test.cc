@@ -0,0 +1,92 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "tabular_dataset.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(TabularDatasetTest, WriteLoad) {
+  std::string filename = testing::TempDir() + "tabular_dataset_test";
+  // Three rows of two inputs and one expected value.
+  std::vector<int> inputs{1, 2, 3, 4, -5, 6};
+  std::vector<int> expected{3, 7, 1};
+  viaevo::TabularDataset::Write(
+      filename,
+      viaevo::TabularDataset::MakeHeader(viaevo::TabularDataset::kRangeReward,
+                                         2, 1, 3, -10, 10),
+      inputs.data(), expected.data());
+
+  std::shared_ptr<const viaevo::TabularDataset> dataset =
+      viaevo::TabularDataset::Load(filename);
+
+  EXPECT_EQ(dataset->num_rows(), 3);
+  EXPECT_EQ(dataset->inputs_size(), 2);
+  EXPECT_EQ(dataset->expected_size(), 1);
+  EXPECT_EQ(dataset->scoring_mode(), viaevo::TabularDataset::kRangeReward);
+  EXPECT_EQ(dataset->range_min(), -10);
+  EXPECT_EQ(dataset->range_max(), 10);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(dataset->inputs(i)[0], inputs[2 * i]);
+    EXPECT_EQ(dataset->inputs(i)[1], inputs[2 * i + 1]);
+    EXPECT_EQ(dataset->expected(i)[0], expected[i]);
+  }
+
+  // Advice is only a hint (the rows stay readable).
+  dataset->WillNeed(0, 3);
+  dataset->DontNeed(1, 100);
+  dataset->DontNeed(5, 1);
+  EXPECT_EQ(dataset->inputs(2)[0], -5);
+  EXPECT_EQ(dataset->expected(2)[0], 1);
+
+  // The loaded data set is shared.
+  EXPECT_EQ(viaevo::TabularDataset::Load(filename), dataset);
+}
+
+TEST(TabularDatasetTest, InvalidFiles) {
+  std::string filename = testing::TempDir() + "tabular_dataset_invalid";
+  std::vector<int> values(8, 0);
+
+  {
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << "too small";
+  }
+  EXPECT_DEATH(viaevo::TabularDataset::Load(filename), "too small");
+
+  viaevo::TabularDataset::Header header = viaevo::TabularDataset::MakeHeader(
+      viaevo::TabularDataset::kBitMatch, 2, 2, 2);
+  header.magic[0] = 'X';
+  viaevo::TabularDataset::Write(filename, header, values.data(), values.data());
+  EXPECT_DEATH(viaevo::TabularDataset::Load(filename), "not a tabular");
+
+  header = viaevo::TabularDataset::MakeHeader(
+      viaevo::TabularDataset::kBitMatch, 2, 2, 2);
+  header.scoring_mode = 3;
+  viaevo::TabularDataset::Write(filename, header, values.data(), values.data());
+  EXPECT_DEATH(viaevo::TabularDataset::Load(filename), "unknown scoring mode");
+
+  // Truncated file (the header claims 3 rows for 2 rows of data).
+  header = viaevo::TabularDataset::MakeHeader(
+      viaevo::TabularDataset::kBitMatch, 2, 2, 2);
+  viaevo::TabularDataset::Write(filename, header, values.data(), values.data());
+  header.num_rows = 3;
+  {
+    std::fstream fs(filename, std::ios::binary | std::ios::in | std::ios::out);
+    fs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+  EXPECT_DEATH(viaevo::TabularDataset::Load(filename), "file size");
+
+  header = viaevo::TabularDataset::MakeHeader(
+      viaevo::TabularDataset::kRangeReward, 2, 2, 2, 9, 0);
+  viaevo::TabularDataset::Write(filename, header, values.data(), values.data());
+  EXPECT_DEATH(viaevo::TabularDataset::Load(filename), "range_min");
+}
+
+} // namespace
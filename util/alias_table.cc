@@ -0,0 +1,67 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "alias_table.h"
+
+#include <assert.h>
+
+#include <cmath>
+
+namespace viaevo {
+
+AliasTable::AliasTable(const std::vector<double> &weights) { Reset(weights); }
+
+void AliasTable::Reset(const std::vector<double> &weights) {
+  int n = weights.size();
+  double sum = 0.0;
+  for (double weight : weights) {
+    assert(weight >= 0.0 && "weights should be non-negative");
+    sum += weight;
+  }
+  assert(sum > 0.0 && "at least one weight should be positive");
+
+  probabilities_.resize(n);
+  thresholds_.assign(n, 0);
+  aliases_.resize(n);
+  // Probabilities scaled by n, columns with scaled probability below 1.0 are
+  // "small" and get topped up by an alias from the "large" columns.
+  std::vector<double> scaled(n);
+  std::vector<int> small, large;
+  for (int i = 0; i < n; ++i) {
+    probabilities_[i] = weights[i] / sum;
+    scaled[i] = probabilities_[i] * n;
+    aliases_[i] = i;
+    if (scaled[i] < 1.0)
+      small.push_back(i);
+    else
+      large.push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    int s = small.back();
+    small.pop_back();
+    int l = large.back();
+    thresholds_[s] = (uint64_t)std::llround(scaled[s] * 4294967296.0);
+    aliases_[s] = l;
+    scaled[l] -= 1.0 - scaled[s];
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // The remaining columns are (up to rounding errors) full.
+  for (int i : large)
+    thresholds_[i] = 4294967296ULL;
+  for (int i : small)
+    thresholds_[i] = 4294967296ULL;
+}
+
+int AliasTable::Sample(Random &gen) const {
+  assert(!thresholds_.empty() && "the alias table should not be empty");
+  int column = gen() % thresholds_.size();
+  uint64_t coin = gen() & 0xffffffff;
+  return coin < thresholds_[column] ? column : aliases_[column];
+}
+
+} // namespace viaevo
@@ -0,0 +1,46 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_UTIL_ALIAS_TABLE_H_
+#define VIAEVO_UTIL_ALIAS_TABLE_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "random.h"
+
+namespace viaevo {
+
+// AliasTable samples indices 0..(n - 1) with probabilities proportional to n
+// non-negative weights in O(1) time (Vose's alias method). Each sample draws
+// two random numbers: one selects a column of the table and the other decides
+// between the column and its alias. Building the table takes O(n) time.
+class AliasTable {
+public:
+  AliasTable() = default;
+  explicit AliasTable(const std::vector<double> &weights);
+
+  // Rebuilds the table for weights. At least one weight should be positive.
+  void Reset(const std::vector<double> &weights);
+  // Returns a random index with probability proportional to its weight.
+  int Sample(Random &gen) const;
+
+  // Probability of sampling index (the normalized weight).
+  double probability(int index) const { return probabilities_[index]; }
+  int size() const { return probabilities_.size(); }
+
+protected:
+  // A column is kept if the second random number is below its threshold
+  // (probability of keeping the column scaled to 2^32) and replaced by its
+  // alias otherwise.
+  std::vector<uint64_t> thresholds_;
+  std::vector<int> aliases_;
+  std::vector<double> probabilities_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_UTIL_ALIAS_TABLE_H_
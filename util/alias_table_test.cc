@@ -0,0 +1,71 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "alias_table.h"
+
+#include <vector>
+
+#include <gtest/gtest-death-test.h>
+#include <gtest/gtest.h>
+
+#include "random_mock.h"
+
+namespace {
+
+TEST(AliasTableTest, Probabilities) {
+  viaevo::AliasTable table({1.0, 1.0, 1.0, 7.0});
+  EXPECT_EQ(table.size(), 4);
+  EXPECT_DOUBLE_EQ(table.probability(0), 0.1);
+  EXPECT_DOUBLE_EQ(table.probability(1), 0.1);
+  EXPECT_DOUBLE_EQ(table.probability(2), 0.1);
+  EXPECT_DOUBLE_EQ(table.probability(3), 0.7);
+}
+
+TEST(AliasTableTest, Sample) {
+  // Column 0 has probability 0.4 scaled by 2 (columns) to 0.8, the remaining
+  // 0.2 of the column is the alias 1.
+  viaevo::AliasTable table({2.0, 3.0});
+  // Column 0 with the second number below 0.8 * 2^32 selects the column.
+  viaevo::RandomMock gen({0, 0});
+  EXPECT_EQ(table.Sample(gen), 0);
+  gen.set_values({0, 3435973836});
+  EXPECT_EQ(table.Sample(gen), 0);
+  // Column 0 (2 % 2) with the second number at (rounded) 0.8 * 2^32.
+  gen.set_values({2, 3435973837});
+  EXPECT_EQ(table.Sample(gen), 1);
+  // Column 1 is full.
+  gen.set_values({1, 4294967295});
+  EXPECT_EQ(table.Sample(gen), 1);
+}
+
+TEST(AliasTableTest, ZeroWeightsAreNeverSampled) {
+  viaevo::AliasTable table({0.0, 5.0, 0.0});
+  viaevo::Random gen;
+  gen.Seed(1);
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(table.Sample(gen), 1);
+}
+
+TEST(AliasTableTest, SampleFrequencies) {
+  std::vector<double> weights = {0.5, 2.0, 4.0, 1.5, 0.0, 2.0};
+  viaevo::AliasTable table(weights);
+  viaevo::Random gen;
+  gen.Seed(42);
+  std::vector<int> counts(weights.size());
+  const int n = 100'000;
+  for (int i = 0; i < n; ++i)
+    ++counts[table.Sample(gen)];
+  for (size_t i = 0; i < weights.size(); ++i)
+    EXPECT_NEAR((double)counts[i] / n, table.probability(i), 0.01);
+}
+
+TEST(AliasTableTest, InvalidWeights) {
+  EXPECT_DEATH(viaevo::AliasTable({0.0, 0.0}),
+               "at least one weight should be positive");
+  EXPECT_DEATH(viaevo::AliasTable({1.0, -1.0}),
+               "weights should be non-negative");
+}
+
+} // namespace
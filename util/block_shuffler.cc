@@ -0,0 +1,58 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "block_shuffler.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace viaevo {
+
+BlockShuffler::BlockShuffler(Random &gen, size_t num_items, size_t block_size)
+    : gen_(gen), num_items_(num_items), block_size_(block_size) {
+  assert(num_items > 0 && "BlockShuffler needs at least one item");
+  assert(block_size > 0 && "block_size should be positive");
+  order_.resize((num_items + block_size - 1) / block_size);
+  std::iota(order_.begin(), order_.end(), 0);
+  next_order_ = order_;
+  std::shuffle(order_.begin(), order_.end(), gen_.gen());
+  std::shuffle(next_order_.begin(), next_order_.end(), gen_.gen());
+  current_block_ = order_[0];
+}
+
+size_t BlockShuffler::Next() {
+  entered_block_ = false;
+  if (position_in_block_ == indices_.size()) {
+    // The first call enters the first block of the first epoch, subsequent
+    // calls advance to the next block.
+    if (!indices_.empty() && ++position_ == order_.size()) {
+      std::swap(order_, next_order_);
+      std::shuffle(next_order_.begin(), next_order_.end(), gen_.gen());
+      position_ = 0;
+      ++epoch_;
+    }
+    current_block_ = order_[position_];
+    indices_.resize(BlockSize(current_block_));
+    std::iota(indices_.begin(), indices_.end(), BlockBegin(current_block_));
+    std::shuffle(indices_.begin(), indices_.end(), gen_.gen());
+    position_in_block_ = 0;
+    entered_block_ = true;
+  }
+  return indices_[position_in_block_++];
+}
+
+size_t BlockShuffler::BlockSize(size_t block) const {
+  return std::min(block_size_, num_items_ - BlockBegin(block));
+}
+
+size_t BlockShuffler::NextBlock() const {
+  return position_ + 1 < order_.size() ? order_[position_ + 1]
+                                       : next_order_[0];
+}
+
+} // namespace viaevo
@@ -0,0 +1,72 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_UTIL_BLOCK_SHUFFLER_H_
+#define VIAEVO_UTIL_BLOCK_SHUFFLER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "random.h"
+
+namespace viaevo {
+
+// BlockShuffler visits the indices 0..(num_items - 1) in a random order that
+// keeps memory accesses local: the indices are split into blocks of block_size
+// consecutive indices, the blocks are visited in a random order and the
+// indices within each block in a random order. Every index is visited once per
+// epoch and each epoch visits the blocks in a new order. The order of the block
+// visited next is known in advance so that its data can be prefetched (e.g.
+// rows of a memory-mapped file larger than memory).
+class BlockShuffler {
+public:
+  BlockShuffler(Random &gen, size_t num_items, size_t block_size);
+
+  // Returns the next index.
+  size_t Next();
+  // True if the index returned by the last call of Next was the first visited
+  // index of its block.
+  bool entered_block() const { return entered_block_; }
+
+  // First index and number of indices of the block of the index returned by
+  // the last call of Next.
+  size_t block_begin() const { return BlockBegin(current_block_); }
+  size_t block_size() const { return BlockSize(current_block_); }
+  // First index and number of indices of the block visited after the current
+  // one (the first block of the next epoch after the last block of an epoch).
+  size_t next_block_begin() const { return BlockBegin(NextBlock()); }
+  size_t next_block_size() const { return BlockSize(NextBlock()); }
+
+  size_t num_items() const { return num_items_; }
+  size_t num_blocks() const { return order_.size(); }
+  // Number of completed passes over all indices.
+  size_t epoch() const { return epoch_; }
+
+protected:
+  size_t BlockBegin(size_t block) const { return block * block_size_; }
+  size_t BlockSize(size_t block) const;
+  size_t NextBlock() const;
+
+  Random &gen_;
+  size_t num_items_ = 0;
+  size_t block_size_ = 0;
+  // Order of the blocks in the current and in the next epoch.
+  std::vector<size_t> order_;
+  std::vector<size_t> next_order_;
+  // Position of the current block in order_.
+  size_t position_ = 0;
+  size_t current_block_ = 0;
+  // Shuffled indices of the current block and the position of the index
+  // returned next.
+  std::vector<size_t> indices_;
+  size_t position_in_block_ = 0;
+  size_t epoch_ = 0;
+  bool entered_block_ = false;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_UTIL_BLOCK_SHUFFLER_H_
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "block_shuffler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(BlockShufflerTest, VisitsEachIndexOncePerEpoch) {
+  viaevo::Random gen;
+  // Blocks of 4, 4 and 2 indices.
+  viaevo::BlockShuffler shuffler(gen, 10, 4);
+  EXPECT_EQ(shuffler.num_items(), 10);
+  EXPECT_EQ(shuffler.num_blocks(), 3);
+
+  for (int epoch = 0; epoch < 3; ++epoch) {
+    std::vector<int> visits(10, 0);
+    for (int i = 0; i < 10; ++i)
+      ++visits[shuffler.Next()];
+    EXPECT_EQ(visits, std::vector<int>(10, 1));
+    EXPECT_EQ(shuffler.epoch(), epoch);
+  }
+  shuffler.Next();
+  EXPECT_EQ(shuffler.epoch(), 3);
+}
+
+TEST(BlockShufflerTest, VisitsBlocksContiguously) {
+  viaevo::Random gen;
+  viaevo::BlockShuffler shuffler(gen, 10, 4);
+
+  size_t index = shuffler.Next();
+  // 9 blocks are 3 epochs.
+  for (int block = 0; block < 9; ++block) {
+    ASSERT_TRUE(shuffler.entered_block());
+    size_t begin = shuffler.block_begin();
+    size_t size = shuffler.block_size();
+    EXPECT_EQ(begin % 4, 0);
+    EXPECT_EQ(size, begin == 8 ? 2 : 4);
+    size_t next_begin = shuffler.next_block_begin();
+    size_t next_size = shuffler.next_block_size();
+
+    std::vector<size_t> indices{index};
+    for (size_t i = 1; i < size; ++i) {
+      indices.push_back(shuffler.Next());
+      EXPECT_FALSE(shuffler.entered_block());
+      EXPECT_EQ(shuffler.block_begin(), begin);
+    }
+    std::sort(indices.begin(), indices.end());
+    for (size_t i = 0; i < size; ++i)
+      EXPECT_EQ(indices[i], begin + i);
+
+    // The announced next block is the one visited next (also across epochs).
+    index = shuffler.Next();
+    EXPECT_EQ(shuffler.block_begin(), next_begin);
+    EXPECT_EQ(shuffler.block_size(), next_size);
+  }
+}
+
+TEST(BlockShufflerTest, SingleBlock) {
+  viaevo::Random gen;
+  viaevo::BlockShuffler shuffler(gen, 3, 100);
+  EXPECT_EQ(shuffler.num_blocks(), 1);
+
+  std::vector<size_t> indices;
+  for (int i = 0; i < 3; ++i)
+    indices.push_back(shuffler.Next());
+  EXPECT_EQ(shuffler.block_begin(), 0);
+  EXPECT_EQ(shuffler.block_size(), 3);
+  EXPECT_EQ(shuffler.next_block_begin(), 0);
+  std::sort(indices.begin(), indices.end());
+  EXPECT_EQ(indices, std::vector<size_t>({0, 1, 2}));
+}
+
+} // namespace
@@ -13,4 +13,9 @@ void Random::Seed(mt_type::result_type value) { gen_.seed(value); }
 
 mt_type::result_type Random::operator()() { return gen_(); };
 
+void Random::Fill(mt_type::result_type *values, size_t size) {
+  for (size_t i = 0; i < size; ++i)
+    values[i] = (*this)();
+}
+
 } // namespace viaevo
@@ -6,6 +6,8 @@
 #ifndef VIAEVO_UTIL_RANDOM_H_
 #define VIAEVO_UTIL_RANDOM_H_
 
+#include <stddef.h>
+
 #include <random>
 
 namespace viaevo {
@@ -18,10 +20,14 @@ public:
   Random();
   virtual ~Random() = default;
 
-  void Seed(mt_type::result_type value);
+  virtual void Seed(mt_type::result_type value);
   virtual mt_type::result_type operator()();
+  // Fills values with size consecutive random numbers (the same numbers as
+  // from size consecutive calls of operator()). Avoids a virtual call per
+  // number in derived classes overriding it.
+  virtual void Fill(mt_type::result_type *values, size_t size);
 
-  mt_type &gen() { return gen_; }
+  virtual mt_type &gen() { return gen_; }
 
   template <class CharT, class Traits>
   friend std::basic_ostream<CharT, Traits> &
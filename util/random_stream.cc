@@ -0,0 +1,101 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "random_stream.h"
+
+namespace viaevo {
+
+namespace {
+constexpr uint32_t kPhiloxM0 = 0xD2511F53;
+constexpr uint32_t kPhiloxM1 = 0xCD9E8D57;
+constexpr uint32_t kPhiloxW0 = 0x9E3779B9;
+constexpr uint32_t kPhiloxW1 = 0xBB67AE85;
+} // namespace
+
+RandomStream::RandomStream(uint64_t seed, uint32_t generation, uint32_t slot,
+                           uint32_t purpose)
+    : key_{{(uint32_t)seed, (uint32_t)(seed >> 32)}},
+      counter_{{0, slot, generation, purpose}} {
+  Restart();
+}
+
+void RandomStream::Seed(mt_type::result_type value) {
+  key_ = {{(uint32_t)value, (uint32_t)((uint64_t)value >> 32)}};
+  counter_ = {{0, 0, 0, 0}};
+  Restart();
+}
+
+mt_type::result_type RandomStream::operator()() {
+  if (block_index_ == 4) {
+    block_ = Philox4x32(counter_, key_);
+    ++counter_[0];
+    block_index_ = 0;
+  }
+  return block_[block_index_++];
+}
+
+void RandomStream::Fill(mt_type::result_type *values, size_t size) {
+  size_t i = 0;
+  // Numbers left in the current block.
+  while (i < size && block_index_ < 4)
+    values[i++] = block_[block_index_++];
+  // Whole blocks.
+  while (size - i >= 4) {
+    Counter block = Philox4x32(counter_, key_);
+    ++counter_[0];
+    values[i] = block[0];
+    values[i + 1] = block[1];
+    values[i + 2] = block[2];
+    values[i + 3] = block[3];
+    i += 4;
+  }
+  while (i < size)
+    values[i++] = (*this)();
+}
+
+RandomStream RandomStream::Derive(uint32_t generation, uint32_t slot,
+                                  uint32_t purpose) const {
+  RandomStream stream;
+  stream.key_ = key_;
+  stream.counter_ = {{0, slot, generation, purpose}};
+  stream.Restart();
+  return stream;
+}
+
+RandomStream::Counter RandomStream::Philox4x32(Counter counter, Key key) {
+  for (int round = 0; round < 10; ++round) {
+    if (round > 0) {
+      key[0] += kPhiloxW0;
+      key[1] += kPhiloxW1;
+    }
+    uint64_t product0 = (uint64_t)kPhiloxM0 * counter[0];
+    uint64_t product1 = (uint64_t)kPhiloxM1 * counter[2];
+    counter = {{(uint32_t)(product1 >> 32) ^ counter[1] ^ key[0],
+                (uint32_t)product1,
+                (uint32_t)(product0 >> 32) ^ counter[3] ^ key[1],
+                (uint32_t)product0}};
+  }
+  return counter;
+}
+
+mt_type &RandomStream::gen() {
+  if (!gen_seeded_) {
+    Counter last = counter_;
+    last[0] = 0xFFFFFFFF;
+    Counter seed_block = Philox4x32(last, key_);
+    std::seed_seq seq(seed_block.begin(), seed_block.end());
+    gen_.seed(seq);
+    gen_seeded_ = true;
+  }
+  return gen_;
+}
+
+void RandomStream::Restart() {
+  counter_[0] = 0;
+  block_index_ = 4;
+  gen_seeded_ = false;
+}
+
+} // namespace viaevo
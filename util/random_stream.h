@@ -0,0 +1,70 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_UTIL_RANDOM_STREAM_H_
+#define VIAEVO_UTIL_RANDOM_STREAM_H_
+
+#include <stdint.h>
+
+#include <array>
+
+#include "random.h"
+
+namespace viaevo {
+
+// RandomStream is a counter-based random number generator (Philox4x32-10,
+// Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC 2011). The
+// n-th number of a stream is a pure function of the seed (the key) and the
+// counter (block, slot, generation, purpose), so independent streams can be
+// derived for e.g. each offspring (slot) in each generation and purpose
+// (mutation, inputs, ...) without any shared state. Numbers drawn from a
+// derived stream do not depend on the order (or thread) in which streams are
+// used.
+//
+// gen() (e.g. for std::shuffle) returns a std::mt19937 seeded from the stream's
+// last block (block 0xffffffff). It is seeded on the first call of gen() after
+// the stream is created or seeded (derived streams drawing only from
+// operator() or Fill stay cheap).
+class RandomStream : public Random {
+public:
+  typedef std::array<uint32_t, 4> Counter;
+  typedef std::array<uint32_t, 2> Key;
+
+  explicit RandomStream(uint64_t seed = 0, uint32_t generation = 0,
+                        uint32_t slot = 0, uint32_t purpose = 0);
+
+  // Restarts the stream with seed value and (generation, slot, purpose) =
+  // (0, 0, 0).
+  virtual void Seed(mt_type::result_type value) override;
+  virtual mt_type::result_type operator()() override;
+  virtual void Fill(mt_type::result_type *values, size_t size) override;
+  virtual mt_type &gen() override;
+
+  // Returns the stream with the same seed for (generation, slot, purpose)
+  // starting at its first number. Independent of the numbers drawn so far.
+  RandomStream Derive(uint32_t generation, uint32_t slot,
+                      uint32_t purpose) const;
+
+  // Returns the Philox4x32-10 block for counter and key.
+  static Counter Philox4x32(Counter counter, Key key);
+
+protected:
+  // Restarts the stream at block 0 (gen_ is reseeded on the next call of
+  // gen()).
+  void Restart();
+
+  Key key_;
+  // counter_[0] is the block number, counter_[1..3] are the slot, the
+  // generation and the purpose.
+  Counter counter_;
+  // Current block of random numbers and the index of the next number in it.
+  Counter block_;
+  int block_index_ = 4;
+  bool gen_seeded_ = false;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_UTIL_RANDOM_STREAM_H_
@@ -0,0 +1,100 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "random_stream.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(RandomStreamTest, Philox4x32KnownAnswers) {
+  // Known-answer tests of the Random123 library (kat_vectors).
+  viaevo::RandomStream::Counter expected = {
+      {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}};
+  EXPECT_EQ(viaevo::RandomStream::Philox4x32({{0, 0, 0, 0}}, {{0, 0}}),
+            expected);
+
+  expected = {{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}};
+  EXPECT_EQ(viaevo::RandomStream::Philox4x32(
+                {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+                {{0xffffffff, 0xffffffff}}),
+            expected);
+
+  expected = {{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+  EXPECT_EQ(viaevo::RandomStream::Philox4x32(
+                {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+                {{0xa4093822, 0x299f31d0}}),
+            expected);
+}
+
+TEST(RandomStreamTest, GeneratedValues) {
+  viaevo::RandomStream stream(42);
+  viaevo::RandomStream same(42);
+  viaevo::RandomStream other_seed(43);
+
+  std::vector<viaevo::mt_type::result_type> values, same_values, other_values;
+  for (int i = 0; i < 10; ++i) {
+    values.push_back(stream());
+    same_values.push_back(same());
+    other_values.push_back(other_seed());
+  }
+  EXPECT_EQ(values, same_values);
+  EXPECT_NE(values, other_values);
+
+  // The first block of the stream.
+  viaevo::RandomStream::Counter block =
+      viaevo::RandomStream::Philox4x32({{0, 0, 0, 0}}, {{42, 0}});
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(values[i], block[i]);
+
+  stream.Seed(42);
+  EXPECT_EQ(stream(), values[0]);
+}
+
+TEST(RandomStreamTest, Fill) {
+  viaevo::RandomStream stream(7);
+  viaevo::RandomStream filled(7);
+
+  // Fill should match consecutive calls of operator() for sizes not aligned to
+  // blocks.
+  std::vector<viaevo::mt_type::result_type> values(11);
+  filled();
+  filled.Fill(values.data(), values.size());
+  stream();
+  for (auto value : values)
+    EXPECT_EQ(value, stream());
+  EXPECT_EQ(filled(), stream());
+}
+
+TEST(RandomStreamTest, Derive) {
+  viaevo::RandomStream stream(42);
+  viaevo::RandomStream derived = stream.Derive(3, 5, 1);
+
+  // Derived streams do not depend on the numbers drawn from the stream.
+  stream();
+  viaevo::RandomStream derived_later = stream.Derive(3, 5, 1);
+  EXPECT_EQ(derived(), derived_later());
+
+  // Streams with different (generation, slot, purpose) differ.
+  viaevo::RandomStream a = stream.Derive(3, 5, 1);
+  viaevo::RandomStream b = stream.Derive(3, 6, 1);
+  viaevo::RandomStream c = stream.Derive(4, 5, 1);
+  viaevo::RandomStream d = stream.Derive(3, 5, 2);
+  auto first = a();
+  EXPECT_NE(first, b());
+  EXPECT_NE(first, c());
+  EXPECT_NE(first, d());
+
+  // Equivalent to constructing the stream directly.
+  viaevo::RandomStream direct(42, 3, 5, 1);
+  EXPECT_EQ(direct(), first);
+
+  // gen() is seeded deterministically as well.
+  EXPECT_EQ(stream.Derive(3, 5, 1).gen()(), direct.gen()());
+}
+
+} // namespace
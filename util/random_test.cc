@@ -23,4 +23,18 @@ TEST(RandomTest, GeneratedValues) {
   EXPECT_EQ(random(), mt_gen());
 }
 
-} //  namespace
\ No newline at end of file
+TEST(RandomTest, Fill) {
+  viaevo::mt_type mt_gen;
+  viaevo::Random random;
+
+  random.Seed(42);
+  mt_gen.seed(42);
+
+  viaevo::mt_type::result_type values[5];
+  random.Fill(values, 5);
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ(values[i], mt_gen());
+  EXPECT_EQ(random(), mt_gen());
+}
+
+} //  namespace
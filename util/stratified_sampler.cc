@@ -0,0 +1,75 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "stratified_sampler.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+namespace viaevo {
+
+StratifiedSampler::StratifiedSampler(
+    Random &gen, const std::vector<std::vector<int>> &items_by_class,
+    int items_per_class, int rotated_items_per_class)
+    : gen_(gen), items_per_class_(items_per_class),
+      rotated_items_per_class_(rotated_items_per_class) {
+  assert(items_per_class > 0 && "items_per_class should be positive");
+  assert(rotated_items_per_class > 0 &&
+         rotated_items_per_class <= items_per_class &&
+         "rotated_items_per_class should be in 1..items_per_class");
+  for (const std::vector<int> &items : items_by_class) {
+    if (!items.empty())
+      permutations_.push_back(items);
+  }
+  assert(!permutations_.empty() && "StratifiedSampler needs at least one item");
+  for (std::vector<int> &permutation : permutations_)
+    std::shuffle(permutation.begin(), permutation.end(), gen_.gen());
+  positions_.assign(permutations_.size(), 0);
+
+  // The first batch draws all items.
+  windows_.resize(permutations_.size());
+  for (size_t i = 0; i < windows_.size(); ++i) {
+    for (int j = 0; j < items_per_class_; ++j)
+      windows_[i].push_back(Draw(i));
+  }
+  batch_.reserve(batch_size());
+  for (const std::vector<int> &window : windows_)
+    batch_.insert(batch_.end(), window.begin(), window.end());
+  std::shuffle(batch_.begin(), batch_.end(), gen_.gen());
+}
+
+int StratifiedSampler::Next() {
+  if (batch_position_ == batch_.size())
+    NextBatch();
+  return batch_[batch_position_++];
+}
+
+int StratifiedSampler::Draw(size_t index) {
+  std::vector<int> &permutation = permutations_[index];
+  if (positions_[index] == permutation.size()) {
+    std::shuffle(permutation.begin(), permutation.end(), gen_.gen());
+    positions_[index] = 0;
+  }
+  return permutation[positions_[index]++];
+}
+
+void StratifiedSampler::NextBatch() {
+  // The oldest items of each class are replaced.
+  for (size_t i = 0; i < windows_.size(); ++i) {
+    for (int j = 0; j < rotated_items_per_class_; ++j)
+      windows_[i][(window_position_ + j) % items_per_class_] = Draw(i);
+  }
+  window_position_ =
+      (window_position_ + rotated_items_per_class_) % items_per_class_;
+
+  batch_.clear();
+  for (const std::vector<int> &window : windows_)
+    batch_.insert(batch_.end(), window.begin(), window.end());
+  std::shuffle(batch_.begin(), batch_.end(), gen_.gen());
+  batch_position_ = 0;
+}
+
+} // namespace viaevo
@@ -0,0 +1,63 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_UTIL_STRATIFIED_SAMPLER_H_
+#define VIAEVO_UTIL_STRATIFIED_SAMPLER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "random.h"
+
+namespace viaevo {
+
+// StratifiedSampler draws items in class-balanced batches: each batch holds
+// items_per_class items of every (non-empty) class in a random order. The items
+// of each class are drawn without replacement from a random permutation of the
+// class (a new permutation once all items of the class were drawn).
+//
+// With rotated_items_per_class < items_per_class, only rotated_items_per_class
+// items of each class are replaced in each batch and the remaining items are
+// kept from the previous batch, i.e. each item stays for items_per_class /
+// rotated_items_per_class batches. (Consecutive batches, e.g. the evaluations
+// of consecutive generations, are then scored on largely the same items.)
+class StratifiedSampler {
+public:
+  // items_by_class[c] lists the items (e.g. sample indices) of class c.
+  StratifiedSampler(Random &gen,
+                    const std::vector<std::vector<int>> &items_by_class,
+                    int items_per_class, int rotated_items_per_class);
+
+  // Returns the next item.
+  int Next();
+  // Number of items in each batch.
+  size_t batch_size() const { return items_per_class_ * windows_.size(); }
+
+protected:
+  // Draws the next item of the class at index (of non-empty classes).
+  int Draw(size_t index);
+  // Replaces the rotated items of each class and shuffles the new batch.
+  void NextBatch();
+
+  Random &gen_;
+  int items_per_class_ = 0;
+  int rotated_items_per_class_ = 0;
+  // Permuted items of each non-empty class and the position of the next item
+  // to draw.
+  std::vector<std::vector<int>> permutations_;
+  std::vector<size_t> positions_;
+  // Current items_per_class_ items of each non-empty class and the position of
+  // the next item to replace.
+  std::vector<std::vector<int>> windows_;
+  size_t window_position_ = 0;
+  // Items of the current batch and the position of the item returned next.
+  std::vector<int> batch_;
+  size_t batch_position_ = 0;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_UTIL_STRATIFIED_SAMPLER_H_
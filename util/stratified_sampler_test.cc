@@ -0,0 +1,69 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "stratified_sampler.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Items 10 * c + i of class c (i < sizes[c]).
+std::vector<std::vector<int>> ItemsByClass(const std::vector<int> &sizes) {
+  std::vector<std::vector<int>> items_by_class(sizes.size());
+  for (size_t c = 0; c < sizes.size(); ++c)
+    for (int i = 0; i < sizes[c]; ++i)
+      items_by_class[c].push_back(10 * c + i);
+  return items_by_class;
+}
+
+TEST(StratifiedSamplerTest, BalancedBatches) {
+  viaevo::Random gen;
+  // Class 2 is empty and skipped.
+  viaevo::StratifiedSampler sampler(gen, ItemsByClass({4, 6, 0, 9}), 2, 2);
+  EXPECT_EQ(sampler.batch_size(), 6);
+
+  std::map<int, int> visits;
+  // 6 batches draw each item of class 0 three times and of class 1 twice.
+  for (int batch = 0; batch < 6; ++batch) {
+    std::map<int, int> items_per_class;
+    for (int i = 0; i < 6; ++i) {
+      int item = sampler.Next();
+      ++items_per_class[item / 10];
+      ++visits[item];
+    }
+    EXPECT_EQ(items_per_class, (std::map<int, int>{{0, 2}, {1, 2}, {3, 2}}));
+  }
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(visits[i], 3);
+  for (int i = 0; i < 6; ++i)
+    EXPECT_EQ(visits[10 + i], 2);
+}
+
+TEST(StratifiedSamplerTest, RotatedItems) {
+  viaevo::Random gen;
+  viaevo::StratifiedSampler sampler(gen, ItemsByClass({10, 10}), 4, 1);
+
+  std::vector<std::multiset<int>> batches;
+  for (int batch = 0; batch < 5; ++batch) {
+    batches.emplace_back();
+    for (int i = 0; i < 8; ++i)
+      batches.back().insert(sampler.Next());
+  }
+  // Each batch keeps 3 of the 4 items of each class from the previous batch.
+  for (int batch = 1; batch < 5; ++batch) {
+    std::vector<int> common;
+    std::set_intersection(batches[batch - 1].begin(), batches[batch - 1].end(),
+                          batches[batch].begin(), batches[batch].end(),
+                          std::back_inserter(common));
+    EXPECT_EQ(common.size(), 6);
+  }
+}
+
+} // namespace
@@ -0,0 +1,69 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "worker_pool.h"
+
+#include <assert.h>
+
+namespace viaevo {
+
+WorkerPool::WorkerPool(int num_threads) {
+  assert(num_threads >= 1 && "num_threads should be at least 1");
+  for (int i = 0; i < num_threads; ++i)
+    threads_.emplace_back(&WorkerPool::WorkerLoop, this);
+}
+
+WorkerPool::~WorkerPool() {
+  Wait();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_available_.notify_all();
+  for (auto &thread : threads_)
+    thread.join();
+}
+
+std::future<void> WorkerPool::Submit(std::function<void()> task) {
+  std::packaged_task<void()> packaged_task(std::move(task));
+  std::future<void> future = packaged_task.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push(std::move(packaged_task));
+    ++pending_tasks_;
+  }
+  task_available_.notify_one();
+  return future;
+}
+
+void WorkerPool::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  all_done_.wait(lock, [this] { return pending_tasks_ == 0; });
+}
+
+void WorkerPool::WorkerLoop() {
+  while (true) {
+    std::packaged_task<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(lock,
+                           [this] { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty())
+        return;
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    // Exceptions thrown by task are stored in its future.
+    task();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --pending_tasks_;
+      if (pending_tasks_ == 0)
+        all_done_.notify_all();
+    }
+  }
+}
+
+} // namespace viaevo
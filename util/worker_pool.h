@@ -0,0 +1,59 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_UTIL_WORKER_POOL_H_
+#define VIAEVO_UTIL_WORKER_POOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace viaevo {
+
+// WorkerPool runs submitted tasks on a fixed number of threads. Tasks are
+// started in the order of submission.
+//
+// NOTE: A Program forks and ptraces its ELF process from the thread calling
+// Program::Execute (the tracer is the forking thread). A task executing
+// Programs should therefore execute them entirely within the task.
+class WorkerPool {
+public:
+  explicit WorkerPool(int num_threads);
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+  // Waits for all submitted tasks to finish and joins the threads.
+  ~WorkerPool();
+
+  // Queues task for execution. The returned future becomes ready when task
+  // finishes.
+  std::future<void> Submit(std::function<void()> task);
+  // Blocks until all tasks submitted so far have finished.
+  void Wait();
+
+  int num_threads() const { return threads_.size(); }
+
+protected:
+  // Main loop of each worker thread.
+  void WorkerLoop();
+
+  std::vector<std::thread> threads_;
+  std::queue<std::packaged_task<void()>> tasks_;
+  // Number of tasks submitted and not finished yet.
+  int pending_tasks_ = 0;
+  bool stopping_ = false;
+  std::mutex mutex_;
+  // Signals new tasks (or stopping_) to the worker threads.
+  std::condition_variable task_available_;
+  // Signals pending_tasks_ reaching 0 to Wait.
+  std::condition_variable all_done_;
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_UTIL_WORKER_POOL_H_
@@ -0,0 +1,50 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "worker_pool.h"
+
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(WorkerPoolTest, RunsAllTasks) {
+  viaevo::WorkerPool pool(3);
+  EXPECT_EQ(pool.num_threads(), 3);
+
+  std::atomic<int> sum(0);
+  std::vector<std::future<void>> futures;
+  for (int i = 1; i <= 100; ++i)
+    futures.push_back(pool.Submit([&sum, i] { sum += i; }));
+  pool.Wait();
+
+  EXPECT_EQ(sum, 5050);
+  for (auto &future : futures) {
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(0)),
+              std::future_status::ready);
+  }
+}
+
+TEST(WorkerPoolTest, RunsTasksConcurrently) {
+  viaevo::WorkerPool pool(2);
+
+  // The two tasks can only finish if they run at the same time.
+  std::atomic<int> started(0);
+  auto task = [&started] {
+    ++started;
+    while (started < 2)
+      std::this_thread::yield();
+  };
+  std::future<void> first = pool.Submit(task);
+  std::future<void> second = pool.Submit(task);
+  first.get();
+  second.get();
+
+  EXPECT_EQ(started, 2);
+}
+
+} // namespace
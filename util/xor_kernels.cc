@@ -0,0 +1,153 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "xor_kernels.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <initializer_list>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define VIAEVO_XOR_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace viaevo {
+
+namespace {
+
+// Handles the bytes not covered by the vector loops (and the whole range for
+// kScalar). Processes 8 bytes at a time where possible.
+void XorMaskScalar(char *dst, const char *mask, size_t size) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t d, m;
+    memcpy(&d, dst + i, 8);
+    memcpy(&m, mask + i, 8);
+    d ^= m;
+    memcpy(dst + i, &d, 8);
+  }
+  for (; i < size; ++i)
+    dst[i] ^= mask[i];
+}
+
+#ifdef VIAEVO_XOR_KERNELS_X86
+
+__attribute__((target("sse2"))) void XorMaskSse2(char *dst, const char *mask,
+                                                 size_t size) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+    __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                     _mm_xor_si128(d, m));
+  }
+  XorMaskScalar(dst + i, mask + i, size - i);
+}
+
+__attribute__((target("avx2"))) void XorMaskAvx2(char *dst, const char *mask,
+                                                 size_t size) {
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+    __m256i m =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_xor_si256(d, m));
+  }
+  XorMaskScalar(dst + i, mask + i, size - i);
+}
+
+__attribute__((target("avx512f"))) void
+XorMaskAvx512(char *dst, const char *mask, size_t size) {
+  size_t i = 0;
+  for (; i + 64 <= size; i += 64) {
+    __m512i d = _mm512_loadu_si512(dst + i);
+    __m512i m = _mm512_loadu_si512(mask + i);
+    _mm512_storeu_si512(dst + i, _mm512_xor_si512(d, m));
+  }
+  XorMaskScalar(dst + i, mask + i, size - i);
+}
+
+#endif // VIAEVO_XOR_KERNELS_X86
+
+typedef void (*XorMaskFunction)(char *, const char *, size_t);
+
+XorMaskFunction GetXorMaskFunction(XorKernel kernel) {
+  switch (kernel) {
+#ifdef VIAEVO_XOR_KERNELS_X86
+  case XorKernel::kSse2:
+    return XorMaskSse2;
+  case XorKernel::kAvx2:
+    return XorMaskAvx2;
+  case XorKernel::kAvx512:
+    return XorMaskAvx512;
+#endif
+  default:
+    return XorMaskScalar;
+  }
+}
+
+XorMaskFunction BestXorMaskFunction() {
+  static const XorMaskFunction function = GetXorMaskFunction(BestXorKernel());
+  return function;
+}
+
+} // namespace
+
+bool XorKernelSupported(XorKernel kernel) {
+  switch (kernel) {
+  case XorKernel::kScalar:
+    return true;
+#ifdef VIAEVO_XOR_KERNELS_X86
+  case XorKernel::kSse2:
+    return __builtin_cpu_supports("sse2");
+  case XorKernel::kAvx2:
+    return __builtin_cpu_supports("avx2");
+  case XorKernel::kAvx512:
+    return __builtin_cpu_supports("avx512f");
+#endif
+  default:
+    return false;
+  }
+}
+
+XorKernel BestXorKernel() {
+  static const XorKernel best = [] {
+    for (XorKernel kernel :
+         {XorKernel::kAvx512, XorKernel::kAvx2, XorKernel::kSse2}) {
+      if (XorKernelSupported(kernel))
+        return kernel;
+    }
+    return XorKernel::kScalar;
+  }();
+  return best;
+}
+
+const char *XorKernelName(XorKernel kernel) {
+  switch (kernel) {
+  case XorKernel::kSse2:
+    return "sse2";
+  case XorKernel::kAvx2:
+    return "avx2";
+  case XorKernel::kAvx512:
+    return "avx512";
+  default:
+    return "scalar";
+  }
+}
+
+void XorMask(char *dst, const char *mask, size_t size) {
+  BestXorMaskFunction()(dst, mask, size);
+}
+
+void XorMask(XorKernel kernel, char *dst, const char *mask, size_t size) {
+  assert(XorKernelSupported(kernel) && "kernel not supported by the CPU");
+  GetXorMaskFunction(kernel)(dst, mask, size);
+}
+
+} // namespace viaevo
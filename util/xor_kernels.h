@@ -0,0 +1,36 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_UTIL_XOR_KERNELS_H_
+#define VIAEVO_UTIL_XOR_KERNELS_H_
+
+#include <stddef.h>
+
+namespace viaevo {
+
+// Implementations of XorMask from the narrowest to the widest registers.
+enum class XorKernel {
+  kScalar,
+  kSse2,
+  kAvx2,
+  kAvx512,
+};
+
+// Returns true if the CPU (and the compiler) supports kernel.
+bool XorKernelSupported(XorKernel kernel);
+// Returns the widest kernel supported by the CPU (detected once per process).
+XorKernel BestXorKernel();
+// Returns a short name of kernel (e.g. "avx2").
+const char *XorKernelName(XorKernel kernel);
+
+// Sets dst[i] ^= mask[i] for i in [0, size) using BestXorKernel. dst and mask
+// do not need to be aligned.
+void XorMask(char *dst, const char *mask, size_t size);
+// Same as above using kernel (which should be supported).
+void XorMask(XorKernel kernel, char *dst, const char *mask, size_t size);
+
+} // namespace viaevo
+
+#endif // VIAEVO_UTIL_XOR_KERNELS_H_
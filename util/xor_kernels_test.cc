@@ -0,0 +1,55 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "xor_kernels.h"
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(XorKernelsTest, BestKernelSupported) {
+  EXPECT_TRUE(viaevo::XorKernelSupported(viaevo::XorKernel::kScalar));
+  EXPECT_TRUE(viaevo::XorKernelSupported(viaevo::BestXorKernel()));
+}
+
+TEST(XorKernelsTest, KernelsMatchScalar) {
+  std::mt19937 gen(1);
+  // Sizes around the vector widths and a large buffer; offsets make the
+  // buffers unaligned.
+  for (size_t size : {0, 1, 7, 8, 15, 16, 31, 33, 63, 64, 65, 127, 1000,
+                      100'003}) {
+    for (size_t offset : {0, 1, 3}) {
+      std::vector<char> dst(size + offset), mask(size + offset);
+      for (size_t i = 0; i < dst.size(); ++i) {
+        dst[i] = gen();
+        mask[i] = gen();
+      }
+      std::vector<char> expected = dst;
+      for (size_t i = offset; i < expected.size(); ++i)
+        expected[i] ^= mask[i];
+
+      for (viaevo::XorKernel kernel :
+           {viaevo::XorKernel::kScalar, viaevo::XorKernel::kSse2,
+            viaevo::XorKernel::kAvx2, viaevo::XorKernel::kAvx512}) {
+        if (!viaevo::XorKernelSupported(kernel))
+          continue;
+        std::vector<char> actual = dst;
+        viaevo::XorMask(kernel, actual.data() + offset, mask.data() + offset,
+                        size);
+        EXPECT_EQ(actual, expected)
+            << viaevo::XorKernelName(kernel) << " size " << size;
+      }
+
+      std::vector<char> actual = dst;
+      viaevo::XorMask(actual.data() + offset, mask.data() + offset, size);
+      EXPECT_EQ(actual, expected);
+    }
+  }
+}
+
+} // namespace
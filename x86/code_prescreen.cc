@@ -0,0 +1,320 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "code_prescreen.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+namespace viaevo {
+
+namespace {
+
+constexpr int kRsp = 4;
+
+int ModrmMod(const DecodedInstruction &instruction) {
+  return instruction.modrm >> 6;
+}
+
+// ModRM.reg without and with the REX.R extension.
+int ModrmRegField(const DecodedInstruction &instruction) {
+  return (instruction.modrm >> 3) & 7;
+}
+int ModrmReg(const DecodedInstruction &instruction) {
+  return ModrmRegField(instruction) | ((instruction.rex & 0x04) ? 8 : 0);
+}
+
+// ModRM.rm with the REX.B extension.
+int ModrmRm(const DecodedInstruction &instruction) {
+  return (instruction.modrm & 7) | ((instruction.rex & 0x01) ? 8 : 0);
+}
+
+bool IsPrivileged(const DecodedInstruction &instruction) {
+  uint8_t opcode = instruction.opcode;
+  if (instruction.map == 0) {
+    // hlt, cli, sti, ins, outs, in, out.
+    return opcode == 0xf4 || opcode == 0xfa || opcode == 0xfb ||
+           (opcode >= 0x6c && opcode <= 0x6f) ||
+           (opcode >= 0xe4 && opcode <= 0xe7) ||
+           (opcode >= 0xec && opcode <= 0xef);
+  }
+  if (instruction.map == 1) {
+    switch (opcode) {
+    case 0x06: // clts
+    case 0x07: // sysret
+    case 0x08: // invd
+    case 0x09: // wbinvd
+    case 0x20: // mov from/to control and debug registers
+    case 0x21:
+    case 0x22:
+    case 0x23:
+    case 0x30: // wrmsr
+    case 0x32: // rdmsr
+    case 0x35: // sysexit
+      return true;
+    case 0x00: // lldt, ltr
+      return ModrmRegField(instruction) == 2 || ModrmRegField(instruction) == 3;
+    case 0x01: // lgdt, lidt, lmsw, invlpg, swapgs
+      if (ModrmMod(instruction) == 3)
+        return instruction.modrm == 0xf8;
+      return ModrmRegField(instruction) == 2 ||
+             ModrmRegField(instruction) == 3 ||
+             ModrmRegField(instruction) == 6 || ModrmRegField(instruction) == 7;
+    default:
+      return false;
+    }
+  }
+  return false;
+}
+
+bool IsLockable(const DecodedInstruction &instruction) {
+  uint8_t opcode = instruction.opcode;
+  int reg = ModrmRegField(instruction);
+  if (instruction.map == 0) {
+    if (opcode < 0x38 && (opcode & 7) <= 1)
+      return true; // add, or, adc, sbb, and, sub, xor with a memory destination
+    switch (opcode) {
+    case 0x80:
+    case 0x81:
+    case 0x83:
+      return reg != 7; // not cmp
+    case 0x86:
+    case 0x87:
+      return true; // xchg
+    case 0xf6:
+    case 0xf7:
+      return reg == 2 || reg == 3; // not, neg
+    case 0xfe:
+    case 0xff:
+      return reg == 0 || reg == 1; // inc, dec
+    default:
+      return false;
+    }
+  }
+  if (instruction.map == 1) {
+    switch (opcode) {
+    case 0xab: // bts
+    case 0xb3: // btr
+    case 0xbb: // btc
+    case 0xb0: // cmpxchg
+    case 0xb1:
+    case 0xc0: // xadd
+    case 0xc1:
+      return true;
+    case 0xba:
+      return reg >= 5; // bts, btr, btc with an immediate
+    case 0xc7:
+      return reg == 1; // cmpxchg8b, cmpxchg16b
+    default:
+      return false;
+    }
+  }
+  return false;
+}
+
+// Returns the general purpose register written by common instructions (-1 if
+// not determined).
+int DestinationRegister(const DecodedInstruction &instruction) {
+  uint8_t opcode = instruction.opcode;
+  bool register_rm = instruction.modrm_offset != -1 && ModrmMod(instruction) == 3;
+  int reg = ModrmRegField(instruction);
+  if (instruction.map == 0) {
+    // Arithmetic and logic operations (except for cmp) on 32/64 bit operands.
+    if (opcode < 0x38 && (opcode & 7) == 1)
+      return register_rm ? ModrmRm(instruction) : -1;
+    if (opcode < 0x38 && (opcode & 7) == 3)
+      return ModrmReg(instruction);
+    if (opcode >= 0xb8 && opcode <= 0xbf)
+      return (opcode & 7) | ((instruction.rex & 0x01) ? 8 : 0);
+    switch (opcode) {
+    case 0x63: // movsxd
+    case 0x69: // imul
+    case 0x6b:
+    case 0x8b: // mov
+    case 0x8d: // lea
+      return ModrmReg(instruction);
+    case 0x87: // xchg
+      if (ModrmReg(instruction) == kRsp)
+        return kRsp;
+      return register_rm ? ModrmRm(instruction) : -1;
+    case 0x81:
+    case 0x83:
+      return register_rm && reg != 7 ? ModrmRm(instruction) : -1;
+    case 0x89: // mov
+    case 0xc1: // shifts and rotations
+    case 0xc7: // mov
+    case 0xd1:
+    case 0xd3:
+      return register_rm ? ModrmRm(instruction) : -1;
+    case 0xf7: // not, neg
+      return register_rm && (reg == 2 || reg == 3) ? ModrmRm(instruction) : -1;
+    case 0xff: // inc, dec
+      return register_rm && (reg == 0 || reg == 1) ? ModrmRm(instruction) : -1;
+    default:
+      return -1;
+    }
+  }
+  if (instruction.map == 1) {
+    if ((opcode >= 0x40 && opcode <= 0x4f) || // cmovcc
+        opcode == 0xaf ||                     // imul
+        opcode == 0xb6 || opcode == 0xb7 ||   // movzx
+        opcode == 0xbe || opcode == 0xbf)     // movsx
+      return ModrmReg(instruction);
+  }
+  return -1;
+}
+
+// A 32 bit write to esp clears the upper half of rsp and a 64 bit immediate
+// stack pointer is not a valid stack either.
+bool ClobbersStackPointer(const DecodedInstruction &instruction) {
+  if (instruction.operand_size_override ||
+      DestinationRegister(instruction) != kRsp)
+    return false;
+  if (!(instruction.rex & 0x08))
+    return true;
+  return instruction.map == 0 &&
+         ((instruction.opcode >= 0xb8 && instruction.opcode <= 0xbf) ||
+          instruction.opcode == 0xc7);
+}
+
+// True if the control flow after the instruction is not certain (or leaves
+// main).
+bool EndsPath(const DecodedInstruction &instruction) {
+  uint8_t opcode = instruction.opcode;
+  if (instruction.map == 0) {
+    return (opcode >= 0x70 && opcode <= 0x7f) || // jcc
+           (opcode >= 0xe0 && opcode <= 0xe3) || // loop, jrcxz
+           opcode == 0xe8 ||                     // call
+           opcode == 0xc2 || opcode == 0xc3 ||   // ret
+           opcode == 0xca || opcode == 0xcb || opcode == 0xcf ||
+           opcode == 0xcd || // int 0x80 (system call)
+           (opcode == 0xff && ModrmRegField(instruction) >= 2 &&
+            ModrmRegField(instruction) <= 5); // indirect call, jmp
+  }
+  if (instruction.map == 1) {
+    return (opcode >= 0x80 && opcode <= 0x8f) || // jcc
+           opcode == 0x05 || opcode == 0x34;     // syscall, sysenter
+  }
+  return false;
+}
+
+} // namespace
+
+CodePrescreen::Verdict
+CodePrescreen::CheckInstruction(const DecodedInstruction &instruction,
+                                const char *bytes) {
+  if (!instruction.valid)
+    return kUndecodable;
+  if (instruction.vex)
+    return kAccept;
+  if (IsPrivileged(instruction))
+    return kPrivileged;
+  if (instruction.map == 0) {
+    // int3, int1 and int imm8 (except for int 0x80, a system call).
+    if (instruction.opcode == 0xcc || instruction.opcode == 0xf1 ||
+        (instruction.opcode == 0xcd &&
+         (uint8_t)bytes[instruction.immediate_offset] != 0x80))
+      return kTrap;
+  }
+  if (instruction.map == 1) {
+    // ud2, ud1, ud0, vmread, vmwrite (outside of VMX operation).
+    if (instruction.opcode == 0x0b || instruction.opcode == 0xb9 ||
+        instruction.opcode == 0xff || instruction.opcode == 0x78 ||
+        instruction.opcode == 0x79)
+      return instruction.operand_size_override && instruction.opcode == 0x78
+                 ? kAccept // extrq (SSE4a)
+                 : kUndefined;
+  }
+  if (instruction.lock &&
+      (instruction.modrm_offset == -1 || ModrmMod(instruction) == 3 ||
+       !IsLockable(instruction)))
+    return kUndefined;
+  if (ClobbersStackPointer(instruction))
+    return kStackClobber;
+  return kAccept;
+}
+
+CodePrescreen::Verdict
+CodePrescreen::Check(const std::vector<char> &code,
+                     const std::vector<char> &parent_code) {
+  assert(code.size() == parent_code.size() &&
+         "code and parent_code should have the same size");
+  size_t size = code.size();
+  size_t edit_begin = 0;
+  while (edit_begin < size && code[edit_begin] == parent_code[edit_begin])
+    ++edit_begin;
+  if (edit_begin == size)
+    return kAccept;
+  size_t edit_end = size;
+  while (code[edit_end - 1] == parent_code[edit_end - 1])
+    --edit_end;
+
+  // Instruction boundaries of the parent's code.
+  std::vector<bool> parent_boundaries(size + 1, false);
+  for (auto &instruction : InstructionDecoder::DecodeAll(parent_code))
+    parent_boundaries[instruction.offset] = true;
+  parent_boundaries[size] = true;
+
+  size_t offset = 0;
+  // Unconditional jumps may form loops.
+  for (size_t steps = 0; offset < size && steps <= size; ++steps) {
+    // The remaining instructions are the same as in the parent's code.
+    if (offset >= edit_end && parent_boundaries[offset])
+      return kAccept;
+
+    DecodedInstruction instruction;
+    InstructionDecoder::Decode(code.data() + offset, size - offset,
+                               instruction);
+    size_t end = offset + (instruction.valid ? instruction.length : 1);
+    Verdict verdict = CheckInstruction(instruction, code.data() + offset);
+    if (verdict != kAccept) {
+      // Instructions prior to the mutated bytes fault in the parent's code as
+      // well, i.e. the mutated bytes are not reached.
+      return end > edit_begin ? verdict : kAccept;
+    }
+    if (EndsPath(instruction))
+      return kAccept;
+
+    if (instruction.map == 0 &&
+        (instruction.opcode == 0xeb || instruction.opcode == 0xe9)) {
+      const char *immediate =
+          code.data() + offset + instruction.immediate_offset;
+      int64_t displacement =
+          instruction.opcode == 0xeb
+              ? (int8_t)immediate[0]
+              : (int32_t)((uint8_t)immediate[0] | (uint8_t)immediate[1] << 8 |
+                          (uint8_t)immediate[2] << 16 |
+                          (uint32_t)(uint8_t)immediate[3] << 24);
+      int64_t target = (int64_t)end + displacement;
+      if (target < 0 || target >= (int64_t)size)
+        return kAccept;
+      offset = target;
+    } else {
+      offset = end;
+    }
+  }
+  return kAccept;
+}
+
+const char *CodePrescreen::VerdictName(Verdict verdict) {
+  switch (verdict) {
+  case kAccept:
+    return "accept";
+  case kUndecodable:
+    return "undecodable";
+  case kPrivileged:
+    return "privileged";
+  case kTrap:
+    return "trap";
+  case kUndefined:
+    return "undefined";
+  case kStackClobber:
+    return "stack clobber";
+  default:
+    return "unknown";
+  }
+}
+
+} // namespace viaevo
@@ -0,0 +1,56 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_X86_CODE_PRESCREEN_H_
+#define VIAEVO_X86_CODE_PRESCREEN_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "instruction_decoder.h"
+
+namespace viaevo {
+
+// CodePrescreen statically recognizes mutated code (evolvable code, main) that
+// is certain to fault in the mutated bytes, so the code does not need to be
+// executed. As an execution ends at the first fault with the results written
+// so far, such code behaves like its parent's code cut off at the mutation.
+//
+// Starting at the beginning of main, the instructions are decoded along the
+// straight-line path (following unconditional jumps) through the mutated bytes
+// until the decoding is re-aligned with the parent's instructions. The path
+// ends early (and the code is accepted) at instructions with an uncertain
+// control flow (conditional branches, calls, returns, indirect jumps, system
+// calls). The code is rejected if an instruction overlapping the mutated bytes
+// or following them (before the re-alignment) is undecodable, privileged, a
+// trap, always undefined or clobbers the stack pointer with a 32 bit write.
+class CodePrescreen {
+public:
+  enum Verdict {
+    kAccept = 0,
+    kUndecodable,
+    kPrivileged,
+    kTrap,
+    kUndefined,
+    kStackClobber,
+    kNumVerdicts,
+  };
+
+  // Returns the verdict for code created by mutating parent_code (of the same
+  // size). Identical code is accepted.
+  static Verdict Check(const std::vector<char> &code,
+                       const std::vector<char> &parent_code);
+  // Returns the verdict for the decoded instruction (bytes points to its first
+  // byte). Valid instructions without issues are accepted.
+  static Verdict CheckInstruction(const DecodedInstruction &instruction,
+                                  const char *bytes);
+  // Returns a short name of verdict (e.g. for reports).
+  static const char *VerdictName(Verdict verdict);
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_X86_CODE_PRESCREEN_H_
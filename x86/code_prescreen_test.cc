@@ -0,0 +1,115 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "code_prescreen.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using viaevo::CodePrescreen;
+
+// Returns 16 nops.
+std::vector<char> Nops() { return std::vector<char>(16, (char)0x90); }
+
+// Returns code with bytes written at offset.
+std::vector<char> Write(std::vector<char> code, size_t offset,
+                        const std::vector<unsigned char> &bytes) {
+  for (size_t i = 0; i < bytes.size(); ++i)
+    code[offset + i] = (char)bytes[i];
+  return code;
+}
+
+TEST(CodePrescreenTest, Identical) {
+  EXPECT_EQ(CodePrescreen::Check(Nops(), Nops()), CodePrescreen::kAccept);
+}
+
+TEST(CodePrescreenTest, Rejected) {
+  std::vector<char> parent = Nops();
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0x06}), parent),
+            CodePrescreen::kUndecodable);
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0xf4}), parent),
+            CodePrescreen::kPrivileged); // hlt
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0xe6, 0x80}), parent),
+            CodePrescreen::kPrivileged); // out 0x80, al
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0xcc}), parent),
+            CodePrescreen::kTrap); // int3
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0xcd, 0x03}), parent),
+            CodePrescreen::kTrap); // int 3
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0x0f, 0x0b}), parent),
+            CodePrescreen::kUndefined); // ud2
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0xf0, 0x01, 0xc0}), parent),
+            CodePrescreen::kUndefined); // lock add eax, eax
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0x89, 0xc4}), parent),
+            CodePrescreen::kStackClobber); // mov esp, eax
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0x83, 0xc4, 0x08}), parent),
+            CodePrescreen::kStackClobber); // add esp, 8
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0x48, 0xc7, 0xc4, 0, 0, 0, 0}),
+                                 parent),
+            CodePrescreen::kStackClobber); // mov rsp, 0
+}
+
+TEST(CodePrescreenTest, Accepted) {
+  std::vector<char> parent = Nops();
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0x48, 0x89, 0xc4}), parent),
+            CodePrescreen::kAccept); // mov rsp, rax
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0x41, 0x89, 0xc4}), parent),
+            CodePrescreen::kAccept); // mov r12d, eax
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0x83, 0xfc, 0x08}), parent),
+            CodePrescreen::kAccept); // cmp esp, 8
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0xf0, 0x01, 0x00}), parent),
+            CodePrescreen::kAccept); // lock add [rax], eax
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0xcd, 0x80}), parent),
+            CodePrescreen::kAccept); // int 0x80
+  // mov eax, imm32 re-aligned with the parent's instructions.
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0xb8}), parent),
+            CodePrescreen::kAccept);
+}
+
+TEST(CodePrescreenTest, Misaligned) {
+  std::vector<char> parent = Nops();
+  // mov eax, imm32 truncated at the end of code.
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 14, {0xb8}), parent),
+            CodePrescreen::kUndecodable);
+  // hlt in the immediate of the parent's mov eax, imm32.
+  parent = Write(parent, 4, {0xb8, 0x90, 0x90, 0x90, 0x90});
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 6, {0xf4}), parent),
+            CodePrescreen::kAccept);
+  // The immediate becomes nops.
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 4, {0x90}), parent),
+            CodePrescreen::kAccept);
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 4, {0x90, 0x90, 0xf4}), parent),
+            CodePrescreen::kPrivileged);
+}
+
+TEST(CodePrescreenTest, ControlFlow) {
+  std::vector<char> parent = Write(Nops(), 0, {0x74, 0x02}); // je +2
+  // The path ends at the conditional jump.
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 5, {0xf4}), parent),
+            CodePrescreen::kAccept);
+
+  parent = Write(Nops(), 0, {0xeb, 0x04}); // jmp +4
+  // The mutated bytes are jumped over.
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 3, {0xf4}), parent),
+            CodePrescreen::kAccept);
+  // The jump target is mutated.
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 6, {0xf4}), parent),
+            CodePrescreen::kPrivileged);
+  // The mutated jump leaves the code.
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 1, {0x7f}), parent),
+            CodePrescreen::kAccept);
+  // The mutated jump jumps to itself.
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 1, {0xfe}), parent),
+            CodePrescreen::kAccept);
+
+  // The parent's code faults before the mutated bytes.
+  parent = Write(Nops(), 1, {0x0f, 0x0b}); // ud2
+  EXPECT_EQ(CodePrescreen::Check(Write(parent, 8, {0xf4}), parent),
+            CodePrescreen::kAccept);
+}
+
+} // namespace
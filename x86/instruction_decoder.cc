@@ -0,0 +1,302 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "instruction_decoder.h"
+
+namespace viaevo {
+
+namespace {
+
+// Operand flags of opcodes in the opcode tables.
+enum : uint8_t {
+  kNone = 0,
+  kModrm = 1 << 0,
+  kImm8 = 1 << 1,
+  kImm16 = 1 << 2,
+  // 16 bit immediate with the operand size override, 32 bit otherwise.
+  kImmZ = 1 << 3,
+  // 64 bit immediate with REX.W, kImmZ otherwise (mov r64, imm64).
+  kImmV = 1 << 4,
+  // 32 bit immediate regardless of the operand size (e.g. near branches).
+  kImm32 = 1 << 5,
+  // 64 bit address (32 bit with the address size override).
+  kMoffs = 1 << 6,
+  // Invalid in 64-bit mode.
+  kInvalid = 1 << 7,
+};
+
+constexpr uint8_t M = kModrm, I8 = kImm8, I16 = kImm16, IZ = kImmZ,
+                  IV = kImmV, I32 = kImm32, MO = kMoffs, X = kInvalid,
+                  N = kNone;
+
+// One byte opcodes. Prefixes, REX, 0x0f and the VEX/EVEX prefixes (0xc4, 0xc5,
+// 0x62) are handled prior to the table lookup.
+constexpr uint8_t kOneByteOpcodes[256] = {
+    // 0x00
+    M, M, M, M, I8, IZ, X, X, M, M, M, M, I8, IZ, X, N,
+    // 0x10
+    M, M, M, M, I8, IZ, X, X, M, M, M, M, I8, IZ, X, X,
+    // 0x20
+    M, M, M, M, I8, IZ, N, X, M, M, M, M, I8, IZ, N, X,
+    // 0x30
+    M, M, M, M, I8, IZ, N, X, M, M, M, M, I8, IZ, N, X,
+    // 0x40
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,
+    // 0x50
+    N, N, N, N, N, N, N, N, N, N, N, N, N, N, N, N,
+    // 0x60
+    X, X, N, M, N, N, N, N, IZ, M | IZ, I8, M | I8, N, N, N, N,
+    // 0x70
+    I8, I8, I8, I8, I8, I8, I8, I8, I8, I8, I8, I8, I8, I8, I8, I8,
+    // 0x80
+    M | I8, M | IZ, X, M | I8, M, M, M, M, M, M, M, M, M, M, M, M,
+    // 0x90
+    N, N, N, N, N, N, N, N, N, N, X, N, N, N, N, N,
+    // 0xa0
+    MO, MO, MO, MO, N, N, N, N, I8, IZ, N, N, N, N, N, N,
+    // 0xb0
+    I8, I8, I8, I8, I8, I8, I8, I8, IV, IV, IV, IV, IV, IV, IV, IV,
+    // 0xc0
+    M | I8, M | I8, I16, N, N, N, M | I8, M | IZ, I16 | I8, N, I16, N, N, I8,
+    X, N,
+    // 0xd0
+    M, M, M, M, X, X, X, N, M, M, M, M, M, M, M, M,
+    // 0xe0
+    I8, I8, I8, I8, I8, I8, I8, I8, I32, I32, X, I8, N, N, N, N,
+    // 0xf0 (0xf6 and 0xf7 have an immediate for some ModRM.reg values)
+    N, N, N, N, N, N, M, M, N, N, N, N, N, N, M, M};
+
+// Two byte opcodes (0x0f xx). 0x0f 0x38 and 0x0f 0x3a are handled prior to the
+// table lookup.
+constexpr uint8_t kTwoByteOpcodes[256] = {
+    // 0x00
+    M, M, M, M, X, N, N, N, N, N, X, N, X, M, N, M | I8,
+    // 0x10
+    M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    // 0x20
+    M, M, M, M, X, X, X, X, M, M, M, M, M, M, M, M,
+    // 0x30
+    N, N, N, N, N, N, X, N, N, X, N, X, X, X, X, X,
+    // 0x40
+    M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    // 0x50
+    M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    // 0x60
+    M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    // 0x70
+    M | I8, M | I8, M | I8, M | I8, M, M, M, N, M, M, X, X, M, M, M, M,
+    // 0x80
+    I32, I32, I32, I32, I32, I32, I32, I32, I32, I32, I32, I32, I32, I32, I32,
+    I32,
+    // 0x90
+    M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    // 0xa0
+    N, N, N, M, M | I8, M, X, X, N, N, N, M, M | I8, M, M, M,
+    // 0xb0
+    M, M, M, M, M, M, M, M, M, M, M | I8, M, M, M, M, M,
+    // 0xc0
+    M, M, M | I8, M, M | I8, M | I8, M | I8, M, N, N, N, N, N, N, N, N,
+    // 0xd0
+    M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    // 0xe0
+    M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    // 0xf0
+    M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M};
+
+bool IsLegacyPrefix(uint8_t byte) {
+  switch (byte) {
+  case 0x26:
+  case 0x2e:
+  case 0x36:
+  case 0x3e:
+  case 0x64:
+  case 0x65:
+  case 0x66:
+  case 0x67:
+  case 0xf0:
+  case 0xf2:
+  case 0xf3:
+    return true;
+  default:
+    return false;
+  }
+}
+
+} // namespace
+
+bool InstructionDecoder::Decode(const char *code, size_t size,
+                                DecodedInstruction &instruction) {
+  instruction = DecodedInstruction();
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(code);
+  if (size > kMaxInstructionLength)
+    size = kMaxInstructionLength;
+  size_t pos = 0;
+
+  // Legacy prefixes and REX (a REX followed by a legacy prefix is ignored).
+  while (pos < size) {
+    uint8_t byte = bytes[pos];
+    if (IsLegacyPrefix(byte)) {
+      ++instruction.num_prefixes;
+      instruction.operand_size_override |= (byte == 0x66);
+      instruction.address_size_override |= (byte == 0x67);
+      instruction.lock |= (byte == 0xf0);
+      instruction.rep |= (byte == 0xf2 || byte == 0xf3);
+      instruction.rex = 0;
+    } else if ((byte & 0xf0) == 0x40) {
+      instruction.rex = byte;
+    } else {
+      break;
+    }
+    ++pos;
+  }
+  if (pos >= size)
+    return false;
+
+  // Opcode (with the escape bytes or the VEX/EVEX prefix).
+  uint8_t flags = kNone;
+  uint8_t byte = bytes[pos];
+  if (byte == 0xc4 || byte == 0xc5 || byte == 0x62) {
+    // VEX/EVEX prefixes can not be combined with REX, 0x66, 0xf2, 0xf3 or
+    // lock.
+    if (instruction.rex != 0 || instruction.operand_size_override ||
+        instruction.rep || instruction.lock)
+      return false;
+    int payload_size = (byte == 0xc5 ? 1 : byte == 0xc4 ? 2 : 3);
+    if (pos + payload_size + 1 >= size)
+      return false;
+    instruction.map = (byte == 0xc5 ? 1 : bytes[pos + 1] & 0x1f);
+    if (byte == 0x62)
+      instruction.map = bytes[pos + 1] & 0x07;
+    if (instruction.map < 1 || instruction.map > 3)
+      return false;
+    instruction.vex = true;
+    pos += payload_size + 1;
+    instruction.opcode_offset = pos;
+    instruction.opcode = bytes[pos];
+    ++pos;
+    // All VEX/EVEX instructions have ModRM except for vzeroupper/vzeroall and
+    // the immediates are 8 bit.
+    if (instruction.map == 1) {
+      flags = kTwoByteOpcodes[instruction.opcode] & kImm8;
+      if (!(byte == 0xc5 || byte == 0xc4) || instruction.opcode != 0x77)
+        flags |= kModrm;
+    } else {
+      flags = kModrm | (instruction.map == 3 ? kImm8 : kNone);
+    }
+  } else if (byte == 0x0f) {
+    if (pos + 1 >= size)
+      return false;
+    uint8_t second = bytes[pos + 1];
+    if (second == 0x38 || second == 0x3a) {
+      if (pos + 2 >= size)
+        return false;
+      instruction.map = (second == 0x38 ? 2 : 3);
+      pos += 2;
+      flags = kModrm | (second == 0x3a ? kImm8 : kNone);
+    } else {
+      instruction.map = 1;
+      pos += 1;
+      flags = kTwoByteOpcodes[second];
+    }
+    instruction.opcode_offset = pos;
+    instruction.opcode = bytes[pos];
+    ++pos;
+  } else {
+    instruction.opcode_offset = pos;
+    instruction.opcode = byte;
+    ++pos;
+    flags = kOneByteOpcodes[byte];
+  }
+  if (flags & kInvalid)
+    return false;
+
+  // ModRM, SIB and displacement.
+  if (flags & kModrm) {
+    if (pos >= size)
+      return false;
+    instruction.modrm_offset = pos;
+    instruction.modrm = bytes[pos];
+    ++pos;
+    int mod = instruction.modrm >> 6;
+    int rm = instruction.modrm & 7;
+    if (mod != 3) {
+      if (rm == 4) {
+        if (pos >= size)
+          return false;
+        instruction.sib_offset = pos;
+        // SIB base 5 without displacement means disp32 without a base.
+        if (mod == 0 && (bytes[pos] & 7) == 5)
+          instruction.displacement_size = 4;
+        ++pos;
+      }
+      if (mod == 0 && rm == 5)
+        instruction.displacement_size = 4; // rip relative
+      else if (mod == 1)
+        instruction.displacement_size = 1;
+      else if (mod == 2)
+        instruction.displacement_size = 4;
+      if (instruction.displacement_size > 0) {
+        instruction.displacement_offset = pos;
+        pos += instruction.displacement_size;
+      }
+    }
+  }
+
+  // Immediate.
+  int operand_size = instruction.operand_size_override ? 2 : 4;
+  int immediate_size = 0;
+  if (flags & kImm16)
+    immediate_size += 2;
+  if (flags & kImm8)
+    immediate_size += 1;
+  if (flags & kImmZ)
+    immediate_size += operand_size;
+  if (flags & kImmV)
+    immediate_size += (instruction.rex & 0x08) ? 8 : operand_size;
+  if (flags & kImm32)
+    immediate_size += 4;
+  if (flags & kMoffs)
+    immediate_size += instruction.address_size_override ? 4 : 8;
+  // test r/m, imm (ModRM.reg 0 and 1) in group 3.
+  if (instruction.map == 0 && !instruction.vex &&
+      (instruction.opcode == 0xf6 || instruction.opcode == 0xf7) &&
+      ((instruction.modrm >> 3) & 7) < 2)
+    immediate_size += (instruction.opcode == 0xf6 ? 1 : operand_size);
+  if (immediate_size > 0) {
+    instruction.immediate_offset = pos;
+    instruction.immediate_size = immediate_size;
+    pos += immediate_size;
+  }
+
+  if (pos > size)
+    return false;
+  instruction.length = pos;
+  instruction.valid = true;
+  return true;
+}
+
+std::vector<DecodedInstruction>
+InstructionDecoder::DecodeAll(const std::vector<char> &code) {
+  return DecodeAll(code.data(), code.size());
+}
+
+std::vector<DecodedInstruction>
+InstructionDecoder::DecodeAll(const char *code, size_t size) {
+  std::vector<DecodedInstruction> instructions;
+  size_t offset = 0;
+  while (offset < size) {
+    DecodedInstruction instruction;
+    if (!Decode(code + offset, size - offset, instruction)) {
+      instruction = DecodedInstruction();
+      instruction.length = 1;
+    }
+    instruction.offset = offset;
+    offset += instruction.length;
+    instructions.push_back(instruction);
+  }
+  return instructions;
+}
+
+} // namespace viaevo
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#ifndef VIAEVO_X86_INSTRUCTION_DECODER_H_
+#define VIAEVO_X86_INSTRUCTION_DECODER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace viaevo {
+
+// DecodedInstruction describes the layout of a single x86-64 instruction.
+// Offsets of the fields are relative to the first byte of the instruction and
+// are -1 for fields the instruction does not have.
+struct DecodedInstruction {
+  // Offset of the instruction in the decoded code (see DecodeAll).
+  size_t offset = 0;
+  // Length of the instruction in bytes (1 for undecodable bytes in DecodeAll).
+  int length = 0;
+  // False if the bytes do not form a valid instruction in 64-bit mode.
+  bool valid = false;
+
+  // Number of legacy prefixes (e.g. 0x66, 0xf3, segment overrides).
+  int num_prefixes = 0;
+  bool operand_size_override = false; // 0x66
+  bool address_size_override = false; // 0x67
+  bool lock = false;                  // 0xf0
+  bool rep = false;                   // 0xf2 or 0xf3
+  // The REX prefix (0 if absent).
+  uint8_t rex = 0;
+  // The instruction is VEX or EVEX encoded.
+  bool vex = false;
+
+  // Opcode map: 0 (one byte opcodes), 1 (0x0f), 2 (0x0f 0x38), 3 (0x0f 0x3a).
+  int map = 0;
+  // The opcode byte (after the escape bytes or the VEX/EVEX prefix).
+  uint8_t opcode = 0;
+  int opcode_offset = -1;
+  int modrm_offset = -1;
+  uint8_t modrm = 0;
+  int sib_offset = -1;
+  int displacement_offset = -1;
+  int displacement_size = 0;
+  int immediate_offset = -1;
+  int immediate_size = 0;
+};
+
+// InstructionDecoder determines the lengths and the layout of x86-64
+// instructions (64-bit mode) via opcode tables. It does not determine the
+// operation of the instructions (i.e. it is not a disassembler).
+class InstructionDecoder {
+public:
+  // Maximum length of an x86-64 instruction.
+  static constexpr int kMaxInstructionLength = 15;
+
+  // Decodes the instruction at the beginning of code (at most size bytes).
+  // Returns false (and sets instruction.valid to false) if the bytes do not
+  // form a valid instruction, e.g. opcodes invalid in 64-bit mode, truncated
+  // instructions or instructions longer than kMaxInstructionLength (the other
+  // fields of instruction are unspecified in that case).
+  static bool Decode(const char *code, size_t size,
+                     DecodedInstruction &instruction);
+
+  // Decodes code from the beginning (linear sweep). Undecodable bytes are
+  // returned as invalid instructions of length 1 and the decoding resumes at
+  // the next byte. The lengths of the returned instructions add up to the
+  // size of code.
+  static std::vector<DecodedInstruction>
+  DecodeAll(const std::vector<char> &code);
+  static std::vector<DecodedInstruction> DecodeAll(const char *code,
+                                                   size_t size);
+};
+
+} // namespace viaevo
+
+#endif // VIAEVO_X86_INSTRUCTION_DECODER_H_
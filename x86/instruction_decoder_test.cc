@@ -0,0 +1,140 @@
+// Copyright (c) 2023 Richard Baran
+//
+// All components of viaevo are licensed under the MIT License.
+// See LICENSE.txt in the root of the repository.
+
+#include "instruction_decoder.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Returns the length of the instruction in bytes (0 if invalid).
+int Length(const std::vector<unsigned char> &bytes) {
+  viaevo::DecodedInstruction instruction;
+  if (!viaevo::InstructionDecoder::Decode(
+          reinterpret_cast<const char *>(bytes.data()), bytes.size(),
+          instruction))
+    return 0;
+  return instruction.length;
+}
+
+TEST(InstructionDecoderTest, Lengths) {
+  EXPECT_EQ(Length({0x90}), 1);                       // nop
+  EXPECT_EQ(Length({0x55}), 1);                       // push rbp
+  EXPECT_EQ(Length({0x48, 0x89, 0xe5}), 3);           // mov rbp, rsp
+  EXPECT_EQ(Length({0x8b, 0x44, 0x24, 0x08}), 4);     // mov eax, [rsp+8]
+  EXPECT_EQ(Length({0x8b, 0x04, 0x25, 0, 0, 0, 0}), 7); // mov eax, [disp32]
+  EXPECT_EQ(Length({0x48, 0xb8, 1, 2, 3, 4, 5, 6, 7, 8}), 10); // mov rax, imm64
+  EXPECT_EQ(Length({0xb8, 1, 2, 3, 4}), 5);           // mov eax, imm32
+  EXPECT_EQ(Length({0x66, 0xb8, 1, 2}), 4);           // mov ax, imm16
+  EXPECT_EQ(Length({0xe8, 0, 0, 0, 0}), 5);           // call rel32
+  EXPECT_EQ(Length({0x66, 0x0f, 0x1f, 0x44, 0, 0}), 6); // nopw
+  EXPECT_EQ(Length({0x0f, 0x1f, 0x84, 0, 0, 0, 0, 0}), 8); // nopl
+  EXPECT_EQ(Length({0x0f, 0x84, 0, 0, 0, 0}), 6);     // je rel32
+  EXPECT_EQ(Length({0xf3, 0x0f, 0xb8, 0xc1}), 4);     // popcnt eax, ecx
+  EXPECT_EQ(Length({0x66, 0x0f, 0x3a, 0x0f, 0xc1, 8}), 6); // palignr
+  EXPECT_EQ(Length({0xf6, 0xc0, 0x01}), 3);           // test al, 1
+  EXPECT_EQ(Length({0xf6, 0xd0}), 2);                 // not al
+  EXPECT_EQ(Length({0xf7, 0xc0, 1, 0, 0, 0}), 6);     // test eax, 1
+  EXPECT_EQ(Length({0xc8, 0x10, 0x00, 0x01}), 4);     // enter 16, 1
+  EXPECT_EQ(Length({0xa1, 1, 2, 3, 4, 5, 6, 7, 8}), 9); // mov eax, moffs64
+  EXPECT_EQ(Length({0x67, 0xa1, 1, 2, 3, 4}), 6);     // mov eax, moffs32
+  EXPECT_EQ(Length({0xc5, 0xf8, 0x77}), 3);           // vzeroupper
+  EXPECT_EQ(Length({0xc5, 0xf0, 0x58, 0xc2}), 4);     // vaddps
+  EXPECT_EQ(Length({0xc4, 0xe3, 0x79, 0x0f, 0xc1, 0x08}), 6); // vpalignr
+  EXPECT_EQ(Length({0x62, 0xf1, 0x7c, 0x48, 0x58, 0xc1}), 6); // vaddps zmm
+  EXPECT_EQ(Length({0x0f, 0x0b}), 2);                 // ud2
+}
+
+TEST(InstructionDecoderTest, Invalid) {
+  EXPECT_EQ(Length({}), 0);
+  EXPECT_EQ(Length({0x06}), 0);             // push es (invalid in 64-bit mode)
+  EXPECT_EQ(Length({0xce}), 0);             // into (invalid in 64-bit mode)
+  EXPECT_EQ(Length({0x48}), 0);             // REX only
+  EXPECT_EQ(Length({0x8b, 0x44, 0x24}), 0); // truncated
+  EXPECT_EQ(Length({0x0f, 0x04}), 0);
+  EXPECT_EQ(Length({0x48, 0xc5, 0xf8, 0x77}), 0); // REX before VEX
+
+  // 14 prefixes are fine, 15 prefixes exceed the maximum length.
+  std::vector<unsigned char> bytes(14, 0x66);
+  bytes.push_back(0x90);
+  EXPECT_EQ(Length(bytes), 15);
+  bytes.insert(bytes.begin(), 0x66);
+  EXPECT_EQ(Length(bytes), 0);
+}
+
+TEST(InstructionDecoderTest, Fields) {
+  // movl $0x14, 0x2f29(%rip)
+  std::vector<unsigned char> bytes = {0xc7, 0x05, 0x29, 0x2f, 0x00,
+                                      0x00, 0x14, 0x00, 0x00, 0x00};
+  viaevo::DecodedInstruction instruction;
+  ASSERT_TRUE(viaevo::InstructionDecoder::Decode(
+      reinterpret_cast<const char *>(bytes.data()), bytes.size(),
+      instruction));
+  EXPECT_TRUE(instruction.valid);
+  EXPECT_EQ(instruction.length, 10);
+  EXPECT_EQ(instruction.map, 0);
+  EXPECT_EQ(instruction.opcode, 0xc7);
+  EXPECT_EQ(instruction.opcode_offset, 0);
+  EXPECT_EQ(instruction.modrm_offset, 1);
+  EXPECT_EQ(instruction.sib_offset, -1);
+  EXPECT_EQ(instruction.displacement_offset, 2);
+  EXPECT_EQ(instruction.displacement_size, 4);
+  EXPECT_EQ(instruction.immediate_offset, 6);
+  EXPECT_EQ(instruction.immediate_size, 4);
+
+  // lock add qword ptr [rax + rcx*4 + 8], 1
+  bytes = {0xf0, 0x48, 0x83, 0x44, 0x88, 0x08, 0x01};
+  ASSERT_TRUE(viaevo::InstructionDecoder::Decode(
+      reinterpret_cast<const char *>(bytes.data()), bytes.size(),
+      instruction));
+  EXPECT_EQ(instruction.length, 7);
+  EXPECT_EQ(instruction.num_prefixes, 1);
+  EXPECT_TRUE(instruction.lock);
+  EXPECT_EQ(instruction.rex, 0x48);
+  EXPECT_EQ(instruction.opcode_offset, 2);
+  EXPECT_EQ(instruction.modrm_offset, 3);
+  EXPECT_EQ(instruction.sib_offset, 4);
+  EXPECT_EQ(instruction.displacement_offset, 5);
+  EXPECT_EQ(instruction.displacement_size, 1);
+  EXPECT_EQ(instruction.immediate_offset, 6);
+  EXPECT_EQ(instruction.immediate_size, 1);
+
+  // imul eax, [rip + 0] (two byte opcode)
+  bytes = {0x0f, 0xaf, 0x05, 0, 0, 0, 0};
+  ASSERT_TRUE(viaevo::InstructionDecoder::Decode(
+      reinterpret_cast<const char *>(bytes.data()), bytes.size(),
+      instruction));
+  EXPECT_EQ(instruction.map, 1);
+  EXPECT_EQ(instruction.opcode, 0xaf);
+  EXPECT_EQ(instruction.opcode_offset, 1);
+  EXPECT_EQ(instruction.immediate_offset, -1);
+}
+
+TEST(InstructionDecoderTest, DecodeAll) {
+  // push rbp; (invalid byte); mov rbp, rsp; truncated mov eax, [rsp+8]
+  std::vector<char> code = {'\x55', '\x06', '\x48', '\x89', '\xe5',
+                            '\x8b', '\x44', '\x24'};
+  std::vector<viaevo::DecodedInstruction> instructions =
+      viaevo::InstructionDecoder::DecodeAll(code);
+  ASSERT_EQ(instructions.size(), 6);
+  EXPECT_TRUE(instructions[0].valid);
+  EXPECT_EQ(instructions[0].length, 1);
+  EXPECT_FALSE(instructions[1].valid);
+  EXPECT_EQ(instructions[1].offset, 1);
+  EXPECT_EQ(instructions[1].length, 1);
+  EXPECT_TRUE(instructions[2].valid);
+  EXPECT_EQ(instructions[2].offset, 2);
+  EXPECT_EQ(instructions[2].length, 3);
+  // The truncated instruction decodes as three invalid bytes (0x44 is a REX
+  // prefix and 0x24 is and al, imm8 without the immediate).
+  EXPECT_FALSE(instructions[3].valid);
+  EXPECT_FALSE(instructions[4].valid);
+  EXPECT_FALSE(instructions[5].valid);
+  EXPECT_EQ(instructions[5].offset, 7);
+}
+
+} // namespace